@@ -0,0 +1,194 @@
+package service
+
+import (
+	"bytes"
+	"compress/gzip"
+	"context"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"io"
+	"strings"
+	"sync"
+
+	"github.com/aws/aws-sdk-go-v2/aws"
+	"github.com/aws/aws-sdk-go-v2/config"
+	"github.com/aws/aws-sdk-go-v2/service/s3"
+	"github.com/aws/aws-sdk-go-v2/service/s3/types"
+)
+
+const (
+	resultArtifactPrefix = "cads-results/"
+	// resultChunkSize and resultFetchParallelism shape the ranged reads of a
+	// result artifact.
+	resultChunkSize        = 8 << 20
+	resultFetchParallelism = 4
+)
+
+// errResultArtifactMissing reports that a run has no result artifact, as
+// opposed to one that could not be read.
+var errResultArtifactMissing = errors.New("result artifact not found")
+
+// resultArtifactKey is the object key the remote runner writes a run's
+// results to.
+func resultArtifactKey(runName string) string {
+	return resultArtifactPrefix + runName + ".json.gz"
+}
+
+// resultStore is the object storage holding result artifacts.
+type resultStore interface {
+	Put(ctx context.Context, key string, body []byte) error
+	Size(ctx context.Context, key string) (int64, error)
+	ReadRange(ctx context.Context, key string, offset, length int64) ([]byte, error)
+	Location(key string) string
+}
+
+// UploadRunResults writes results as a gzip-compressed JSON artifact to the
+// bucket configured by S3_BUCKET (and S3_ENDPOINT, AWS_REGION) and returns
+// its location.
+func UploadRunResults(ctx context.Context, key string, results any, lookup EnvLookup) (string, error) {
+	store, err := newS3ResultStore(ctx, lookup)
+	if err != nil {
+		return "", err
+	}
+	if err := putResultArtifact(ctx, store, key, results); err != nil {
+		return "", err
+	}
+	return store.Location(key), nil
+}
+
+func putResultArtifact(ctx context.Context, store resultStore, key string, results any) error {
+	var buffer bytes.Buffer
+	zw := gzip.NewWriter(&buffer)
+	if err := json.NewEncoder(zw).Encode(results); err != nil {
+		return fmt.Errorf("encode result artifact: %w", err)
+	}
+	if err := zw.Close(); err != nil {
+		return fmt.Errorf("compress result artifact: %w", err)
+	}
+	if err := store.Put(ctx, key, buffer.Bytes()); err != nil {
+		return fmt.Errorf("upload %s: %w", store.Location(key), err)
+	}
+	return nil
+}
+
+// fetchResultArtifact reads the artifact at key in resultChunkSize ranges, up
+// to resultFetchParallelism at a time, so large results download at the
+// store's bandwidth rather than one request's.
+func fetchResultArtifact(ctx context.Context, store resultStore, key string, chunkSize int64) (map[string]map[string]any, error) {
+	size, err := store.Size(ctx, key)
+	if err != nil {
+		return nil, err
+	}
+	data := make([]byte, size)
+	chunks := int((size + chunkSize - 1) / chunkSize)
+	errs := make([]error, chunks)
+	slots := make(chan struct{}, resultFetchParallelism)
+	var wg sync.WaitGroup
+	for chunk := 0; chunk < chunks; chunk++ {
+		wg.Add(1)
+		slots <- struct{}{}
+		go func(chunk int) {
+			defer wg.Done()
+			defer func() { <-slots }()
+			offset := int64(chunk) * chunkSize
+			length := min(chunkSize, size-offset)
+			part, err := store.ReadRange(ctx, key, offset, length)
+			if err == nil && int64(len(part)) != length {
+				err = fmt.Errorf("read %d bytes at %d, want %d", len(part), offset, length)
+			}
+			if err != nil {
+				errs[chunk] = err
+				return
+			}
+			copy(data[offset:], part)
+		}(chunk)
+	}
+	wg.Wait()
+	if err := errors.Join(errs...); err != nil {
+		return nil, fmt.Errorf("read %s: %w", store.Location(key), err)
+	}
+
+	zr, err := gzip.NewReader(bytes.NewReader(data))
+	if err != nil {
+		return nil, fmt.Errorf("decompress %s: %w", store.Location(key), err)
+	}
+	var results map[string]map[string]any
+	if err := json.NewDecoder(zr).Decode(&results); err != nil {
+		return nil, fmt.Errorf("decode %s: %w", store.Location(key), err)
+	}
+	return results, nil
+}
+
+type s3ResultStore struct {
+	client *s3.Client
+	bucket string
+}
+
+// newS3ResultStore connects to the bucket named by S3_BUCKET. S3_ENDPOINT
+// selects an S3-compatible service such as MinIO, addressed path-style.
+func newS3ResultStore(ctx context.Context, lookup EnvLookup) (*s3ResultStore, error) {
+	bucket := strings.TrimSpace(lookup("S3_BUCKET"))
+	if bucket == "" {
+		return nil, errors.New("S3_BUCKET is not set")
+	}
+	endpoint := strings.TrimSpace(pickString(lookup("S3_ENDPOINT"), lookup("AWS_ENDPOINT_URL_S3"), lookup("AWS_ENDPOINT_URL")))
+	region := pickString(lookup("AWS_REGION"), lookup("AWS_DEFAULT_REGION"), lookup("S3_REGION"), "us-east-1")
+	cfg, err := config.LoadDefaultConfig(ctx, config.WithRegion(region))
+	if err != nil {
+		return nil, fmt.Errorf("load S3 config: %w", err)
+	}
+	client := s3.NewFromConfig(cfg, func(options *s3.Options) {
+		if endpoint != "" {
+			options.UsePathStyle = true
+			options.BaseEndpoint = aws.String(endpoint)
+		}
+	})
+	return &s3ResultStore{client: client, bucket: bucket}, nil
+}
+
+func (s *s3ResultStore) Location(key string) string {
+	return "s3://" + s.bucket + "/" + key
+}
+
+func (s *s3ResultStore) Put(ctx context.Context, key string, body []byte) error {
+	_, err := s.client.PutObject(ctx, &s3.PutObjectInput{
+		Bucket:      aws.String(s.bucket),
+		Key:         aws.String(key),
+		Body:        bytes.NewReader(body),
+		ContentType: aws.String("application/gzip"),
+	})
+	return err
+}
+
+func (s *s3ResultStore) Size(ctx context.Context, key string) (int64, error) {
+	output, err := s.client.HeadObject(ctx, &s3.HeadObjectInput{
+		Bucket: aws.String(s.bucket),
+		Key:    aws.String(key),
+	})
+	if err != nil {
+		var notFound *types.NotFound
+		var noSuchKey *types.NoSuchKey
+		if errors.As(err, &notFound) || errors.As(err, &noSuchKey) {
+			return 0, fmt.Errorf("stat %s: %w", s.Location(key), errResultArtifactMissing)
+		}
+		return 0, fmt.Errorf("stat %s: %w", s.Location(key), err)
+	}
+	if output.ContentLength == nil {
+		return 0, fmt.Errorf("stat %s: size unknown", s.Location(key))
+	}
+	return *output.ContentLength, nil
+}
+
+func (s *s3ResultStore) ReadRange(ctx context.Context, key string, offset, length int64) ([]byte, error) {
+	output, err := s.client.GetObject(ctx, &s3.GetObjectInput{
+		Bucket: aws.String(s.bucket),
+		Key:    aws.String(key),
+		Range:  aws.String(fmt.Sprintf("bytes=%d-%d", offset, offset+length-1)),
+	})
+	if err != nil {
+		return nil, err
+	}
+	defer output.Body.Close()
+	return io.ReadAll(output.Body)
+}
@@ -0,0 +1,147 @@
+package service
+
+import (
+	"context"
+	"errors"
+	"fmt"
+	"reflect"
+	"sync"
+	"testing"
+	"time"
+)
+
+// memoryResultStore stands in for a MinIO bucket.
+type memoryResultStore struct {
+	mu      sync.Mutex
+	objects map[string][]byte
+	ranges  int
+	// statErr, when set, fails every Size call as an unreachable store would.
+	statErr error
+}
+
+func (s *memoryResultStore) Location(key string) string { return "s3://test/" + key }
+
+func (s *memoryResultStore) Put(_ context.Context, key string, body []byte) error {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	s.objects[key] = append([]byte(nil), body...)
+	return nil
+}
+
+func (s *memoryResultStore) Size(_ context.Context, key string) (int64, error) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if s.statErr != nil {
+		return 0, s.statErr
+	}
+	body, ok := s.objects[key]
+	if !ok {
+		return 0, fmt.Errorf("stat %s: %w", s.Location(key), errResultArtifactMissing)
+	}
+	return int64(len(body)), nil
+}
+
+func (s *memoryResultStore) ReadRange(_ context.Context, key string, offset, length int64) ([]byte, error) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	s.ranges++
+	return append([]byte(nil), s.objects[key][offset:offset+length]...), nil
+}
+
+func TestResultArtifactRoundTripsThroughRangedReads(t *testing.T) {
+	store := &memoryResultStore{objects: make(map[string][]byte)}
+	signal := make([]any, 5000)
+	for i := range signal {
+		signal[i] = float64(i) * 0.25
+	}
+	results := map[string]map[string]any{
+		"kpi": {"score": 0.5, "trace": map[string]any{"time": signal}},
+	}
+	if err := putResultArtifact(context.Background(), store, "cads-results/run.json.gz", results); err != nil {
+		t.Fatalf("putResultArtifact() error = %v", err)
+	}
+
+	got, err := fetchResultArtifact(context.Background(), store, "cads-results/run.json.gz", 256)
+	if err != nil {
+		t.Fatalf("fetchResultArtifact() error = %v", err)
+	}
+	if !reflect.DeepEqual(got, results) {
+		t.Fatalf("fetchResultArtifact() = %v, want the uploaded results", got)
+	}
+	if want := (len(store.objects["cads-results/run.json.gz"]) + 255) / 256; store.ranges != want || want < 2 {
+		t.Fatalf("ranged reads = %d, want %d", store.ranges, want)
+	}
+}
+
+func TestGetRunResultsPrefersArtifactOverLogs(t *testing.T) {
+	store := &memoryResultStore{objects: make(map[string][]byte)}
+	name := "cads-python-chain-20260416170000"
+	results := map[string]map[string]any{"producer": {"value": 2.0}}
+	if err := putResultArtifact(context.Background(), store, resultArtifactKey(name), results); err != nil {
+		t.Fatalf("putResultArtifact() error = %v", err)
+	}
+
+	client := &ArgoRemoteClient{
+		argoCmd: "argo",
+		results: store,
+		now:     func() time.Time { return time.Date(2026, 4, 16, 17, 1, 0, 0, time.UTC) },
+		exec: func(_ context.Context, _ string, args ...string) ([]byte, error) {
+			if args[0] != "get" {
+				t.Fatalf("args = %v, want only the workflow lookup", args)
+			}
+			return []byte(`{
+			  "metadata": {"name": "` + name + `"},
+			  "spec": {"templates": [{"name": "run-workflow", "container": {
+			    "args": ["--workflow", "workflows/tests/python_chain.yaml"]}}]},
+			  "status": {"phase": "Succeeded"}
+			}`), nil
+		},
+	}
+
+	got, err := client.GetRunResults(context.Background(), name)
+	if err != nil {
+		t.Fatalf("GetRunResults() error = %v", err)
+	}
+	if got.CollectedFrom != "s3://test/"+resultArtifactKey(name) || !reflect.DeepEqual(got.StepResults, results) {
+		t.Fatalf("GetRunResults() = %+v, want the artifact results", got)
+	}
+}
+
+func TestGetRunResultsFallsBackToLogsOnlyWithoutArtifact(t *testing.T) {
+	name := "cads-python-chain-20260416170000"
+	var logReads int
+	client := &ArgoRemoteClient{
+		argoCmd: "argo",
+		now:     func() time.Time { return time.Date(2026, 4, 16, 17, 1, 0, 0, time.UTC) },
+		exec: func(_ context.Context, _ string, args ...string) ([]byte, error) {
+			if args[0] == "logs" {
+				logReads++
+				return []byte(`{"producer": {"value": 2.0}}`), nil
+			}
+			return []byte(`{
+			  "metadata": {"name": "` + name + `"},
+			  "spec": {"templates": [{"name": "run-workflow", "container": {
+			    "args": ["--workflow", "workflows/tests/python_chain.yaml"]}}]},
+			  "status": {"phase": "Succeeded"}
+			}`), nil
+		},
+	}
+
+	client.results = &memoryResultStore{objects: make(map[string][]byte)}
+	got, err := client.GetRunResults(context.Background(), name)
+	if err != nil {
+		t.Fatalf("GetRunResults() error = %v", err)
+	}
+	if got.CollectedFrom != "argo logs" || logReads != 1 {
+		t.Fatalf("GetRunResults() = %+v after %d log reads, want the logs of a run without an artifact", got, logReads)
+	}
+
+	unreachable := errors.New("connection refused")
+	client.results = &memoryResultStore{objects: make(map[string][]byte), statErr: unreachable}
+	if _, err := client.GetRunResults(context.Background(), name); !errors.Is(err, unreachable) {
+		t.Fatalf("GetRunResults() error = %v, want the store failure", err)
+	}
+	if logReads != 1 {
+		t.Fatalf("log reads = %d, want no fallback when the store fails", logReads)
+	}
+}
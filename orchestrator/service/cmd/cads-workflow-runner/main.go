@@ -1,64 +1,136 @@
 package main
 
 import (
+	"context"
 	"encoding/json"
 	"flag"
 	"fmt"
 	"log"
 	"os"
+	"strings"
 
 	svc "github.com/norceresearch/cads-fmi-demo/orchestrator/service"
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
 	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/workflow"
 )
 
 func main() {
+	fmi.ServeIsolatedWorker()
+
 	var workflowPath string
 	var jsonOutput bool
 	var workdir string
+	var priorityName string
+	var wallBudget float64
+	var portfolio string
+	var resultKey string
+	var maxSweepMembers int
 
 	flag.StringVar(&workflowPath, "workflow", "workflows/tests/python_chain.yaml", "Workflow YAML to execute")
 	flag.BoolVar(&jsonOutput, "json-output", false, "Only emit the final JSON result")
 	flag.StringVar(&workdir, "workdir", "", "Explicit repository root (optional)")
+	flag.StringVar(&priorityName, "priority", "interactive", "Scheduling class: interactive or batch")
+	flag.Float64Var(&wallBudget, "wall-budget", 0, "Default wall-clock budget per step in seconds (0 disables)")
+	flag.StringVar(&portfolio, "portfolio", "", "Comma-separated workflow globs to run together as batch work, e.g. workflows/demonstrators/**/*.yaml")
+	flag.StringVar(&resultKey, "result-key", "", "Also upload the results as gzip-compressed JSON to this key of S3_BUCKET")
+	flag.IntVar(&maxSweepMembers, "max-sweep-members", workflow.DefaultMaxSweepMembers, "Reject swept steps with more members than this")
 	flag.Parse()
 
 	if workflowPath == "" {
 		log.Fatal("workflow path is required")
 	}
+	priority, err := fmi.ParsePriority(priorityName)
+	if err != nil {
+		log.Fatal(err)
+	}
+
+	runOpts := workflow.RunOptions{Priority: priority}
+	if wallBudget < 0 {
+		log.Fatal("wall budget must not be negative")
+	}
+	if wallBudget > 0 {
+		runOpts.WallBudget = &wallBudget
+	}
 
-	var opts []workflow.Option
+	opts := []workflow.Option{workflow.WithMaxSweepMembers(maxSweepMembers)}
 	if !jsonOutput {
 		opts = append(opts, workflow.WithLogger(func(format string, args ...any) {
 			fmt.Printf(format+"\n", args...)
 		}))
 	}
 
+	if portfolio != "" {
+		opts = append(opts, workflow.WithStepCache())
+	}
+
 	runner, err := svc.NewRunner(workdir, opts...)
 	if err != nil {
 		log.Fatal(err)
 	}
 
-	if !jsonOutput {
-		fmt.Printf("[workflow] Running %s\n", workflowPath)
+	var results any
+	if portfolio != "" {
+		if !jsonOutput {
+			fmt.Printf("[workflow] Running portfolio %s\n", portfolio)
+		}
+		consolidated, err := runner.RunPortfolio(context.Background(), strings.Split(portfolio, ","), runOpts)
+		if err != nil {
+			log.Fatal(err)
+		}
+		if !jsonOutput {
+			fmt.Printf("[workflow] Completed %d workflows, %d failed, %d steps reused.\n",
+				len(consolidated.Workflows), consolidated.Failed, consolidated.StepCacheHits)
+		}
+		results = consolidated
+	} else {
+		if !jsonOutput {
+			fmt.Printf("[workflow] Running %s\n", workflowPath)
+		}
+		results, err = runner.RunWithOptions(context.Background(), workflowPath, runOpts)
+		if err != nil {
+			log.Fatal(err)
+		}
+		if !jsonOutput {
+			fmt.Println("[workflow] Completed all steps.")
+		}
 	}
 
-	results, err := runner.Run(workflowPath)
-	if err != nil {
-		log.Fatal(err)
+	uploaded := false
+	if resultKey != "" {
+		// An uploaded artifact replaces the results in the output, so large
+		// runs do not flood the pod logs. A failed upload prints them instead,
+		// which leaves them retrievable from the logs.
+		location, err := svc.UploadRunResults(context.Background(), resultKey, results, os.Getenv)
+		if err != nil {
+			log.Printf("result artifact not written: %v", err)
+		} else {
+			fmt.Printf("[workflow] %s; results written to %s\n", summarizeResults(results), location)
+			uploaded = true
+		}
 	}
-
-	if jsonOutput {
+	if !uploaded {
 		enc := json.NewEncoder(os.Stdout)
+		if !jsonOutput {
+			enc.SetIndent("", "  ")
+		}
 		if err := enc.Encode(results); err != nil {
 			log.Fatal(err)
 		}
-		return
 	}
+	if consolidated, ok := results.(*svc.PortfolioResult); ok && consolidated.Failed > 0 {
+		os.Exit(1)
+	}
+}
 
-	fmt.Println("[workflow] Completed all steps.")
-
-	enc := json.NewEncoder(os.Stdout)
-	enc.SetIndent("", "  ")
-	if err := enc.Encode(results); err != nil {
-		log.Fatal(err)
+// summarizeResults describes results in one line for runs whose results go to
+// an artifact.
+func summarizeResults(results any) string {
+	switch typed := results.(type) {
+	case *svc.PortfolioResult:
+		return fmt.Sprintf("%d workflows, %d failed", len(typed.Workflows), typed.Failed)
+	case map[string]map[string]any:
+		return fmt.Sprintf("%d steps", len(typed))
+	default:
+		return "run complete"
 	}
 }
@@ -9,10 +9,14 @@ import (
 	"os"
 
 	svc "github.com/norceresearch/cads-fmi-demo/orchestrator/service"
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/workflow"
 )
 
 func main() {
-	var workflow string
+	fmi.ServeIsolatedWorker()
+
+	var workflowPath string
 	var serve bool
 	var addr string
 	var workdir string
@@ -21,8 +25,9 @@ func main() {
 	var argoServiceAccount string
 	var remoteImage string
 	var kubeconfig string
+	var maxSweepMembers int
 
-	flag.StringVar(&workflow, "workflow", "", "Run the workflow once and exit")
+	flag.StringVar(&workflowPath, "workflow", "", "Run the workflow once and exit")
 	flag.BoolVar(&serve, "serve", false, "Start the HTTP service")
 	flag.StringVar(&addr, "addr", ":8080", "HTTP listen address (default :8080)")
 	flag.StringVar(&workdir, "workdir", "", "Explicit repository root (optional)")
@@ -31,15 +36,16 @@ func main() {
 	flag.StringVar(&argoServiceAccount, "argo-service-account", "", "Hosted Argo service account (default ARGO_SERVICE_ACCOUNT or playground-storhy-playground-pg-admin)")
 	flag.StringVar(&remoteImage, "remote-image", "", "Hosted workflow image (default CADS_WORKFLOW_IMAGE or ghcr.io/janlv/cads-fmi-demo:playground)")
 	flag.StringVar(&kubeconfig, "kubeconfig", "", "Optional kubeconfig used when ARGO_TOKEN is not set")
+	flag.IntVar(&maxSweepMembers, "max-sweep-members", workflow.DefaultMaxSweepMembers, "Reject swept steps with more members than this")
 	flag.Parse()
 
-	runner, err := svc.NewRunner(workdir)
+	runner, err := svc.NewRunner(workdir, workflow.WithMaxSweepMembers(maxSweepMembers))
 	if err != nil {
 		log.Fatal(err)
 	}
 
-	if workflow != "" {
-		results, err := runner.Run(workflow)
+	if workflowPath != "" {
+		results, err := runner.Run(workflowPath)
 		if err != nil {
 			log.Fatal(err)
 		}
@@ -69,7 +75,7 @@ func main() {
 		log.Fatal(http.ListenAndServe(addr, server))
 	}
 
-	if workflow == "" && !serve {
+	if workflowPath == "" && !serve {
 		flag.Usage()
 		os.Exit(1)
 	}
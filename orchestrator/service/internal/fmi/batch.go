@@ -0,0 +1,85 @@
+package fmi
+
+import (
+	"encoding/json"
+	"fmt"
+	"runtime"
+	"sync"
+)
+
+// BatchOptions tune how RunBatch spreads configs over the bridge's threads.
+type BatchOptions struct {
+	// Workers is the number of bridge threads; 0 selects one per core.
+	Workers int
+	// Interleave is how many runs each worker keeps in flight, advancing them
+	// one communication step at a time. 0 or 1 runs them one after another;
+	// larger values suit many short runs of small FMUs.
+	Interleave int
+}
+
+// BatchResult is the outcome of one config passed to RunBatch.
+type BatchResult struct {
+	Result map[string]any
+	Err    error
+}
+
+// batchEntry mirrors one element of the JSON array returned by cads_run_batch.
+type batchEntry struct {
+	Status string         `json:"status"`
+	Result map[string]any `json:"result"`
+	Error  string         `json:"error"`
+}
+
+func decodeBatchResults(data []byte, results []BatchResult) error {
+	var entries []batchEntry
+	if err := json.Unmarshal(data, &entries); err != nil {
+		return fmt.Errorf("decode batch result: %w", err)
+	}
+	if len(entries) != len(results) {
+		return fmt.Errorf("decode batch result: got %d entries, want %d", len(entries), len(results))
+	}
+	for i, entry := range entries {
+		switch entry.Status {
+		case "ok":
+			results[i] = BatchResult{Result: entry.Result}
+		case "isolate":
+			results[i] = BatchResult{Err: errNeedsIsolation}
+		case "error":
+			results[i] = BatchResult{Err: fmt.Errorf("fmi runner: %s", entry.Error)}
+		default:
+			return fmt.Errorf("decode batch result: unknown status %q", entry.Status)
+		}
+	}
+	return nil
+}
+
+// retryIsolated reruns, in at most workers concurrent worker processes, every
+// entry the bridge could not admit in-process.
+func retryIsolated(cfgs []Config, results []BatchResult, workers int) {
+	if workers <= 0 {
+		workers = runtime.NumCPU()
+	}
+	slots := make(chan struct{}, workers)
+	var wg sync.WaitGroup
+	for i := range results {
+		if results[i].Err != errNeedsIsolation {
+			continue
+		}
+		wg.Add(1)
+		slots <- struct{}{}
+		go func(i int) {
+			defer wg.Done()
+			defer func() { <-slots }()
+			result, err := runIsolated(cfgs[i])
+			results[i] = BatchResult{Result: result, Err: err}
+		}(i)
+	}
+	wg.Wait()
+}
+
+func failBatch(results []BatchResult, err error) []BatchResult {
+	for i := range results {
+		results[i] = BatchResult{Err: err}
+	}
+	return results
+}
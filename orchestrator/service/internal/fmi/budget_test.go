@@ -0,0 +1,41 @@
+//go:build cgo
+
+package fmi
+
+import (
+	"math"
+	"testing"
+)
+
+func TestWallBudgetReturnsPartialResults(t *testing.T) {
+	tiny := 1e-9
+	result, err := Run(Config{
+		FMUPath:    ciTestFMU,
+		Outputs:    []string{"time"},
+		Trace:      &TraceConfig{Outputs: []string{"time"}},
+		WallBudget: &tiny,
+	})
+	if err != nil {
+		t.Fatalf("run: %v", err)
+	}
+	reached, _ := result["reached_time"].(float64)
+	if result["partial"] != true || reached >= 30 {
+		t.Fatalf("partial = %v, reached_time = %v; want a run cut short of its 30 s stop", result["partial"], result["reached_time"])
+	}
+	times := result["trace"].(map[string]any)["time"].([]any)
+	if len(times) == 0 || times[len(times)-1].(float64) != reached {
+		t.Fatalf("trace times = %v, want them to end at reached_time %v", times, reached)
+	}
+
+	// Budgets beyond what steady_clock can add to now must not wrap around
+	// into a deadline that has already passed.
+	for _, budget := range []float64{1e10, 1e300, math.Inf(1)} {
+		result, err := Run(Config{FMUPath: ciTestFMU, Outputs: []string{"time"}, WallBudget: &budget})
+		if err != nil {
+			t.Fatalf("budget %g: %v", budget, err)
+		}
+		if result["partial"] != false || result["reached_time"] != 30.0 {
+			t.Fatalf("budget %g: partial = %v, reached_time = %v; want the whole run", budget, result["partial"], result["reached_time"])
+		}
+	}
+}
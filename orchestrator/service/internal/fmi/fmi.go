@@ -4,8 +4,8 @@ package fmi
 
 /*
 #cgo CXXFLAGS: -std=c++17
-#cgo linux LDFLAGS: -lfmilib_shared -lpugixml -lzip -lm -ldl -lstdc++
-#cgo darwin LDFLAGS: -lfmilib_shared -lm -lc++
+#cgo linux LDFLAGS: -lfmilib_shared -lpugixml -lzip -lm -ldl -lz -lzstd -lstdc++
+#cgo darwin LDFLAGS: -lfmilib_shared -lz -lzstd -lm -lc++
 #include <stdlib.h>
 #include "runner_bridge.h"
 */
@@ -13,6 +13,7 @@ import "C"
 
 import (
 	"encoding/json"
+	"errors"
 	"fmt"
 	"sort"
 	"unsafe"
@@ -24,14 +25,25 @@ type Config struct {
 	StartTime   *float64
 	StopTime    *float64
 	StepSize    *float64
-	StartValues map[string]string
+	StartValues map[string]StartValue
 	Outputs     []string
-	InputSeries *InputSeriesConfig
+	// InputSeries are merged by time while the run advances.
+	InputSeries []InputSeriesConfig
 	Trace       *TraceConfig
-}
-
-type InputSeriesConfig struct {
-	CSVPath string
+	Priority    Priority
+	// WallBudget bounds the run's wall-clock time in seconds. When it runs out the
+	// result holds the values reached so far with "partial" set to true.
+	WallBudget *float64
+	// Live feeds the run from a pipe or socket instead of InputSeries.
+	Live *LiveConfig
+	// CoalesceSteps lets FMUs that accept variable communication step sizes
+	// advance by MaxStep (the whole horizon when nil) per do_step instead of
+	// StepSize. Only for runs without Trace, InputSeries or Live.
+	CoalesceSteps bool
+	MaxStep       *float64
+	// OutputsAt lists simulation times at which Outputs are also read. The
+	// result holds them under "outputs_at" as {"time": [...], "values": {...}}.
+	OutputsAt []float64
 }
 
 type TraceConfig struct {
@@ -41,17 +53,111 @@ type TraceConfig struct {
 }
 
 // Run executes the FMU using FMIL and returns the final snapshot of requested outputs plus
-// optional sampled trace data when configured.
+// optional sampled trace data when configured. Run is safe for concurrent use: FMUs that
+// are not reentrant are routed to an isolated worker process while another run in this
+// process is using them.
 func Run(cfg Config) (map[string]any, error) {
+	result, err := run(cfg, true)
+	if errors.Is(err, errNeedsIsolation) {
+		return runIsolated(cfg)
+	}
+	return result, err
+}
+
+func run(cfg Config, allowIsolation bool) (map[string]any, error) {
 	if cfg.FMUPath == "" {
 		return nil, fmt.Errorf("fmi: FMU path is required")
 	}
 
-	cCfg := C.cads_fmu_config{}
-	cPath := C.CString(cfg.FMUPath)
+	alloc := &cAllocator{}
+	defer alloc.free()
+	cCfg, err := alloc.config(cfg, allowIsolation)
+	if err != nil {
+		return nil, err
+	}
+
+	var jsonOut *C.char
+	var errOut *C.char
+
+	code := C.cads_run_fmu(cCfg, &jsonOut, &errOut)
+
+	if code == C.CADS_RUN_NEEDS_ISOLATION {
+		if errOut != nil {
+			C.cads_free_string(errOut)
+		}
+		return nil, errNeedsIsolation
+	}
+	if code != C.CADS_RUN_OK {
+		if errOut != nil {
+			defer C.cads_free_string(errOut)
+			return nil, fmt.Errorf("fmi runner: %s", C.GoString(errOut))
+		}
+		return nil, fmt.Errorf("fmi runner failed without error message")
+	}
+	defer C.cads_free_string(jsonOut)
+
+	var parsed map[string]any
+	if err := json.Unmarshal([]byte(C.GoString(jsonOut)), &parsed); err != nil {
+		return nil, fmt.Errorf("decode FMU result: %w", err)
+	}
+	return parsed, nil
+}
+
+// archiveDigest returns the hex SHA-256 of the FMU at fmuPath, the key under
+// which the bridge shares one unpack between concurrent runs.
+func archiveDigest(fmuPath string) (string, error) {
+	cPath := C.CString(fmuPath)
 	defer C.free(unsafe.Pointer(cPath))
-	cCfg.fmu_path = cPath
+	var digestOut *C.char
+	var errOut *C.char
+	if C.cads_fmu_digest(cPath, &digestOut, &errOut) != C.CADS_RUN_OK {
+		if errOut != nil {
+			defer C.cads_free_string(errOut)
+			return "", fmt.Errorf("fmi digest: %s", C.GoString(errOut))
+		}
+		return "", fmt.Errorf("fmi digest failed without error message")
+	}
+	defer C.cads_free_string(digestOut)
+	return C.GoString(digestOut), nil
+}
+
+// RunOperator runs a built-in operator in the bridge. The result holds "value"
+// (the last sample, or the reduced value of OperatorQuantile) and, for signal
+// results, a "trace" shaped like the trace of an FMU run with one signal named
+// "value".
+func RunOperator(cfg OperatorConfig) (map[string]any, error) {
+	if len(cfg.Times) != len(cfg.Values) {
+		return nil, fmt.Errorf("fmi: operator has %d times but %d values", len(cfg.Times), len(cfg.Values))
+	}
 
+	alloc := &cAllocator{}
+	defer alloc.free()
+	cCfg := (*C.cads_operator_config)(alloc.malloc(C.sizeof_cads_operator_config))
+	if cCfg == nil {
+		return nil, fmt.Errorf("fmi: failed to allocate operator config buffer")
+	}
+	*cCfg = C.cads_operator_config{
+		op:            C.int(cfg.Op),
+		window:        C.double(cfg.Window),
+		interval:      C.double(cfg.Interval),
+		interpolation: C.int(InputInterpolationLinear),
+		quantile:      C.double(cfg.Quantile),
+		factor:        C.double(cfg.Factor),
+		offset:        C.double(cfg.Offset),
+		level:         C.double(cfg.Level),
+	}
+	var err error
+	if cCfg.times, cCfg.count, err = alloc.doubles(cfg.Times, "operator times"); err != nil {
+		return nil, err
+	}
+	if cCfg.values, _, err = alloc.doubles(cfg.Values, "operator values"); err != nil {
+		return nil, err
+	}
+	if cfg.InputSeries != nil {
+		if cCfg.input_series, _, err = alloc.inputSeries([]InputSeriesConfig{*cfg.InputSeries}); err != nil {
+			return nil, err
+		}
+	}
 	if cfg.StartTime != nil {
 		cCfg.has_start_time = true
 		cCfg.start_time = C.double(*cfg.StartTime)
@@ -60,126 +166,372 @@ func Run(cfg Config) (map[string]any, error) {
 		cCfg.has_stop_time = true
 		cCfg.stop_time = C.double(*cfg.StopTime)
 	}
-	if cfg.StepSize != nil {
-		cCfg.has_step_size = true
-		cCfg.step_size = C.double(*cfg.StepSize)
+
+	var jsonOut *C.char
+	var errOut *C.char
+	if code := C.cads_run_operator(cCfg, &jsonOut, &errOut); code != C.CADS_RUN_OK {
+		if errOut != nil {
+			defer C.cads_free_string(errOut)
+			return nil, fmt.Errorf("fmi operator: %s", C.GoString(errOut))
+		}
+		return nil, fmt.Errorf("fmi operator failed without error message")
+	}
+	defer C.cads_free_string(jsonOut)
+
+	var parsed map[string]any
+	if err := json.Unmarshal([]byte(C.GoString(jsonOut)), &parsed); err != nil {
+		return nil, fmt.Errorf("decode operator result: %w", err)
 	}
+	return parsed, nil
+}
 
-	var assignmentBacking []*C.char
-	if len(cfg.StartValues) > 0 {
-		keys := make([]string, 0, len(cfg.StartValues))
-		for k := range cfg.StartValues {
-			keys = append(keys, k)
+// RunBatch executes cfgs on the bridge's work-stealing thread pool and returns one
+// result per config in input order. Configs whose FMU is not reentrant and was busy
+// are retried in isolated worker processes.
+func RunBatch(cfgs []Config, opts BatchOptions) []BatchResult {
+	results := make([]BatchResult, len(cfgs))
+	if len(cfgs) == 0 {
+		return results
+	}
+	for i, cfg := range cfgs {
+		if cfg.FMUPath == "" {
+			return failBatch(results, fmt.Errorf("fmi: batch config %d: FMU path is required", i))
 		}
-		sort.Strings(keys)
-		mem := C.malloc(C.size_t(len(keys)) * C.size_t(C.sizeof_cads_assignment))
-		if mem == nil {
-			return nil, fmt.Errorf("fmi: failed to allocate start value buffer")
+	}
+	workers := max(opts.Workers, 0)
+	interleave := max(opts.Interleave, 0)
+
+	alloc := &cAllocator{}
+	defer alloc.free()
+	array := (*C.cads_fmu_config)(alloc.malloc(uintptr(len(cfgs)) * C.sizeof_cads_fmu_config))
+	if array == nil {
+		return failBatch(results, fmt.Errorf("fmi: failed to allocate batch config buffer"))
+	}
+	entries := unsafe.Slice(array, len(cfgs))
+	for i, cfg := range cfgs {
+		cCfg, err := alloc.config(cfg, true)
+		if err != nil {
+			return failBatch(results, err)
 		}
-		defer C.free(mem)
-		assignments := unsafe.Slice((*C.cads_assignment)(mem), len(keys))
-		for i, key := range keys {
-			value := cfg.StartValues[key]
-			nameC := C.CString(key)
-			valueC := C.CString(value)
-			assignmentBacking = append(assignmentBacking, nameC, valueC)
-			assignments[i] = C.cads_assignment{name: nameC, value: valueC}
+		entries[i] = *cCfg
+	}
+
+	var jsonOut *C.char
+	var errOut *C.char
+	code := C.cads_run_batch(array, C.size_t(len(cfgs)), C.size_t(workers), C.size_t(interleave), &jsonOut, &errOut)
+	if code != C.CADS_RUN_OK {
+		if errOut != nil {
+			defer C.cads_free_string(errOut)
+			return failBatch(results, fmt.Errorf("fmi batch runner: %s", C.GoString(errOut)))
 		}
-		cCfg.start_values = (*C.cads_assignment)(mem)
-		cCfg.start_value_count = C.size_t(len(keys))
+		return failBatch(results, fmt.Errorf("fmi batch runner failed without error message"))
+	}
+	defer C.cads_free_string(jsonOut)
+
+	if err := decodeBatchResults([]byte(C.GoString(jsonOut)), results); err != nil {
+		return failBatch(results, err)
+	}
+	retryIsolated(cfgs, results, workers)
+	return results
+}
+
+// HoldPriority announces pending interactive work: batch runs in this process
+// pause at their next communication step until every hold is released, and
+// batch runs needing an isolated worker are not started until then.
+func HoldPriority() {
+	interactiveHolds.hold()
+	C.cads_priority_hold()
+}
+
+// ReleasePriority withdraws a hold taken with HoldPriority.
+func ReleasePriority() {
+	C.cads_priority_release()
+	interactiveHolds.release()
+}
+
+// cAllocator owns the C memory backing one or more cads_fmu_config values until
+// the bridge call returns.
+type cAllocator struct {
+	ptrs []unsafe.Pointer
+}
+
+func (a *cAllocator) malloc(size uintptr) unsafe.Pointer {
+	mem := C.malloc(C.size_t(size))
+	if mem != nil {
+		a.ptrs = append(a.ptrs, mem)
+	}
+	return mem
+}
+
+func (a *cAllocator) cstring(value string) *C.char {
+	cstr := C.CString(value)
+	a.ptrs = append(a.ptrs, unsafe.Pointer(cstr))
+	return cstr
+}
+
+func (a *cAllocator) stringArray(values []string, what string) (**C.char, C.size_t, error) {
+	if len(values) == 0 {
+		return nil, 0, nil
+	}
+	ptrSize := unsafe.Sizeof((*C.char)(nil))
+	mem := a.malloc(uintptr(len(values)) * ptrSize)
+	if mem == nil {
+		return nil, 0, fmt.Errorf("fmi: failed to allocate %s buffer", what)
 	}
+	ptrs := unsafe.Slice((**C.char)(mem), len(values))
+	for i, value := range values {
+		ptrs[i] = a.cstring(value)
+	}
+	return (**C.char)(mem), C.size_t(len(values)), nil
+}
+
+func (a *cAllocator) doubles(values []float64, what string) (*C.double, C.size_t, error) {
+	if len(values) == 0 {
+		return nil, 0, nil
+	}
+	mem := a.malloc(uintptr(len(values)) * C.sizeof_double)
+	if mem == nil {
+		return nil, 0, fmt.Errorf("fmi: failed to allocate %s buffer", what)
+	}
+	entries := unsafe.Slice((*C.double)(mem), len(values))
+	for i, value := range values {
+		entries[i] = C.double(value)
+	}
+	return (*C.double)(mem), C.size_t(len(values)), nil
+}
+
+// assignments copies values, sorted by key, into a cads_assignment array.
+func (a *cAllocator) assignments(values map[string]string, what string) (*C.cads_assignment, C.size_t, error) {
+	if len(values) == 0 {
+		return nil, 0, nil
+	}
+	keys := make([]string, 0, len(values))
+	for k := range values {
+		keys = append(keys, k)
+	}
+	sort.Strings(keys)
+	mem := a.malloc(uintptr(len(keys)) * C.sizeof_cads_assignment)
+	if mem == nil {
+		return nil, 0, fmt.Errorf("fmi: failed to allocate %s buffer", what)
+	}
+	entries := unsafe.Slice((*C.cads_assignment)(mem), len(keys))
+	for i, key := range keys {
+		entries[i] = C.cads_assignment{name: a.cstring(key), value: a.cstring(values[key])}
+	}
+	return (*C.cads_assignment)(mem), C.size_t(len(keys)), nil
+}
 
-	if cfg.InputSeries != nil && cfg.InputSeries.CSVPath != "" {
-		cstr := C.CString(cfg.InputSeries.CSVPath)
-		assignmentBacking = append(assignmentBacking, cstr)
-		inputSeries := (*C.cads_input_series)(C.malloc(C.size_t(C.sizeof_cads_input_series)))
-		if inputSeries == nil {
-			return nil, fmt.Errorf("fmi: failed to allocate input series buffer")
+// startValues packs values, sorted by name, into one allocation: the
+// cads_start_value array followed by the string table holding the names and
+// string values.
+func (a *cAllocator) startValues(cCfg *C.cads_fmu_config, values map[string]StartValue) error {
+	if len(values) == 0 {
+		return nil
+	}
+	names := make([]string, 0, len(values))
+	tableSize := 0
+	for name, value := range values {
+		names = append(names, name)
+		tableSize += len(name) + len(value.Text)
+	}
+	sort.Strings(names)
+	entriesSize := uintptr(len(names)) * C.sizeof_cads_start_value
+	mem := a.malloc(entriesSize + uintptr(tableSize))
+	if mem == nil {
+		return fmt.Errorf("fmi: failed to allocate start value buffer")
+	}
+	entries := unsafe.Slice((*C.cads_start_value)(mem), len(names))
+	table := unsafe.Slice((*byte)(unsafe.Add(mem, entriesSize)), tableSize)
+	offset := 0
+	put := func(s string) C.cads_string_ref {
+		ref := C.cads_string_ref{offset: C.size_t(offset), length: C.size_t(len(s))}
+		offset += copy(table[offset:], s)
+		return ref
+	}
+	for i, name := range names {
+		value := values[name]
+		entry := C.cads_start_value{name: put(name), _type: C.int(value.Kind)}
+		union := unsafe.Pointer(&entry.value)
+		switch value.Kind {
+		case ValueReal:
+			*(*C.double)(union) = C.double(value.Real)
+		case ValueInteger:
+			*(*C.longlong)(union) = C.longlong(value.Integer)
+		case ValueBoolean:
+			*(*C.bool)(union) = C.bool(value.Bool)
+		case ValueString:
+			*(*C.cads_string_ref)(union) = put(value.Text)
+		default:
+			return fmt.Errorf("fmi: start value %s has unknown kind %d", name, value.Kind)
 		}
-		defer C.free(unsafe.Pointer(inputSeries))
-		*inputSeries = C.cads_input_series{csv_path: cstr}
-		cCfg.input_series = inputSeries
+		entries[i] = entry
 	}
+	cCfg.typed_start_values = (*C.cads_start_value)(mem)
+	cCfg.typed_start_value_count = C.size_t(len(names))
+	cCfg.string_table = (*C.char)(unsafe.Add(mem, entriesSize))
+	cCfg.string_table_size = C.size_t(tableSize)
+	return nil
+}
 
-	if len(cfg.Outputs) > 0 {
-		ptrSize := unsafe.Sizeof((*C.char)(nil))
-		mem := C.malloc(C.size_t(len(cfg.Outputs)) * C.size_t(ptrSize))
-		if mem == nil {
-			return nil, fmt.Errorf("fmi: failed to allocate outputs buffer")
+// inputSeries copies every series with a CSV path into a cads_input_series array.
+func (a *cAllocator) inputSeries(series []InputSeriesConfig) (*C.cads_input_series, C.size_t, error) {
+	used := make([]InputSeriesConfig, 0, len(series))
+	for _, s := range series {
+		if s.CSVPath != "" {
+			used = append(used, s)
+		}
+	}
+	if len(used) == 0 {
+		return nil, 0, nil
+	}
+	mem := a.malloc(uintptr(len(used)) * C.sizeof_cads_input_series)
+	if mem == nil {
+		return nil, 0, fmt.Errorf("fmi: failed to allocate input series buffer")
+	}
+	entries := unsafe.Slice((*C.cads_input_series)(mem), len(used))
+	for i, s := range used {
+		entry := C.cads_input_series{
+			csv_path:      a.cstring(s.CSVPath),
+			dialect:       C.int(s.Dialect),
+			interpolation: C.int(s.Interpolation),
 		}
-		defer C.free(mem)
-		outputPtrs := unsafe.Slice((**C.char)(mem), len(cfg.Outputs))
-		for i, name := range cfg.Outputs {
-			cstr := C.CString(name)
-			assignmentBacking = append(assignmentBacking, cstr)
-			outputPtrs[i] = cstr
+		var err error
+		if entry.columns, entry.column_count, err = a.assignments(s.Columns, "input columns"); err != nil {
+			return nil, 0, err
 		}
-		cCfg.outputs = (**C.char)(mem)
-		cCfg.output_count = C.size_t(len(outputPtrs))
+		if entry.ignore_columns, entry.ignore_column_count, err = a.stringArray(s.Ignore, "ignored input columns"); err != nil {
+			return nil, 0, err
+		}
+		if entry.fields, entry.field_count, err = a.inputFields(s.Fields); err != nil {
+			return nil, 0, err
+		}
+		entries[i] = entry
 	}
+	return (*C.cads_input_series)(mem), C.size_t(len(used)), nil
+}
 
-	if cfg.Trace != nil {
-		if cfg.Trace.SampleEvery != nil {
-			cCfg.has_trace_interval = true
-			cCfg.trace_interval = C.double(*cfg.Trace.SampleEvery)
-		}
-		if len(cfg.Trace.Outputs) > 0 {
-			ptrSize := unsafe.Sizeof((*C.char)(nil))
-			mem := C.malloc(C.size_t(len(cfg.Trace.Outputs)) * C.size_t(ptrSize))
-			if mem == nil {
-				return nil, fmt.Errorf("fmi: failed to allocate trace outputs buffer")
-			}
-			defer C.free(mem)
-			outputPtrs := unsafe.Slice((**C.char)(mem), len(cfg.Trace.Outputs))
-			for i, name := range cfg.Trace.Outputs {
-				cstr := C.CString(name)
-				assignmentBacking = append(assignmentBacking, cstr)
-				outputPtrs[i] = cstr
-			}
-			cCfg.trace_outputs = (**C.char)(mem)
-			cCfg.trace_output_count = C.size_t(len(outputPtrs))
-		}
-		if len(cfg.Trace.Inputs) > 0 {
-			ptrSize := unsafe.Sizeof((*C.char)(nil))
-			mem := C.malloc(C.size_t(len(cfg.Trace.Inputs)) * C.size_t(ptrSize))
-			if mem == nil {
-				return nil, fmt.Errorf("fmi: failed to allocate trace inputs buffer")
-			}
-			defer C.free(mem)
-			inputPtrs := unsafe.Slice((**C.char)(mem), len(cfg.Trace.Inputs))
-			for i, name := range cfg.Trace.Inputs {
-				cstr := C.CString(name)
-				assignmentBacking = append(assignmentBacking, cstr)
-				inputPtrs[i] = cstr
-			}
-			cCfg.trace_inputs = (**C.char)(mem)
-			cCfg.trace_input_count = C.size_t(len(inputPtrs))
-		}
-	}
-
-	defer func() {
-		for _, ptr := range assignmentBacking {
-			C.free(unsafe.Pointer(ptr))
-		}
-	}()
+// inputFields copies fields, in order, into a cads_assignment array of
+// name -> type pairs.
+func (a *cAllocator) inputFields(fields []InputField) (*C.cads_assignment, C.size_t, error) {
+	if len(fields) == 0 {
+		return nil, 0, nil
+	}
+	mem := a.malloc(uintptr(len(fields)) * C.sizeof_cads_assignment)
+	if mem == nil {
+		return nil, 0, fmt.Errorf("fmi: failed to allocate input fields buffer")
+	}
+	entries := unsafe.Slice((*C.cads_assignment)(mem), len(fields))
+	for i, field := range fields {
+		entries[i] = C.cads_assignment{name: a.cstring(field.Name), value: a.cstring(field.Type)}
+	}
+	return (*C.cads_assignment)(mem), C.size_t(len(fields)), nil
+}
 
-	var jsonOut *C.char
-	var errOut *C.char
+// live copies cfg into a cads_live_input.
+func (a *cAllocator) live(cfg LiveConfig) (*C.cads_live_input, error) {
+	if cfg.QueueDepth < 0 {
+		return nil, fmt.Errorf("fmi: live queue depth must not be negative")
+	}
+	live := (*C.cads_live_input)(a.malloc(C.sizeof_cads_live_input))
+	if live == nil {
+		return nil, fmt.Errorf("fmi: failed to allocate live input buffer")
+	}
+	*live = C.cads_live_input{
+		input_path:  a.cstring(cfg.InputPath),
+		format:      C.int(cfg.Format),
+		queue_depth: C.size_t(cfg.QueueDepth),
+		gap_policy:  C.int(cfg.OnGap),
+	}
+	if cfg.OutputPath != "" {
+		live.output_path = a.cstring(cfg.OutputPath)
+	}
+	if cfg.MaxGap != nil {
+		live.has_max_gap = true
+		live.max_gap = C.double(*cfg.MaxGap)
+	}
+	var err error
+	if live.columns, live.column_count, err = a.assignments(cfg.Columns, "live columns"); err != nil {
+		return nil, err
+	}
+	if live.fields, live.field_count, err = a.stringArray(cfg.Fields, "live fields"); err != nil {
+		return nil, err
+	}
+	return live, nil
+}
 
-	code := C.cads_run_fmu(&cCfg, &jsonOut, &errOut)
+func (a *cAllocator) free() {
+	for _, ptr := range a.ptrs {
+		C.free(ptr)
+	}
+	a.ptrs = nil
+}
 
-	if code != 0 {
-		if errOut != nil {
-			defer C.cads_free_string(errOut)
-			return nil, fmt.Errorf("fmi runner: %s", C.GoString(errOut))
+func (a *cAllocator) config(cfg Config, allowIsolation bool) (*C.cads_fmu_config, error) {
+	cCfg := (*C.cads_fmu_config)(a.malloc(C.sizeof_cads_fmu_config))
+	if cCfg == nil {
+		return nil, fmt.Errorf("fmi: failed to allocate config buffer")
+	}
+	*cCfg = C.cads_fmu_config{}
+	cCfg.allow_isolation = C.bool(allowIsolation)
+	cCfg.priority = C.int(cfg.Priority)
+	if cfg.WallBudget != nil {
+		cCfg.has_wall_budget = true
+		cCfg.wall_budget = C.double(*cfg.WallBudget)
+	}
+	cCfg.coalesce_steps = C.bool(cfg.CoalesceSteps)
+	if cfg.MaxStep != nil {
+		cCfg.has_max_step = true
+		cCfg.max_step = C.double(*cfg.MaxStep)
+	}
+	cCfg.fmu_path = a.cstring(cfg.FMUPath)
+
+	if cfg.StartTime != nil {
+		cCfg.has_start_time = true
+		cCfg.start_time = C.double(*cfg.StartTime)
+	}
+	if cfg.StopTime != nil {
+		cCfg.has_stop_time = true
+		cCfg.stop_time = C.double(*cfg.StopTime)
+	}
+	if cfg.StepSize != nil {
+		cCfg.has_step_size = true
+		cCfg.step_size = C.double(*cfg.StepSize)
+	}
+
+	if err := a.startValues(cCfg, cfg.StartValues); err != nil {
+		return nil, err
+	}
+
+	var err error
+
+	if cCfg.input_series, cCfg.input_series_count, err = a.inputSeries(cfg.InputSeries); err != nil {
+		return nil, err
+	}
+
+	if cfg.Live != nil {
+		if cCfg.live, err = a.live(*cfg.Live); err != nil {
+			return nil, err
 		}
-		return nil, fmt.Errorf("fmi runner failed without error message")
 	}
-	defer C.cads_free_string(jsonOut)
 
-	var parsed map[string]any
-	if err := json.Unmarshal([]byte(C.GoString(jsonOut)), &parsed); err != nil {
-		return nil, fmt.Errorf("decode FMU result: %w", err)
+	if cCfg.outputs, cCfg.output_count, err = a.stringArray(cfg.Outputs, "outputs"); err != nil {
+		return nil, err
 	}
-	return parsed, nil
+	if cCfg.outputs_at, cCfg.outputs_at_count, err = a.doubles(cfg.OutputsAt, "outputs_at"); err != nil {
+		return nil, err
+	}
+
+	if cfg.Trace != nil {
+		if cfg.Trace.SampleEvery != nil {
+			cCfg.has_trace_interval = true
+			cCfg.trace_interval = C.double(*cfg.Trace.SampleEvery)
+		}
+		if cCfg.trace_outputs, cCfg.trace_output_count, err = a.stringArray(cfg.Trace.Outputs, "trace outputs"); err != nil {
+			return nil, err
+		}
+		if cCfg.trace_inputs, cCfg.trace_input_count, err = a.stringArray(cfg.Trace.Inputs, "trace inputs"); err != nil {
+			return nil, err
+		}
+	}
+	return cCfg, nil
 }
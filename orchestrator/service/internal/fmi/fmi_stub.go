@@ -2,7 +2,9 @@
 
 package fmi
 
-import "fmt"
+import (
+	"fmt"
+)
 
 // Config describes a single FMU execution.
 type Config struct {
@@ -10,14 +12,25 @@ type Config struct {
 	StartTime   *float64
 	StopTime    *float64
 	StepSize    *float64
-	StartValues map[string]string
+	StartValues map[string]StartValue
 	Outputs     []string
-	InputSeries *InputSeriesConfig
+	// InputSeries are merged by time while the run advances.
+	InputSeries []InputSeriesConfig
 	Trace       *TraceConfig
-}
-
-type InputSeriesConfig struct {
-	CSVPath string
+	Priority    Priority
+	// WallBudget bounds the run's wall-clock time in seconds. When it runs out the
+	// result holds the values reached so far with "partial" set to true.
+	WallBudget *float64
+	// Live feeds the run from a pipe or socket instead of InputSeries.
+	Live *LiveConfig
+	// CoalesceSteps lets FMUs that accept variable communication step sizes
+	// advance by MaxStep (the whole horizon when nil) per do_step instead of
+	// StepSize. Only for runs without Trace, InputSeries or Live.
+	CoalesceSteps bool
+	MaxStep       *float64
+	// OutputsAt lists simulation times at which Outputs are also read. The
+	// result holds them under "outputs_at" as {"time": [...], "values": {...}}.
+	OutputsAt []float64
 }
 
 type TraceConfig struct {
@@ -28,8 +41,41 @@ type TraceConfig struct {
 
 // Run reports that the FMIL-backed runner is unavailable without CGO.
 func Run(cfg Config) (map[string]any, error) {
+	return run(cfg, false)
+}
+
+func run(cfg Config, _ bool) (map[string]any, error) {
 	if cfg.FMUPath == "" {
 		return nil, fmt.Errorf("fmi: FMU path is required")
 	}
 	return nil, fmt.Errorf("fmi runner requires CGO and FMIL headers/libraries")
 }
+
+// RunOperator reports that the bridge's operators are unavailable without CGO.
+func RunOperator(_ OperatorConfig) (map[string]any, error) {
+	return nil, fmt.Errorf("fmi operators require CGO and FMIL headers/libraries")
+}
+
+// RunBatch reports that the FMIL-backed runner is unavailable for every config.
+func RunBatch(cfgs []Config, _ BatchOptions) []BatchResult {
+	results := make([]BatchResult, len(cfgs))
+	for i, cfg := range cfgs {
+		_, err := Run(cfg)
+		results[i] = BatchResult{Err: err}
+	}
+	return results
+}
+
+// HoldPriority only delays isolated batch runs without the FMIL bridge.
+func HoldPriority() { interactiveHolds.hold() }
+
+// ReleasePriority withdraws a hold taken with HoldPriority.
+func ReleasePriority() { interactiveHolds.release() }
+
+func zygoteSuits(string) (bool, error) {
+	return false, fmt.Errorf("fmi zygote requires CGO and FMIL headers/libraries")
+}
+
+func archiveDigest(string) (string, error) {
+	return "", fmt.Errorf("fmi digest requires CGO and FMIL headers/libraries")
+}
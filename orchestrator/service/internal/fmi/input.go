@@ -0,0 +1,96 @@
+package fmi
+
+import (
+	"fmt"
+	"strings"
+)
+
+// InputDialect selects how an input series file is laid out. The values mirror
+// the CADS_INPUT_DIALECT_* constants of the bridge.
+type InputDialect int
+
+const (
+	// InputDialectPlain files have the header on the first line and numeric
+	// seconds in the first column.
+	InputDialectPlain InputDialect = iota
+	// InputDialectAE files are raw acoustic-emission exports: a Key:,Value
+	// metadata preamble followed by an "Arrival time" table. Times become
+	// seconds since the first event.
+	InputDialectAE
+	// InputDialectPgCopy files (or pipes) hold PostgreSQL
+	// `COPY ... TO STDOUT (FORMAT binary)` output, described by Fields.
+	InputDialectPgCopy
+)
+
+// ParseInputDialect maps "plain", "ae" or "pgcopy" (case-insensitive) to an
+// InputDialect.
+// The empty string selects InputDialectPlain.
+func ParseInputDialect(value string) (InputDialect, error) {
+	switch strings.ToLower(strings.TrimSpace(value)) {
+	case "", "plain":
+		return InputDialectPlain, nil
+	case "ae":
+		return InputDialectAE, nil
+	case "pgcopy":
+		return InputDialectPgCopy, nil
+	default:
+		return InputDialectPlain, fmt.Errorf("unknown input dialect %q (want plain, ae or pgcopy)", value)
+	}
+}
+
+// InputInterpolation selects how an input series sets its variables between
+// rows. The values mirror the CADS_INPUT_INTERPOLATION_* constants of the bridge.
+type InputInterpolation int
+
+const (
+	// InputInterpolationHold applies each row once simulation time reaches it.
+	InputInterpolationHold InputInterpolation = iota
+	// InputInterpolationLinear sets variables to the straight line between the
+	// rows around each communication point.
+	InputInterpolationLinear
+)
+
+// ParseInputInterpolation maps "hold" or "linear" (case-insensitive) to an
+// InputInterpolation. The empty string selects InputInterpolationHold.
+func ParseInputInterpolation(value string) (InputInterpolation, error) {
+	switch strings.ToLower(strings.TrimSpace(value)) {
+	case "", "hold":
+		return InputInterpolationHold, nil
+	case "linear":
+		return InputInterpolationLinear, nil
+	default:
+		return InputInterpolationHold, fmt.Errorf("unknown input interpolation %q (want hold or linear)", value)
+	}
+}
+
+// InputSeriesConfig points a run at a time-indexed CSV of FMU inputs.
+type InputSeriesConfig struct {
+	CSVPath string
+	Dialect InputDialect
+	// Columns maps CSV column names to FMU variables. When empty every column
+	// is applied under its header name.
+	Columns map[string]string
+	// Ignore lists columns that are skipped without being parsed.
+	Ignore        []string
+	Interpolation InputInterpolation
+	// Fields names and types every column of an InputDialectPgCopy dump, in
+	// column order. The first field is the time.
+	Fields []InputField
+}
+
+// InputField is one column of a binary COPY dump. Type is a PostgreSQL type
+// name: float8, float4, int8, int4, int2, bool, timestamp or timestamptz.
+// Columns that are not applied may have any type.
+type InputField struct {
+	Name string
+	Type string
+}
+
+// ParseInputField splits a "name:type" field description.
+func ParseInputField(value string) (InputField, error) {
+	idx := strings.LastIndex(value, ":")
+	if idx <= 0 || idx == len(value)-1 {
+		return InputField{}, fmt.Errorf("field %q must be written name:type", value)
+	}
+	return InputField{Name: strings.TrimSpace(value[:idx]), Type: strings.TrimSpace(value[idx+1:])}, nil
+}
@@ -0,0 +1,384 @@
+//go:build cgo
+
+package fmi
+
+import (
+	"bytes"
+	"compress/gzip"
+	"encoding/binary"
+	"math"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"reflect"
+	"sort"
+	"strconv"
+	"strings"
+	"testing"
+)
+
+// seriesFile describes a CSV of rows of time, power and an ignored note
+// column, with a blank line every 50000 rows.
+type seriesFile struct {
+	rows    int
+	newline string
+	// note returns the raw note field of row i; nil writes "ok".
+	note func(i int) string
+	// quoteEvery > 0 writes every quoteEvery-th power value in quotes.
+	quoteEvery int
+}
+
+// write writes the file to path and returns the times and powers the bridge
+// should read back.
+func (f seriesFile) write(t *testing.T, path string) (times, values []float64) {
+	t.Helper()
+	var b strings.Builder
+	b.WriteString(`time,"power",note` + f.newline)
+	for i := 0; i < f.rows; i++ {
+		time := float64(i) * 0.5
+		value := float64(i%997)*0.001 + float64(i)/7
+		times = append(times, time)
+		values = append(values, value)
+		power := strconv.FormatFloat(value, 'g', -1, 64)
+		if f.quoteEvery > 0 && i%f.quoteEvery == 0 {
+			power = `"` + power + `"`
+		}
+		note := "ok"
+		if f.note != nil {
+			note = f.note(i)
+		}
+		b.WriteString(strconv.FormatFloat(time, 'g', -1, 64) + "," + power + "," + note + f.newline)
+		if i%50000 == 49999 {
+			b.WriteString(f.newline)
+		}
+	}
+	if err := os.WriteFile(path, []byte(b.String()), 0o644); err != nil {
+		t.Fatalf("write %s: %v", path, err)
+	}
+	return times, values
+}
+
+// bridgeSeries reads the power column of path through the bridge's input
+// series loader.
+func bridgeSeries(t *testing.T, path string) (times, values []float64, err error) {
+	t.Helper()
+	return operatorSeries(t, InputSeriesConfig{
+		CSVPath: path,
+		Columns: map[string]string{"power": "power"},
+		Ignore:  []string{"note"},
+	})
+}
+
+// operatorSeries loads the single applied column of cfg by way of an identity
+// scale operator.
+func operatorSeries(t *testing.T, cfg InputSeriesConfig) (times, values []float64, err error) {
+	t.Helper()
+	result, err := RunOperator(OperatorConfig{Op: OperatorScale, Factor: 1, InputSeries: &cfg})
+	if err != nil {
+		return nil, nil, err
+	}
+	trace := result["trace"].(map[string]any)
+	for _, v := range trace["time"].([]any) {
+		times = append(times, v.(float64))
+	}
+	for _, v := range trace["signals"].(map[string]any)["value"].([]any) {
+		values = append(values, v.(float64))
+	}
+	return times, values, nil
+}
+
+func TestInputSeriesParsesChunkedLikeSerial(t *testing.T) {
+	dir := t.TempDir()
+	for name, newline := range map[string]string{"lf": "\n", "crlf": "\r\n"} {
+		t.Run(name, func(t *testing.T) {
+			// Large enough to be cut into three chunks when threads allow.
+			path := filepath.Join(dir, name+".csv")
+			wantTimes, wantValues := seriesFile{rows: 500000, newline: newline}.write(t, path)
+			for _, threads := range []string{"1", "3"} {
+				t.Setenv("CADS_PARSE_THREADS", threads)
+				times, values, err := bridgeSeries(t, path)
+				if err != nil {
+					t.Fatalf("threads %s: %v", threads, err)
+				}
+				if !reflect.DeepEqual(times, wantTimes) || !reflect.DeepEqual(values, wantValues) {
+					t.Fatalf("threads %s: read %d samples that differ from the %d written", threads, len(times), len(wantTimes))
+				}
+			}
+		})
+	}
+}
+
+func TestInputSeriesReportsChunkedErrorsLikeSerial(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "bad.csv")
+	seriesFile{rows: 500000, newline: "\n"}.write(t, path)
+	data, err := os.ReadFile(path)
+	if err != nil {
+		t.Fatalf("read %s: %v", path, err)
+	}
+	// Break a row in the second chunk.
+	bad := strings.Replace(string(data), "\n150000,", "\n150000,x", 1)
+	if err := os.WriteFile(path, []byte(bad), 0o644); err != nil {
+		t.Fatalf("write %s: %v", path, err)
+	}
+
+	var messages []string
+	for _, threads := range []string{"1", "3"} {
+		t.Setenv("CADS_PARSE_THREADS", threads)
+		if _, _, err := bridgeSeries(t, path); err == nil {
+			t.Fatalf("threads %s: error = nil, want the broken row reported", threads)
+		} else {
+			messages = append(messages, err.Error())
+		}
+	}
+	if messages[0] != messages[1] || !strings.Contains(messages[0], "line 300008 has a non-numeric value") {
+		t.Fatalf("errors = %q, want the same line reported by serial and chunked parsing", messages)
+	}
+}
+
+func TestInputSeriesScansQuotedFieldsLikeScalar(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "quoted.csv")
+	// Notes of every length from 0 to 70 bytes move the quoted commas across
+	// the 64-byte scan blocks and the chunk edges.
+	wantTimes, wantValues := seriesFile{
+		rows:       500000,
+		newline:    "\r\n",
+		quoteEvery: 3,
+		note: func(i int) string {
+			return `"north, ` + strings.Repeat("x", i%71) + ` ""A"", east"`
+		},
+	}.write(t, path)
+
+	for _, scan := range []string{"", "scalar"} {
+		for _, threads := range []string{"1", "3"} {
+			t.Setenv("CADS_CSV_SCAN", scan)
+			t.Setenv("CADS_PARSE_THREADS", threads)
+			times, values, err := bridgeSeries(t, path)
+			if err != nil {
+				t.Fatalf("scan %q, threads %s: %v", scan, threads, err)
+			}
+			if !reflect.DeepEqual(times, wantTimes) || !reflect.DeepEqual(values, wantValues) {
+				t.Fatalf("scan %q, threads %s: read %d samples that differ from the %d written", scan, threads, len(times), len(wantTimes))
+			}
+		}
+	}
+}
+
+func TestInputSeriesReadsCompressedInput(t *testing.T) {
+	dir := t.TempDir()
+	plain := filepath.Join(dir, "series.csv")
+	wantTimes, wantValues := seriesFile{rows: 500000, newline: "\n"}.write(t, plain)
+	data, err := os.ReadFile(plain)
+	if err != nil {
+		t.Fatalf("read %s: %v", plain, err)
+	}
+
+	// Two gzip members split mid-line, under a name that does not say gzip.
+	var compressed bytes.Buffer
+	half := len(data) / 2
+	for _, part := range [][]byte{data[:half], data[half:]} {
+		zw := gzip.NewWriter(&compressed)
+		if _, err := zw.Write(part); err != nil {
+			t.Fatalf("gzip: %v", err)
+		}
+		if err := zw.Close(); err != nil {
+			t.Fatalf("gzip: %v", err)
+		}
+	}
+	inputs := map[string][]byte{"series.dat": compressed.Bytes()}
+	if zstd, err := exec.LookPath("zstd"); err == nil {
+		out, err := exec.Command(zstd, "-q", "-c", plain).Output()
+		if err != nil {
+			t.Fatalf("zstd: %v", err)
+		}
+		inputs["series.csv.zst"] = out
+	}
+
+	for name, body := range inputs {
+		path := filepath.Join(dir, name)
+		if err := os.WriteFile(path, body, 0o644); err != nil {
+			t.Fatalf("write %s: %v", path, err)
+		}
+		times, values, err := bridgeSeries(t, path)
+		if err != nil {
+			t.Fatalf("%s: %v", name, err)
+		}
+		if !reflect.DeepEqual(times, wantTimes) || !reflect.DeepEqual(values, wantValues) {
+			t.Fatalf("%s: read %d samples that differ from the %d written", name, len(times), len(wantTimes))
+		}
+	}
+
+	truncated := filepath.Join(dir, "truncated.csv.gz")
+	if err := os.WriteFile(truncated, compressed.Bytes()[:compressed.Len()-100], 0o644); err != nil {
+		t.Fatalf("write %s: %v", truncated, err)
+	}
+	if _, _, err := bridgeSeries(t, truncated); err == nil {
+		t.Fatal("truncated gzip input: error = nil, want a failed step")
+	}
+}
+
+func TestInputSeriesDecodesBinaryCopyDump(t *testing.T) {
+	// testdata/measurements.pgcopy holds four rows of (ts timestamptz, power
+	// float8, temp float8) from 2026-01-01T00:00:00Z; temp is NULL in row 2.
+	fields := []InputField{{"ts", "timestamptz"}, {"power", "float8"}, {"temp", "float8"}}
+	times, values, err := operatorSeries(t, InputSeriesConfig{
+		CSVPath: filepath.Join("testdata", "measurements.pgcopy"),
+		Dialect: InputDialectPgCopy,
+		Fields:  fields,
+		Columns: map[string]string{"power": "power"},
+	})
+	if err != nil {
+		t.Fatalf("decode dump: %v", err)
+	}
+	if want := []float64{0, 60, 120.5, 3600.000001}; !reflect.DeepEqual(times, want) {
+		t.Fatalf("times = %v, want %v", times, want)
+	}
+	if want := []float64{1.5, -2.25, 1e10, 0.1}; !reflect.DeepEqual(values, want) {
+		t.Fatalf("values = %v, want %v", values, want)
+	}
+
+	_, _, err = operatorSeries(t, InputSeriesConfig{
+		CSVPath: filepath.Join("testdata", "measurements.pgcopy"),
+		Dialect: InputDialectPgCopy,
+		Fields:  fields,
+		Columns: map[string]string{"temp": "temp"},
+	})
+	if err == nil || !strings.Contains(err.Error(), "row 2 has a NULL 'temp'") {
+		t.Fatalf("decode temp error = %v, want the NULL reported", err)
+	}
+}
+
+func TestInputSeriesReadsAEExports(t *testing.T) {
+	// testdata/ae_ch2.csv is a trimmed CH2 export from
+	// data/ae_event_statistics/raw: its preamble, header and nine events over
+	// two days.
+	cfg := InputSeriesConfig{
+		CSVPath: filepath.Join("testdata", "ae_ch2.csv"),
+		Dialect: InputDialectAE,
+		Columns: map[string]string{"Amplitude": "amplitude"},
+	}
+	result, err := RunOperator(OperatorConfig{Op: OperatorScale, Factor: 1, InputSeries: &cfg})
+	if err != nil {
+		t.Fatalf("read AE export: %v", err)
+	}
+	metadata, _ := result["input_metadata"].(map[string]any)
+	if len(metadata) != 13 || metadata["Demonstrator"] != "LeCheylas" || metadata["Sensor sampling rate"] != "=1/1000000" {
+		t.Fatalf("input_metadata = %v, want the 13 preamble entries", metadata)
+	}
+
+	times, values, err := operatorSeries(t, cfg)
+	if err != nil {
+		t.Fatalf("read AE export: %v", err)
+	}
+	// " 4:22:12:35:527 071000" is day 4, 22:12:35.527071; times count from it.
+	wantTimes := []float64{0, 0.012, 0.024, 0.036, 0.048, 20008.7836076, 20008.7956076, 20008.8076076, 40018.2166675}
+	if len(times) != len(wantTimes) {
+		t.Fatalf("times = %v, want %v", times, wantTimes)
+	}
+	for i := range times {
+		if math.Abs(times[i]-wantTimes[i]) > 1e-9 {
+			t.Fatalf("times = %v, want %v", times, wantTimes)
+		}
+	}
+	if want := []float64{39.4, 39.1, 38.8, 40.3, 39.4, 29.5, 28.5, 28.5, 29.5}; !reflect.DeepEqual(values, want) {
+		t.Fatalf("values = %v, want %v", values, want)
+	}
+
+	// Hours, minutes and seconds past their range are not folded into the time.
+	data, err := os.ReadFile(cfg.CSVPath)
+	if err != nil {
+		t.Fatalf("read %s: %v", cfg.CSVPath, err)
+	}
+	for _, arrival := range []string{" 4:24:12:35:527 071000", " 4:22:60:35:527 071000", " 4:22:12:61:527 071000"} {
+		bad := filepath.Join(t.TempDir(), "bad.csv")
+		body := strings.Replace(string(data), " 4:22:12:35:539 071000", arrival, 1)
+		if err := os.WriteFile(bad, []byte(body), 0o644); err != nil {
+			t.Fatalf("write %s: %v", bad, err)
+		}
+		cfg.CSVPath = bad
+		if _, _, err := operatorSeries(t, cfg); err == nil || !strings.Contains(err.Error(), "invalid arrival time") {
+			t.Fatalf("arrival %q: error = %v, want it rejected", arrival, err)
+		}
+	}
+}
+
+func TestInputSeriesWindowReadsThroughValidIndexOnly(t *testing.T) {
+	// Files under the temporary directory are not indexed.
+	path := filepath.Join(t.TempDir(), "large.csv")
+	t.Setenv("TMPDIR", t.TempDir())
+	indexDir := t.TempDir()
+	t.Setenv("CADS_INDEX_DIR", indexDir)
+	// Over the 16 MiB a body needs before windows are read through the index.
+	allTimes, allValues := seriesFile{rows: 800000, newline: "\n"}.write(t, path)
+
+	start, stop := 123456.75, 234567.25
+	from := sort.SearchFloat64s(allTimes, start) - 1
+	to := sort.SearchFloat64s(allTimes, stop+0.25)
+	wantTimes, wantValues := allTimes[from:to], allValues[from:to]
+	window := func() ([]float64, []float64) {
+		t.Helper()
+		result, err := RunOperator(OperatorConfig{
+			Op:          OperatorScale,
+			Factor:      1,
+			InputSeries: &InputSeriesConfig{CSVPath: path, Columns: map[string]string{"power": "power"}, Ignore: []string{"note"}},
+			StartTime:   &start,
+			StopTime:    &stop,
+		})
+		if err != nil {
+			t.Fatalf("read window: %v", err)
+		}
+		trace := result["trace"].(map[string]any)
+		var times, values []float64
+		for _, v := range trace["time"].([]any) {
+			times = append(times, v.(float64))
+		}
+		for _, v := range trace["signals"].(map[string]any)["value"].([]any) {
+			values = append(values, v.(float64))
+		}
+		return times, values
+	}
+
+	times, values := window()
+	if !reflect.DeepEqual(times, wantTimes) || !reflect.DeepEqual(values, wantValues) {
+		t.Fatalf("window read %d samples that differ from the %d of a full parse", len(times), len(wantTimes))
+	}
+	indexes, _ := filepath.Glob(filepath.Join(indexDir, "*.cads-index"))
+	if len(indexes) != 1 {
+		t.Fatalf("index files = %v, want one", indexes)
+	}
+	built, err := os.ReadFile(indexes[0])
+	if err != nil {
+		t.Fatalf("read index: %v", err)
+	}
+
+	// Entries of 24 bytes (time, offset, line) follow a 56-byte header.
+	const header, entrySize = 56, 24
+	entries := (len(built) - header) / entrySize
+	for name, tamper := range map[string]func(index []byte){
+		"offset past the file": func(index []byte) {
+			binary.LittleEndian.PutUint64(index[header+(entries-1)*entrySize+8:], 1<<40)
+		},
+		"offset before the body": func(index []byte) {
+			binary.LittleEndian.PutUint64(index[header+8:], 0)
+		},
+		"lines out of order": func(index []byte) {
+			binary.LittleEndian.PutUint64(index[header+entrySize+16:], 1)
+		},
+		"times out of order": func(index []byte) {
+			binary.LittleEndian.PutUint64(index[header+2*entrySize:], math.Float64bits(-1))
+		},
+	} {
+		tampered := append([]byte(nil), built...)
+		tamper(tampered)
+		if err := os.WriteFile(indexes[0], tampered, 0o644); err != nil {
+			t.Fatalf("write index: %v", err)
+		}
+		times, values := window()
+		if !reflect.DeepEqual(times, wantTimes) || !reflect.DeepEqual(values, wantValues) {
+			t.Fatalf("%s: window read %d samples that differ from the %d of a full parse", name, len(times), len(wantTimes))
+		}
+		rebuilt, err := os.ReadFile(indexes[0])
+		if err != nil || !bytes.Equal(rebuilt, built) {
+			t.Fatalf("%s: index was used rather than rebuilt", name)
+		}
+	}
+}
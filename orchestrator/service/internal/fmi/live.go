@@ -0,0 +1,79 @@
+package fmi
+
+import (
+	"fmt"
+	"strings"
+)
+
+// LiveFormat selects how live input frames are encoded. The values mirror the
+// CADS_LIVE_FORMAT_* constants of the bridge.
+type LiveFormat int
+
+const (
+	// LiveFormatCSV frames are CSV lines, time first. The first line is the
+	// header unless Fields is set.
+	LiveFormatCSV LiveFormat = iota
+	// LiveFormatBinary frames are fixed records of little-endian float64s, one
+	// per entry of Fields.
+	LiveFormatBinary
+)
+
+// ParseLiveFormat maps "csv" or "binary" (case-insensitive) to a LiveFormat.
+// The empty string selects LiveFormatCSV.
+func ParseLiveFormat(value string) (LiveFormat, error) {
+	switch strings.ToLower(strings.TrimSpace(value)) {
+	case "", "csv":
+		return LiveFormatCSV, nil
+	case "binary":
+		return LiveFormatBinary, nil
+	default:
+		return LiveFormatCSV, fmt.Errorf("unknown live format %q (want csv or binary)", value)
+	}
+}
+
+// LiveGapPolicy selects what a live run does when samples are further apart
+// than MaxGap. The values mirror the CADS_LIVE_GAP_* constants of the bridge.
+type LiveGapPolicy int
+
+const (
+	// LiveGapStep steps through the gap at the configured step size.
+	LiveGapStep LiveGapPolicy = iota
+	// LiveGapJump covers the gap with a single step.
+	LiveGapJump
+	// LiveGapFail fails the run.
+	LiveGapFail
+)
+
+// ParseLiveGapPolicy maps "step", "jump" or "fail" (case-insensitive) to a
+// LiveGapPolicy. The empty string selects LiveGapStep.
+func ParseLiveGapPolicy(value string) (LiveGapPolicy, error) {
+	switch strings.ToLower(strings.TrimSpace(value)) {
+	case "", "step":
+		return LiveGapStep, nil
+	case "jump":
+		return LiveGapJump, nil
+	case "fail":
+		return LiveGapFail, nil
+	default:
+		return LiveGapStep, fmt.Errorf("unknown live gap policy %q (want step, jump or fail)", value)
+	}
+}
+
+// LiveConfig feeds a run from a FIFO, file or Unix socket instead of an input
+// series. Every sample steps the FMU up to its time and, when OutputPath is
+// set, one JSON line {"time":...,"values":{...}} is written there.
+type LiveConfig struct {
+	InputPath  string
+	OutputPath string
+	Format     LiveFormat
+	// Columns maps frame fields to FMU variables. When empty every field is
+	// applied under its name.
+	Columns map[string]string
+	// Fields names the fields of every frame, time first. Required for
+	// LiveFormatBinary; for CSV it replaces the header line.
+	Fields []string
+	// QueueDepth bounds the samples read ahead of the FMU; 0 selects 1024.
+	QueueDepth int
+	MaxGap     *float64
+	OnGap      LiveGapPolicy
+}
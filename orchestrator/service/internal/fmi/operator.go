@@ -0,0 +1,70 @@
+package fmi
+
+import (
+	"fmt"
+	"strings"
+)
+
+// Operator selects a built-in signal operator. The values mirror the
+// CADS_OP_* constants of the bridge.
+type Operator int
+
+const (
+	// OperatorScale computes value*Factor + Offset.
+	OperatorScale Operator = iota
+	// OperatorThreshold yields 1 where value >= Level and 0 elsewhere.
+	OperatorThreshold
+	// OperatorRollingMean averages the samples in the trailing Window.
+	OperatorRollingMean
+	// OperatorRollingQuantile takes Quantile of the samples in the trailing
+	// Window.
+	OperatorRollingQuantile
+	// OperatorResample samples the signal every Interval from its first time.
+	OperatorResample
+	// OperatorQuantile reduces the whole signal to its Quantile.
+	OperatorQuantile
+)
+
+var operatorNames = map[string]Operator{
+	"scale":            OperatorScale,
+	"threshold":        OperatorThreshold,
+	"rolling_mean":     OperatorRollingMean,
+	"rolling_quantile": OperatorRollingQuantile,
+	"resample":         OperatorResample,
+	"quantile":         OperatorQuantile,
+}
+
+// ParseOperator maps an operator name such as "rolling_mean"
+// (case-insensitive) to an Operator.
+func ParseOperator(value string) (Operator, error) {
+	op, ok := operatorNames[strings.ToLower(strings.TrimSpace(value))]
+	if !ok {
+		return OperatorScale, fmt.Errorf("unknown operator %q (want scale, threshold, rolling_mean, rolling_quantile, resample or quantile)", value)
+	}
+	return op, nil
+}
+
+// OperatorConfig describes one operator run over a single signal, given either
+// as Times/Values or as an InputSeries that applies exactly one column.
+type OperatorConfig struct {
+	Op          Operator
+	Times       []float64
+	Values      []float64
+	InputSeries *InputSeriesConfig
+	// StartTime and StopTime, set together and only with InputSeries, limit it
+	// to the rows a run over that span observes: the last row at or before
+	// StartTime and those up to StopTime. Large files are then read through
+	// their sparse index instead of being parsed in full.
+	StartTime *float64
+	StopTime  *float64
+	// Window is the trailing window in seconds of the rolling operators.
+	Window float64
+	// Interval is the grid spacing of OperatorResample, which interpolates
+	// Times/Values linearly and an InputSeries by its own Interpolation.
+	Interval float64
+	// Quantile is in [0, 1].
+	Quantile float64
+	Factor   float64
+	Offset   float64
+	Level    float64
+}
@@ -0,0 +1,164 @@
+//go:build cgo
+
+package fmi
+
+import (
+	"math"
+	"os"
+	"path/filepath"
+	"reflect"
+	"strings"
+	"testing"
+)
+
+func TestRollingMeanSkipsMissingSamples(t *testing.T) {
+	nan := math.NaN()
+	result, err := RunOperator(OperatorConfig{
+		Op:     OperatorRollingMean,
+		Times:  []float64{0, 1, 2, 3, 4, 5},
+		Values: []float64{1e16, nan, 1, 3, nan, nan},
+		Window: 2,
+	})
+	if err != nil {
+		t.Fatalf("rolling mean: %v", err)
+	}
+	// Windows are (t-2, t]. The one at t=5 has no value left, and 1e16 leaving
+	// the window at t=2 takes no precision with it.
+	want := []any{1e16, 1e16, 1.0, 2.0, 3.0, nil}
+	if got := result["trace"].(map[string]any)["signals"].(map[string]any)["value"]; !reflect.DeepEqual(got, want) {
+		t.Fatalf("rolling mean = %v, want %v", got, want)
+	}
+}
+
+func TestResampleRejectsTooManyPoints(t *testing.T) {
+	_, err := RunOperator(OperatorConfig{
+		Op:       OperatorResample,
+		Times:    []float64{0, 1e9},
+		Values:   []float64{0, 1},
+		Interval: 1e-3,
+	})
+	if err == nil || !strings.Contains(err.Error(), "more than 10000000 points") {
+		t.Fatalf("resample error = %v, want the point limit reported", err)
+	}
+}
+
+// operatorValues returns the traced "value" signal of an operator result.
+func operatorValues(t *testing.T, result map[string]any) []any {
+	t.Helper()
+	trace, ok := result["trace"].(map[string]any)
+	if !ok {
+		t.Fatalf("operator result %v has no trace", result)
+	}
+	return trace["signals"].(map[string]any)["value"].([]any)
+}
+
+func TestThresholdMarksValuesAtOrAboveLevel(t *testing.T) {
+	result, err := RunOperator(OperatorConfig{
+		Op:     OperatorThreshold,
+		Times:  []float64{0, 1, 2, 3},
+		Values: []float64{0.5, 1, 1.5, math.NaN()},
+		Level:  1,
+	})
+	if err != nil {
+		t.Fatalf("threshold: %v", err)
+	}
+	// A sample without a value is below any level.
+	want := []any{0.0, 1.0, 1.0, 0.0}
+	if got := operatorValues(t, result); !reflect.DeepEqual(got, want) {
+		t.Fatalf("threshold = %v, want %v", got, want)
+	}
+	if result["value"] != 0.0 {
+		t.Fatalf("threshold value = %v, want 0", result["value"])
+	}
+}
+
+func TestRollingQuantileTracksTheWindow(t *testing.T) {
+	cfg := OperatorConfig{
+		Op:       OperatorRollingQuantile,
+		Times:    []float64{0, 1, 2, 3, 4},
+		Values:   []float64{5, 1, 4, 2, 3},
+		Window:   3,
+		Quantile: 0.5,
+	}
+	result, err := RunOperator(cfg)
+	if err != nil {
+		t.Fatalf("rolling quantile: %v", err)
+	}
+	// Windows are (t-3, t]; the median of two samples is their midpoint.
+	want := []any{5.0, 3.0, 4.0, 2.0, 3.0}
+	if got := operatorValues(t, result); !reflect.DeepEqual(got, want) {
+		t.Fatalf("rolling quantile = %v, want %v", got, want)
+	}
+
+	cfg.Values = []float64{5, math.NaN(), 4, 2, 3}
+	if _, err := RunOperator(cfg); err == nil || !strings.Contains(err.Error(), "no value at t=1") {
+		t.Fatalf("rolling quantile error = %v, want the missing sample reported", err)
+	}
+}
+
+func TestQuantileInterpolatesBetweenRanks(t *testing.T) {
+	for _, tc := range []struct {
+		quantile float64
+		want     float64
+	}{
+		{0, 1},
+		{0.25, 1.75},
+		{0.5, 2.5},
+		{1, 4},
+	} {
+		result, err := RunOperator(OperatorConfig{
+			Op:       OperatorQuantile,
+			Times:    []float64{0, 1, 2, 3},
+			Values:   []float64{4, 1, 3, 2},
+			Quantile: tc.quantile,
+		})
+		if err != nil {
+			t.Fatalf("quantile %v: %v", tc.quantile, err)
+		}
+		if result["value"] != tc.want {
+			t.Fatalf("quantile %v = %v, want %v", tc.quantile, result["value"], tc.want)
+		}
+		if _, ok := result["trace"]; ok {
+			t.Fatalf("quantile %v result carries a trace", tc.quantile)
+		}
+	}
+}
+
+func TestResampleHoldsOrInterpolates(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "series.csv")
+	if err := os.WriteFile(path, []byte("time,power\n0,0\n2,4\n3,10\n"), 0o644); err != nil {
+		t.Fatalf("write series: %v", err)
+	}
+	columns := map[string]string{"power": "power"}
+	linear := []any{0.0, 2.0, 4.0, 10.0}
+	for _, tc := range []struct {
+		name string
+		cfg  OperatorConfig
+		want []any
+	}{
+		{"source", OperatorConfig{Times: []float64{0, 2, 3}, Values: []float64{0, 4, 10}}, linear},
+		{"held series", OperatorConfig{InputSeries: &InputSeriesConfig{
+			CSVPath: path,
+			Columns: columns,
+		}}, []any{0.0, 0.0, 4.0, 10.0}},
+		{"linear series", OperatorConfig{InputSeries: &InputSeriesConfig{
+			CSVPath:       path,
+			Columns:       columns,
+			Interpolation: InputInterpolationLinear,
+		}}, linear},
+	} {
+		tc.cfg.Op = OperatorResample
+		tc.cfg.Interval = 1
+		result, err := RunOperator(tc.cfg)
+		if err != nil {
+			t.Fatalf("resample %s: %v", tc.name, err)
+		}
+		if got := operatorValues(t, result); !reflect.DeepEqual(got, tc.want) {
+			t.Fatalf("resample %s = %v, want %v", tc.name, got, tc.want)
+		}
+		times := result["trace"].(map[string]any)["time"]
+		if want := []any{0.0, 1.0, 2.0, 3.0}; !reflect.DeepEqual(times, want) {
+			t.Fatalf("resample %s times = %v, want %v", tc.name, times, want)
+		}
+	}
+}
@@ -0,0 +1,86 @@
+package fmi
+
+import (
+	"fmt"
+	"strings"
+	"sync"
+)
+
+// Priority selects the scheduling class of a run. The values mirror the
+// CADS_PRIORITY_* constants of the bridge.
+type Priority int
+
+const (
+	// PriorityInteractive runs are never paused and make batch runs yield.
+	PriorityInteractive Priority = iota
+	// PriorityBatch runs pause at communication-step boundaries while
+	// interactive work is running or queued.
+	PriorityBatch
+)
+
+// ParsePriority maps "interactive" or "batch" (case-insensitive) to a Priority.
+// The empty string selects PriorityInteractive.
+func ParsePriority(value string) (Priority, error) {
+	switch strings.ToLower(strings.TrimSpace(value)) {
+	case "", "interactive":
+		return PriorityInteractive, nil
+	case "batch":
+		return PriorityBatch, nil
+	default:
+		return PriorityInteractive, fmt.Errorf("unknown priority %q (want interactive or batch)", value)
+	}
+}
+
+func (p Priority) String() string {
+	switch p {
+	case PriorityInteractive:
+		return "interactive"
+	case PriorityBatch:
+		return "batch"
+	default:
+		return fmt.Sprintf("Priority(%d)", int(p))
+	}
+}
+
+// holdCounter mirrors the bridge's priority gate on the Go side. The bridge
+// gate only pauses batch runs inside this process; isolated worker and zygote
+// runs are separate processes, so batch runs wait here before being handed to
+// one while interactive work holds the gate.
+type holdCounter struct {
+	mu    sync.Mutex
+	holds int
+	// clear is closed when holds drops back to zero.
+	clear chan struct{}
+}
+
+var interactiveHolds holdCounter
+
+func (h *holdCounter) hold() {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	if h.holds == 0 {
+		h.clear = make(chan struct{})
+	}
+	h.holds++
+}
+
+func (h *holdCounter) release() {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	h.holds--
+	if h.holds == 0 {
+		close(h.clear)
+	}
+}
+
+// wait blocks until no interactive hold is active.
+func (h *holdCounter) wait() {
+	h.mu.Lock()
+	if h.holds == 0 {
+		h.mu.Unlock()
+		return
+	}
+	clear := h.clear
+	h.mu.Unlock()
+	<-clear
+}
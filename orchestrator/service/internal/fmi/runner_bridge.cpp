@@ -11,27 +11,59 @@
 #include <FMI3/fmi3_import_variable_list.h>
 #include <JM/jm_callbacks.h>
 
-#include <unistd.h>
 #include <dlfcn.h>
+#ifdef __linux__
+#include <elf.h>
+#endif
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <zstd.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CADS_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define CADS_X86_SIMD 0
+#endif
 
 #include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <cctype>
+#include <cerrno>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstdarg>
 #include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <iterator>
 #include <limits>
+#include <list>
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <queue>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -42,13 +74,41 @@ struct Assignment {
     std::string value;
 };
 
-struct NumericAssignment {
+// A start value of any CADS_VALUE_* type. Text start values are parsed into
+// reals when the config is read.
+struct StartValue {
     std::string name;
-    double value{};
+    int type{CADS_VALUE_REAL};
+    double real{0.0};
+    long long integer{0};
+    bool boolean{false};
+    std::string text;
 };
 
 struct InputSeriesConfig {
     std::string csvPath;
+    int dialect{CADS_INPUT_DIALECT_PLAIN};
+    // CSV column -> FMU variable. Empty applies every column under its own name.
+    std::vector<Assignment> columns;
+    // Columns never applied or converted.
+    std::vector<std::string> ignore;
+    int interpolation{CADS_INPUT_INTERPOLATION_HOLD};
+    // Name -> PostgreSQL type of every field of a binary COPY dump, in order.
+    std::vector<Assignment> fields;
+};
+
+// Samples read from a FIFO or Unix socket while the run is in progress.
+struct LiveConfig {
+    std::string inputPath;
+    // Empty when outputs are only returned at the end.
+    std::string outputPath;
+    int format{CADS_LIVE_FORMAT_CSV};
+    std::vector<Assignment> columns;
+    // Record layout of binary frames; replaces the header line of CSV frames.
+    std::vector<std::string> fields;
+    size_t queueDepth{1024};
+    std::optional<double> maxGap;
+    int gapPolicy{CADS_LIVE_GAP_STEP};
 };
 
 struct TraceConfig {
@@ -66,10 +126,18 @@ struct Config {
     std::optional<double> startTime;
     std::optional<double> stopTime;
     std::optional<double> stepSize;
-    std::vector<Assignment> startValues;
+    std::vector<StartValue> startValues;
     std::vector<std::string> outputs;
-    std::optional<InputSeriesConfig> inputSeries;
+    // Sorted, without duplicates.
+    std::vector<double> outputsAt;
+    std::vector<InputSeriesConfig> inputSeries;
+    std::optional<LiveConfig> live;
     TraceConfig trace;
+    bool allowIsolation{false};
+    int priority{CADS_PRIORITY_INTERACTIVE};
+    std::optional<double> wallBudget;
+    bool coalesceSteps{false};
+    std::optional<double> maxStep;
 };
 
 struct OutputValue {
@@ -86,29 +154,152 @@ struct FmuExecutionResult {
     std::map<std::string, OutputValue> values;
     std::vector<double> traceTimes;
     std::map<std::string, std::vector<OutputValue>> traceSignals;
+    std::vector<double> snapshotTimes;
+    std::map<std::string, std::vector<OutputValue>> snapshotValues;
+    bool budgeted{false};
+    bool partial{false};
+    double reachedTime{};
+    std::map<std::string, std::string> inputMetadata;
+    // Communication step used when coalesce_steps widened it.
+    std::optional<double> coalescedStep;
+    struct LiveStats {
+        size_t samples{0};
+        // Samples older than the current simulation time, dropped.
+        size_t late{0};
+        // CSV lines that could not be parsed, dropped.
+        size_t malformed{0};
+        size_t gaps{0};
+        double maxLatencyMs{0.0};
+    };
+    std::optional<LiveStats> live;
 };
 
-void preloadLibPythonIfAvailable() {
-    static std::once_flag once;
-    std::call_once(once, [] {
-        auto tryLoad = [](const char* candidate) -> bool {
-            if (!candidate || candidate[0] == '\0') {
-                return false;
+// Wall-clock budget of one run, measured from the moment the bridge picks the
+// run up. Step loops check it at every communication point. Budgets of
+// kUnboundedWallBudget seconds or more (about 31 years), and NaN, are kept
+// without a deadline: converting them to steady_clock ticks would overflow.
+constexpr double kUnboundedWallBudget = 1e9;
+
+class WallBudget {
+public:
+    explicit WallBudget(const std::optional<double>& seconds) : enabled_(seconds.has_value()) {
+        if (seconds && *seconds < kUnboundedWallBudget) {
+            deadline_ = std::chrono::steady_clock::now() +
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                            std::chrono::duration<double>(*seconds));
+        }
+    }
+
+    bool enabled() const {
+        return enabled_;
+    }
+
+    bool exhausted() const {
+        return deadline_ && std::chrono::steady_clock::now() >= *deadline_;
+    }
+
+    const std::optional<std::chrono::steady_clock::time_point>& deadline() const {
+        return deadline_;
+    }
+
+private:
+    bool enabled_;
+    std::optional<std::chrono::steady_clock::time_point> deadline_;
+};
+
+// Name of the libpython an ELF shared object lists in its DT_NEEDED entries,
+// or "" when it lists none or the file is not a 64-bit ELF object.
+std::string neededLibPython(const std::string& path) {
+#ifdef __linux__
+    std::ifstream in(path, std::ios::binary);
+    std::vector<char> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    auto fits = [&image](std::uint64_t offset, std::uint64_t size) {
+        return offset <= image.size() && size <= image.size() - offset;
+    };
+    if (!fits(0, sizeof(Elf64_Ehdr)) || std::memcmp(image.data(), ELFMAG, SELFMAG) != 0 ||
+        image[EI_CLASS] != ELFCLASS64) {
+        return "";
+    }
+    Elf64_Ehdr header;
+    std::memcpy(&header, image.data(), sizeof(header));
+    if (header.e_shentsize != sizeof(Elf64_Shdr) ||
+        !fits(header.e_shoff, std::uint64_t{header.e_shnum} * sizeof(Elf64_Shdr))) {
+        return "";
+    }
+    auto section = [&](size_t index) {
+        Elf64_Shdr shdr;
+        std::memcpy(&shdr, image.data() + header.e_shoff + index * sizeof(Elf64_Shdr), sizeof(shdr));
+        return shdr;
+    };
+    for (size_t i = 0; i < header.e_shnum; ++i) {
+        const Elf64_Shdr dynamic = section(i);
+        if (dynamic.sh_type != SHT_DYNAMIC || dynamic.sh_link >= header.e_shnum) {
+            continue;
+        }
+        const Elf64_Shdr strings = section(dynamic.sh_link);
+        if (!fits(dynamic.sh_offset, dynamic.sh_size) || !fits(strings.sh_offset, strings.sh_size)) {
+            return "";
+        }
+        for (std::uint64_t at = 0; at + sizeof(Elf64_Dyn) <= dynamic.sh_size; at += sizeof(Elf64_Dyn)) {
+            Elf64_Dyn entry;
+            std::memcpy(&entry, image.data() + dynamic.sh_offset + at, sizeof(entry));
+            if (entry.d_tag == DT_NULL) {
+                break;
             }
-            void* handle = dlopen(candidate, RTLD_NOW | RTLD_GLOBAL);
-            if (handle) {
-                static std::vector<void*> loadedHandles;
-                loadedHandles.push_back(handle);
-                return true;
+            if (entry.d_tag != DT_NEEDED || entry.d_un.d_val >= strings.sh_size) {
+                continue;
             }
-            return false;
-        };
+            const char* name = image.data() + strings.sh_offset + entry.d_un.d_val;
+            const std::string needed(name, strnlen(name, strings.sh_size - entry.d_un.d_val));
+            if (needed.rfind("libpython3", 0) == 0) {
+                return needed;
+            }
+        }
+    }
+#else
+    (void)path;
+#endif
+    return "";
+}
 
-        const char* envHint = std::getenv("CADS_LIBPYTHON_HINT");
-        if (tryLoad(envHint)) {
-            return;
+// libpython the binary of a pythonfmu FMU links against, looked up in every
+// platform directory under binaries/; "" when none names one.
+std::string libPythonForFmu(const std::string& unpackDir, const std::string& modelIdentifier) {
+    std::error_code ec;
+    for (const auto& platform : fs::directory_iterator(fs::path(unpackDir) / "binaries", ec)) {
+        const std::string needed = neededLibPython((platform.path() / (modelIdentifier + ".so")).string());
+        if (!needed.empty()) {
+            return needed;
+        }
+    }
+    return "";
+}
+
+// Loads libpython with RTLD_GLOBAL so extension modules imported by pythonfmu
+// slaves (numpy and friends) resolve the interpreter's symbols. soname is the
+// library the FMU binary links against; when it is empty CADS_LIBPYTHON_HINT
+// and then the usual versions are tried. Each library is loaded once per
+// process. Returns nullptr when nothing could be loaded.
+void* loadLibPython(const std::string& soname) {
+    static std::mutex mu;
+    static std::map<std::string, void*> loaded;
+    std::lock_guard<std::mutex> guard(mu);
+    auto found = loaded.find(soname);
+    if (found != loaded.end()) {
+        return found->second;
+    }
+    auto tryLoad = [](const char* candidate) -> void* {
+        if (!candidate || candidate[0] == '\0') {
+            return nullptr;
         }
+        return dlopen(candidate, RTLD_NOW | RTLD_GLOBAL);
+    };
 
+    void* handle = nullptr;
+    if (!soname.empty()) {
+        handle = tryLoad(soname.c_str());
+    } else {
+        handle = tryLoad(std::getenv("CADS_LIBPYTHON_HINT"));
         constexpr const char* kDefaultCandidates[] = {
             "libpython3.12.so.1.0",
             "libpython3.12.so",
@@ -118,11 +309,14 @@ void preloadLibPythonIfAvailable() {
             "libpython3.10.so",
         };
         for (const char* candidate : kDefaultCandidates) {
-            if (tryLoad(candidate)) {
-                return;
+            if (handle) {
+                break;
             }
+            handle = tryLoad(candidate);
         }
-    });
+    }
+    loaded.emplace(soname, handle);
+    return handle;
 }
 
 void fmi2LoggerCallback(
@@ -146,6 +340,190 @@ void fmi2LoggerCallback(
     throw std::runtime_error(msg);
 }
 
+// Thrown when a non-reentrant FMU is already running in this process and the
+// caller allowed the run to be retried in an isolated worker process.
+struct IsolationRequired : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// Concurrency-relevant facts read from the model description before the FMU
+// binaries are loaded.
+struct FmuCapabilities {
+    std::string modelIdentifier;
+    std::string token;
+    bool onlyOncePerProcess{false};
+    bool pythonFmu{false};
+
+    // pythonfmu slaves share the process-wide CPython interpreter, whose lazy
+    // initialization inside the exporter is not safe against concurrent
+    // instantiation, so they are treated like single-instance FMUs.
+    bool reentrant() const {
+        return !onlyOncePerProcess && !pythonFmu;
+    }
+
+    std::string admissionKey() const {
+        if (pythonFmu) {
+            return "pythonfmu-interpreter";
+        }
+        return modelIdentifier + "#" + token;
+    }
+};
+
+bool looksLikePythonFmu(const char* generationTool, const std::string& unpackDir) {
+    if (generationTool) {
+        std::string tool(generationTool);
+        std::transform(tool.begin(), tool.end(), tool.begin(), [](unsigned char ch) {
+            return static_cast<char>(std::tolower(ch));
+        });
+        if (tool.find("pythonfmu") != std::string::npos) {
+            return true;
+        }
+    }
+    std::error_code ec;
+    return fs::exists(fs::path(unpackDir) / "resources" / "slavemodule.txt", ec);
+}
+
+// Loads the libpython a pythonfmu FMU was built against before its binary is
+// loaded; other FMUs never pull Python into the process.
+void preparePythonFmu(const FmuCapabilities& caps, const std::string& unpackDir) {
+    if (caps.pythonFmu) {
+        loadLibPython(libPythonForFmu(unpackDir, caps.modelIdentifier));
+    }
+}
+
+// Per-FMU admission slots shared by all concurrent cads_run_fmu calls. Reentrant
+// FMUs bypass the registry; the others hold their slot from binary load until
+// the instance is destroyed. Slots are flags rather than mutexes because an
+// interleaving batch worker may probe a slot it already holds on the same thread.
+class AdmissionRegistry;
+
+class AdmissionTicket {
+public:
+    AdmissionTicket() = default;
+    AdmissionTicket(AdmissionRegistry* registry, std::string key) : registry_(registry), key_(std::move(key)) {}
+    AdmissionTicket(AdmissionTicket&& other) noexcept
+        : registry_(std::exchange(other.registry_, nullptr)), key_(std::move(other.key_)) {}
+    AdmissionTicket& operator=(AdmissionTicket&& other) noexcept {
+        if (this != &other) {
+            reset();
+            registry_ = std::exchange(other.registry_, nullptr);
+            key_ = std::move(other.key_);
+        }
+        return *this;
+    }
+    ~AdmissionTicket() {
+        reset();
+    }
+
+private:
+    void reset();
+
+    AdmissionRegistry* registry_{nullptr};
+    std::string key_;
+};
+
+class AdmissionRegistry {
+public:
+    static AdmissionRegistry& instance() {
+        static AdmissionRegistry registry;
+        return registry;
+    }
+
+    AdmissionTicket admit(const FmuCapabilities& caps, bool allowIsolation) {
+        if (caps.reentrant()) {
+            return {};
+        }
+        std::string key = caps.admissionKey();
+        const std::thread::id self = std::this_thread::get_id();
+        std::unique_lock<std::mutex> lock(mu_);
+        // A thread that already holds a slot must not wait for another: an
+        // interleaving batch worker would wait on itself, or on a worker
+        // waiting for it. The run is handed back for an isolated worker instead.
+        const bool holdsSlot = std::any_of(busy_.begin(), busy_.end(), [&](const auto& entry) {
+            return entry.second == self;
+        });
+        if (busy_.count(key) && (allowIsolation || holdsSlot)) {
+            throw IsolationRequired("FMU '" + caps.modelIdentifier + "' is not reentrant and already running in this process");
+        }
+        cv_.wait(lock, [&] { return busy_.count(key) == 0; });
+        busy_.emplace(key, self);
+        return AdmissionTicket(this, std::move(key));
+    }
+
+    void release(const std::string& key) {
+        {
+            std::lock_guard<std::mutex> guard(mu_);
+            busy_.erase(key);
+        }
+        cv_.notify_all();
+    }
+
+private:
+    std::mutex mu_;
+    std::condition_variable cv_;
+    // Held slots and the thread that admitted each.
+    std::map<std::string, std::thread::id> busy_;
+};
+
+void AdmissionTicket::reset() {
+    if (registry_) {
+        registry_->release(key_);
+        registry_ = nullptr;
+    }
+}
+
+// Process-wide count of running or queued interactive work. Batch step loops
+// poll it once per communication step and park until it drops back to zero.
+class PriorityGate {
+public:
+    static PriorityGate& instance() {
+        static PriorityGate gate;
+        return gate;
+    }
+
+    void hold() {
+        pending_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    void release() {
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> guard(mu_);
+            cv_.notify_all();
+        }
+    }
+
+    void yieldIfPressured() {
+        if (pending_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this] { return pending_.load(std::memory_order_acquire) == 0; });
+    }
+
+private:
+    std::atomic<int> pending_{0};
+    std::mutex mu_;
+    std::condition_variable cv_;
+};
+
+struct ScopedPriorityHold {
+    bool active;
+    explicit ScopedPriorityHold(bool enable) : active(enable) {
+        if (active) {
+            PriorityGate::instance().hold();
+        }
+    }
+    ~ScopedPriorityHold() {
+        if (active) {
+            PriorityGate::instance().release();
+        }
+    }
+};
+
+std::string nonNull(const char* value) {
+    return value ? value : "";
+}
+
 double parseNumber(const std::string& input) {
     char* end = nullptr;
     double val = std::strtod(input.c_str(), &end);
@@ -155,6 +533,73 @@ double parseNumber(const std::string& input) {
     return val;
 }
 
+// Start values read as the type of the variable they set.
+double startReal(const StartValue& start) {
+    switch (start.type) {
+        case CADS_VALUE_INTEGER:
+            return static_cast<double>(start.integer);
+        case CADS_VALUE_BOOLEAN:
+            return start.boolean ? 1.0 : 0.0;
+        case CADS_VALUE_STRING:
+            fail("Start value " + start.name + " is a string but the variable is not");
+        default:
+            return start.real;
+    }
+}
+
+template <class Int>
+Int startInteger(const StartValue& start) {
+    const long long value = start.type == CADS_VALUE_INTEGER ? start.integer : std::llround(startReal(start));
+    if (value < static_cast<long long>(std::numeric_limits<Int>::min()) ||
+        value > static_cast<long long>(std::numeric_limits<Int>::max())) {
+        fail("Start value " + start.name + " is out of range for an integer variable");
+    }
+    return static_cast<Int>(value);
+}
+
+const char* startText(const StartValue& start) {
+    if (start.type != CADS_VALUE_STRING) {
+        fail("Start value " + start.name + " is not a string but the variable is");
+    }
+    return start.text.c_str();
+}
+
+// Parses the numeric CSV field [begin, end) in place; surrounding whitespace
+// and one pair of double quotes are ignored and the field must hold nothing
+// else. The range need not be NUL-terminated, so the strtod fallback for
+// standard libraries without floating-point from_chars copies the field first.
+bool parseNumberField(const char* begin, const char* end, double& value) {
+    auto trim = [&] {
+        while (begin < end && std::isspace(static_cast<unsigned char>(*begin))) {
+            ++begin;
+        }
+        while (end > begin && std::isspace(static_cast<unsigned char>(end[-1]))) {
+            --end;
+        }
+    };
+    trim();
+    if (end - begin >= 2 && *begin == '"' && end[-1] == '"') {
+        ++begin;
+        --end;
+        trim();
+    }
+    if (begin < end && *begin == '+') {
+        ++begin;
+    }
+    if (begin == end) {
+        return false;
+    }
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    std::from_chars_result parsed = std::from_chars(begin, end, value);
+    return parsed.ec == std::errc() && parsed.ptr == end && std::isfinite(value);
+#else
+    std::string field(begin, end);
+    char* stop = nullptr;
+    value = std::strtod(field.c_str(), &stop);
+    return stop == field.c_str() + field.size() && std::isfinite(value);
+#endif
+}
+
 std::string trimCopy(const std::string& input) {
     size_t start = 0;
     while (start < input.size() && std::isspace(static_cast<unsigned char>(input[start]))) {
@@ -167,21 +612,185 @@ std::string trimCopy(const std::string& input) {
     return input.substr(start, stop - start);
 }
 
+// Splits a CSV line at the commas outside double quotes. Quoted fields lose
+// their quotes, and "" inside them reads as one quote.
 std::vector<std::string> splitCsvLine(const std::string& line) {
     std::vector<std::string> fields;
-    std::string current;
-    for (char ch : line) {
-        if (ch == ',') {
-            fields.push_back(trimCopy(current));
-            current.clear();
+    std::string field;
+    bool inQuote = false;
+    bool quoted = false;
+    for (size_t i = 0; i <= line.size(); ++i) {
+        if (i == line.size() || (line[i] == ',' && !inQuote)) {
+            fields.push_back(quoted ? field : trimCopy(field));
+            field.clear();
+            quoted = false;
             continue;
         }
-        current.push_back(ch);
+        const char ch = line[i];
+        if (ch == '"' && inQuote && i + 1 < line.size() && line[i + 1] == '"') {
+            field += '"';
+            ++i;
+        } else if (ch == '"' && (inQuote || trimCopy(field).empty())) {
+            inQuote = !inQuote;
+            if (inQuote) {
+                field.clear();
+                quoted = true;
+            }
+        } else if (!quoted || inQuote) {
+            field += ch;
+        }
     }
-    fields.push_back(trimCopy(current));
     return fields;
 }
 
+// Bit i of structural is set when block[i] is ',' or '\n', and bit i of
+// quotes when it is '"'.
+struct BlockMasks {
+    std::uint64_t structural;
+    std::uint64_t quotes;
+};
+
+// Implementations read exactly 64 bytes.
+using StructuralMaskFn = BlockMasks (*)(const char* block);
+
+BlockMasks structuralMaskScalar(const char* block) {
+    BlockMasks masks{0, 0};
+    for (int i = 0; i < 64; ++i) {
+        if (block[i] == ',' || block[i] == '\n') {
+            masks.structural |= std::uint64_t{1} << i;
+        } else if (block[i] == '"') {
+            masks.quotes |= std::uint64_t{1} << i;
+        }
+    }
+    return masks;
+}
+
+#if CADS_X86_SIMD
+__attribute__((target("sse2"))) BlockMasks structuralMaskSse2(const char* block) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i quote = _mm_set1_epi8('"');
+    BlockMasks masks{0, 0};
+    for (int i = 0; i < 4; ++i) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(bytes, comma), _mm_cmpeq_epi8(bytes, newline));
+        masks.structural |= std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(hits))} << (16 * i);
+        masks.quotes |= std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quote)))}
+                        << (16 * i);
+    }
+    return masks;
+}
+
+__attribute__((target("avx2"))) BlockMasks structuralMaskAvx2(const char* block) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i quote = _mm256_set1_epi8('"');
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    __m256i lowHits = _mm256_or_si256(_mm256_cmpeq_epi8(low, comma), _mm256_cmpeq_epi8(low, newline));
+    __m256i highHits = _mm256_or_si256(_mm256_cmpeq_epi8(high, comma), _mm256_cmpeq_epi8(high, newline));
+    return BlockMasks{
+        std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(lowHits))} |
+            (std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(highHits))} << 32),
+        std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, quote)))} |
+            (std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, quote)))} << 32),
+    };
+}
+#endif
+
+// CADS_CSV_SCAN=scalar forces the portable kernel, so it can be checked
+// against the vector ones on the same input.
+StructuralMaskFn structuralMask() {
+    static const StructuralMaskFn best = [] {
+#if CADS_X86_SIMD
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return &structuralMaskAvx2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return &structuralMaskSse2;
+        }
+#endif
+        return &structuralMaskScalar;
+    }();
+    const char* forced = std::getenv("CADS_CSV_SCAN");
+    if (forced && std::strcmp(forced, "scalar") == 0) {
+        return &structuralMaskScalar;
+    }
+    return best;
+}
+
+// Walks the ',' and '\n' positions of [begin, end) one 64-byte block at a
+// time using the best mask kernel the CPU supports. Never reads past end.
+// Commas inside double-quoted fields are skipped. Quoted fields cannot span
+// lines: a newline always ends the row.
+class StructuralScanner {
+public:
+    StructuralScanner(const char* begin, const char* end) : kernel_(structuralMask()), block_(begin), end_(end) {
+        load();
+    }
+
+    // Position of the next ',' or '\n', or end when there is none left.
+    const char* next() {
+        while (mask_ == 0) {
+            if (end_ - block_ <= 64) {
+                block_ = end_;
+                return end_;
+            }
+            block_ += 64;
+            load();
+        }
+        int offset = __builtin_ctzll(mask_);
+        mask_ &= mask_ - 1;
+        return block_ + offset;
+    }
+
+private:
+    void load() {
+        BlockMasks masks{0, 0};
+        if (end_ - block_ >= 64) {
+            masks = kernel_(block_);
+        } else {
+            for (const char* p = block_; p < end_; ++p) {
+                if (*p == ',' || *p == '\n') {
+                    masks.structural |= std::uint64_t{1} << (p - block_);
+                } else if (*p == '"') {
+                    masks.quotes |= std::uint64_t{1} << (p - block_);
+                }
+            }
+        }
+        mask_ = unquoted(masks);
+    }
+
+    // Drops the commas that fall inside quotes. Blocks without quotes, the
+    // common case, pass through untouched.
+    std::uint64_t unquoted(const BlockMasks& masks) {
+        if (masks.quotes == 0 && !inQuote_) {
+            return masks.structural;
+        }
+        std::uint64_t kept = 0;
+        for (std::uint64_t bits = masks.structural | masks.quotes; bits != 0; bits &= bits - 1) {
+            const int offset = __builtin_ctzll(bits);
+            const char ch = block_[offset];
+            if (ch == '"') {
+                inQuote_ = !inQuote_;
+            } else if (ch == '\n') {
+                inQuote_ = false;
+                kept |= std::uint64_t{1} << offset;
+            } else if (!inQuote_) {
+                kept |= std::uint64_t{1} << offset;
+            }
+        }
+        return kept;
+    }
+
+    StructuralMaskFn kernel_;
+    const char* block_;
+    const char* end_;
+    std::uint64_t mask_{0};
+    bool inQuote_{false};
+};
+
 std::string makeTempDir() {
     fs::path base = fs::temp_directory_path();
     std::string templ = (base / "cads-fmi-XXXXXX").string();
@@ -243,6 +852,23 @@ void writeJsonFloat(std::ostringstream& oss, double value) {
     oss << "null";
 }
 
+// Appends value in its shortest round-trip form, or null when it is not
+// finite. Used for long series where stream formatting dominates.
+void appendJsonFloat(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+    char buffer[32];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    const std::to_chars_result written = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, written.ptr);
+#else
+    const int length = std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    out.append(buffer, static_cast<size_t>(length));
+#endif
+}
+
 std::string escapeJsonString(const std::string& value) {
     std::ostringstream oss;
     for (char ch : value) {
@@ -356,18 +982,108 @@ std::string serializeJson(const FmuExecutionResult& result) {
             oss << "]";
         }
         oss << "}}";
+        first = false;
+    }
+
+    if (!result.snapshotValues.empty()) {
+        if (!first) {
+            oss << ",";
+        }
+        oss << "\"outputs_at\":{\"time\":[";
+        for (size_t i = 0; i < result.snapshotTimes.size(); ++i) {
+            if (i > 0) {
+                oss << ",";
+            }
+            writeJsonFloat(oss, result.snapshotTimes[i]);
+        }
+        oss << "],\"values\":{";
+        bool firstOutput = true;
+        for (const auto& [name, values] : result.snapshotValues) {
+            if (!firstOutput) {
+                oss << ",";
+            }
+            firstOutput = false;
+            oss << "\"" << escapeJsonString(name) << "\":[";
+            for (size_t i = 0; i < values.size(); ++i) {
+                if (i > 0) {
+                    oss << ",";
+                }
+                writeJsonValue(oss, values[i]);
+            }
+            oss << "]";
+        }
+        oss << "}}";
+        first = false;
+    }
+
+    if (!result.inputMetadata.empty()) {
+        if (!first) {
+            oss << ",";
+        }
+        oss << "\"input_metadata\":{";
+        bool firstEntry = true;
+        for (const auto& [key, value] : result.inputMetadata) {
+            if (!firstEntry) {
+                oss << ",";
+            }
+            firstEntry = false;
+            oss << "\"" << escapeJsonString(key) << "\":\"" << escapeJsonString(value) << "\"";
+        }
+        oss << "}";
+        first = false;
+    }
+
+    if (result.budgeted) {
+        if (!first) {
+            oss << ",";
+        }
+        oss << "\"partial\":" << (result.partial ? "true" : "false") << ",\"reached_time\":";
+        writeJsonFloat(oss, result.reachedTime);
+        first = false;
+    }
+
+    if (result.coalescedStep) {
+        if (!first) {
+            oss << ",";
+        }
+        oss << "\"coalesced_step\":";
+        writeJsonFloat(oss, *result.coalescedStep);
+        first = false;
+    }
+
+    if (result.live) {
+        if (!first) {
+            oss << ",";
+        }
+        oss << "\"live\":{\"samples\":" << result.live->samples << ",\"late\":" << result.live->late
+            << ",\"malformed\":" << result.live->malformed << ",\"gaps\":" << result.live->gaps
+            << ",\"max_latency_ms\":";
+        writeJsonFloat(oss, result.live->maxLatencyMs);
+        oss << ",\"reached_time\":";
+        writeJsonFloat(oss, result.reachedTime);
+        oss << "}";
     }
     oss << "}";
     return oss.str();
 }
 
-struct InputSeriesPoint {
-    double time{};
-    std::vector<NumericAssignment> values;
+// Input samples stored column-wise: one time vector plus one value vector per
+// applied column, so memory scales with the columns the FMU actually consumes.
+struct InputSeriesData {
+    std::vector<double> times;
+    std::vector<std::string> variables;
+    std::vector<std::vector<double>> columns;
+    // Key:,Value preamble of AE exports, keys without the trailing colon.
+    std::map<std::string, std::string> metadata;
+    // Spacing of the file's first two rows, which sets the default step size.
+    // Kept even when only a window of the file is loaded.
+    std::optional<double> firstInterval;
 };
 
-struct InputSeriesData {
-    std::vector<InputSeriesPoint> points;
+// Simulated time span a run needs from its input series.
+struct SeriesWindow {
+    double start;
+    double stop;
 };
 
 struct StepTimings {
@@ -376,910 +1092,4498 @@ struct StepTimings {
     double step;
 };
 
-InputSeriesData loadInputSeries(const InputSeriesConfig& cfg) {
-    std::ifstream stream(cfg.csvPath);
-    if (!stream.is_open()) {
-        fail("Failed opening input CSV '" + cfg.csvPath + "'");
+// Parses an AE arrival time "D:HH:MM:SS:frac frac" into seconds. The fraction
+// is every digit after the fourth colon read as one decimal fraction, so
+// "35:527 071000" is 35.527071 s. Runs once per row, so it works on the raw
+// characters without allocating.
+bool parseArrivalTime(const char* begin, const char* end, double& seconds) {
+    while (begin < end && std::isspace(static_cast<unsigned char>(*begin))) {
+        ++begin;
     }
-
-    std::string headerLine;
-    if (!std::getline(stream, headerLine)) {
-        fail("Input CSV '" + cfg.csvPath + "' is empty");
+    long long whole = 0;
+    static constexpr long long radix[] = {24, 60, 60};
+    for (int part = 0; part < 4; ++part) {
+        long long value = 0;
+        const char* digits = begin;
+        while (begin < end && *begin >= '0' && *begin <= '9') {
+            // Checked per digit, so a long run of digits cannot wrap value.
+            value = value * 10 + (*begin - '0');
+            if (value > std::numeric_limits<int>::max()) {
+                return false;
+            }
+            ++begin;
+        }
+        if (begin == digits || begin == end || *begin != ':') {
+            return false;
+        }
+        if (part > 0 && value >= radix[part - 1]) {
+            return false;
+        }
+        ++begin;
+        whole = part == 0 ? value : whole * radix[part - 1] + value;
     }
 
-    std::vector<std::string> headers = splitCsvLine(headerLine);
-    if (headers.empty()) {
-        fail("Input CSV '" + cfg.csvPath + "' is missing headers");
-    }
-    for (const auto& header : headers) {
-        if (header.empty()) {
-            fail("Input CSV '" + cfg.csvPath + "' contains an empty header");
+    // Up to 15 digits keep the mantissa exact, so the division below rounds once.
+    std::uint64_t mantissa = 0;
+    int digitCount = 0;
+    double scale = 1.0;
+    for (; begin < end; ++begin) {
+        char ch = *begin;
+        if (ch >= '0' && ch <= '9') {
+            if (digitCount < 15) {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(ch - '0');
+                scale *= 10.0;
+                digitCount += 1;
+            }
+        } else if (!std::isspace(static_cast<unsigned char>(ch))) {
+            return false;
         }
     }
+    seconds = static_cast<double>(whole) + static_cast<double>(mantissa) / scale;
+    return true;
+}
 
-    InputSeriesData series;
-    std::string line;
-    double lastTime = -std::numeric_limits<double>::infinity();
-    size_t lineNumber = 1;
-    while (std::getline(stream, line)) {
-        lineNumber += 1;
-        line = trimCopy(line);
-        if (line.empty()) {
-            continue;
+// Read-only memory map of an input file. The descriptor is closed as soon as
+// the mapping exists.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            fail("Failed opening input CSV '" + path + "'");
         }
-
-        std::vector<std::string> fields = splitCsvLine(line);
-        if (fields.size() != headers.size()) {
-            fail("Input CSV '" + cfg.csvPath + "' line " + std::to_string(lineNumber) + " has " +
-                 std::to_string(fields.size()) + " columns, expected " + std::to_string(headers.size()));
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            fail("Failed reading size of input CSV '" + path + "'");
         }
-
-        InputSeriesPoint point;
-        point.time = parseNumber(fields[0]);
-        if (point.time + 1e-12 < lastTime) {
-            fail("Input CSV '" + cfg.csvPath + "' is not sorted by time");
+        size_ = static_cast<size_t>(st.st_size);
+#ifdef __APPLE__
+        modified_ = static_cast<std::int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+        modified_ = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+        if (size_ > 0) {
+            void* mem = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mem == MAP_FAILED) {
+                ::close(fd);
+                fail("Failed mapping input CSV '" + path + "'");
+            }
+            ::madvise(mem, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(mem);
         }
-        lastTime = point.time;
-        point.values.reserve(headers.size());
-        for (size_t i = 0; i < headers.size(); ++i) {
-            point.values.push_back({headers[i], parseNumber(fields[i])});
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), size_);
         }
-        series.points.push_back(std::move(point));
     }
 
-    if (series.points.empty()) {
-        fail("Input CSV '" + cfg.csvPath + "' does not contain any samples");
+    const char* begin() const {
+        return data_;
     }
-    return series;
-}
 
-void alignTimingsWithSeries(StepTimings& timings, const Config& cfg, const std::optional<InputSeriesData>& series) {
-    if (!series || series->points.empty()) {
-        return;
+    const char* end() const {
+        return data_ + size_;
     }
 
-    if (!cfg.startTime) {
-        timings.start = series->points.front().time;
+    size_t size() const {
+        return size_;
     }
-    if (!cfg.stopTime) {
-        timings.stop = series->points.back().time;
+
+    // Modification time in nanoseconds since the epoch.
+    std::int64_t modified() const {
+        return modified_;
     }
-    if (!cfg.stepSize) {
-        if (series->points.size() > 1) {
-            double derived = series->points[1].time - series->points[0].time;
-            if (derived > 0.0) {
-                timings.step = derived;
-            }
-        } else {
-            timings.step = std::max(1e-3, timings.stop - timings.start);
+
+private:
+    const char* data_{nullptr};
+    size_t size_{0};
+    std::int64_t modified_{0};
+};
+
+// Returns the line at cursor without its line break and moves cursor past it.
+std::string_view nextLine(const char*& cursor, const char* end) {
+    const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+    const char* lineEnd = newline ? newline : end;
+    std::string_view line(cursor, static_cast<size_t>(lineEnd - cursor));
+    cursor = newline ? newline + 1 : end;
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    return line;
+}
+
+// Reads an AE export preamble up to the "Arrival time," header, stores the
+// Key:,Value lines in metadata and returns the header line.
+std::string readAePreamble(const char*& cursor, const char* end, const std::string& path,
+                           std::map<std::string, std::string>& metadata, size_t& lineNumber) {
+    while (cursor < end) {
+        std::string_view line = nextLine(cursor, end);
+        lineNumber += 1;
+        if (lineNumber == 1 && line.substr(0, 3) == "\xEF\xBB\xBF") {
+            line.remove_prefix(3);
+        }
+        if (line.substr(0, 13) == "Arrival time,") {
+            return std::string(line);
+        }
+        size_t comma = line.find(',');
+        if (comma == std::string_view::npos) {
+            continue;
+        }
+        std::string key = trimCopy(std::string(line.substr(0, comma)));
+        if (!key.empty() && key.back() == ':') {
+            key.pop_back();
+        }
+        if (!key.empty()) {
+            metadata[key] = trimCopy(std::string(line.substr(comma + 1)));
         }
     }
+    fail("Input CSV '" + path + "' does not contain an AE \"Arrival time\" header");
 }
 
-std::vector<std::string> buildTraceNames(const TraceConfig& trace) {
-    std::vector<std::string> names;
-    auto appendUnique = [&names](const std::vector<std::string>& values) {
-        for (const auto& value : values) {
-            if (std::find(names.begin(), names.end(), value) == names.end()) {
-                names.push_back(value);
+// Layout shared by every chunk of one input file.
+struct SeriesLayout {
+    bool aeDialect{false};
+    size_t columnCount{0};
+    // Position in InputSeriesData::columns of every CSV column, or -1 when the
+    // column is not applied.
+    std::vector<int> slotOf;
+    size_t appliedCount{0};
+};
+
+// Rows parsed from one newline-aligned slice of the file body. Times are raw
+// (absolute arrival times for AE files); the time column, if applied, is
+// filled in when the chunks are stitched together.
+struct SeriesChunk {
+    std::vector<double> times;
+    std::vector<std::vector<double>> columns;
+    size_t lines{0};
+    size_t firstRowLine{0};
+    // First problem found, as a line number relative to the chunk start.
+    size_t errorLine{0};
+    std::string error;
+};
+
+void parseSeriesChunk(const char* cursor, const char* end, const SeriesLayout& layout, SeriesChunk& chunk) {
+    chunk.columns.resize(layout.appliedCount);
+    // Errors are reported against the line currently being parsed.
+    auto stop = [&chunk](std::string message) {
+        chunk.errorLine = chunk.lines + 1;
+        chunk.error = std::move(message);
+    };
+    auto quoted = [](const char* begin, const char* fieldEnd) {
+        return "'" + trimCopy(std::string(begin, fieldEnd)) + "'";
+    };
+    auto blank = [](const char* begin, const char* fieldEnd) {
+        return std::all_of(begin, fieldEnd, [](char ch) { return std::isspace(static_cast<unsigned char>(ch)); });
+    };
+
+    StructuralScanner scanner(cursor, end);
+    double lastTime = -std::numeric_limits<double>::infinity();
+    const char* field = cursor;
+    size_t column = 0;
+    double time = 0.0;
+    for (;;) {
+        const char* delimiter = scanner.next();
+        const bool atEnd = delimiter == end;
+        if (atEnd && column == 0 && field == end) {
+            break;
+        }
+        const bool rowEnd = atEnd || *delimiter == '\n';
+        if (rowEnd && column == 0 && blank(field, delimiter)) {
+            chunk.lines += 1;
+            if (atEnd) {
+                break;
             }
+            field = delimiter + 1;
+            continue;
         }
-    };
-    appendUnique(trace.outputs);
-    appendUnique(trace.inputs);
-    return names;
-}
 
-double resolveTraceInterval(const Config& cfg, const StepTimings& timings) {
-    if (cfg.trace.sampleEvery) {
-        if (*cfg.trace.sampleEvery <= 0.0) {
-            fail("trace sample interval must be positive");
+        if (column == 0) {
+            bool parsed = layout.aeDialect ? parseArrivalTime(field, delimiter, time)
+                                           : parseNumberField(field, delimiter, time);
+            if (!parsed) {
+                return stop(std::string(layout.aeDialect ? "has an invalid arrival time " : "has an invalid time ") +
+                            quoted(field, delimiter));
+            }
+        } else if (column < layout.columnCount && layout.slotOf[column] >= 0) {
+            double value = 0.0;
+            if (!parseNumberField(field, delimiter, value)) {
+                return stop("has a non-numeric value " + quoted(field, delimiter));
+            }
+            chunk.columns[static_cast<size_t>(layout.slotOf[column])].push_back(value);
+        }
+        column += 1;
+        field = delimiter + 1;
+        if (!rowEnd) {
+            continue;
+        }
+
+        if (column != layout.columnCount) {
+            return stop("has " + std::to_string(column) + " columns, expected " + std::to_string(layout.columnCount));
+        }
+        if (time + 1e-12 < lastTime) {
+            return stop("is not sorted by time");
+        }
+        lastTime = time;
+        if (chunk.times.empty()) {
+            chunk.firstRowLine = chunk.lines + 1;
+        }
+        chunk.times.push_back(time);
+        chunk.lines += 1;
+        column = 0;
+        if (atEnd) {
+            break;
         }
-        return *cfg.trace.sampleEvery;
     }
-    if (timings.step > 0.0) {
-        return timings.step;
+}
+
+// Bodies below this size are parsed on the calling thread.
+constexpr size_t kParallelParseBytes = 8u << 20;
+constexpr size_t kMinChunkBytes = 4u << 20;
+
+// Threads a large body is parsed on: CADS_PARSE_THREADS when set, otherwise
+// one per core.
+size_t parseThreads() {
+    if (const char* configured = std::getenv("CADS_PARSE_THREADS")) {
+        char* end = nullptr;
+        const unsigned long threads = std::strtoul(configured, &end, 10);
+        if (end != configured && *end == '\0' && threads > 0) {
+            return static_cast<size_t>(threads);
+        }
     }
-    return std::max(1e-3, timings.stop - timings.start);
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
 }
 
-StepTimings deriveTimingsFmi2(fmi2_import_t* fmu, const Config& cfg) {
-    StepTimings t{};
-    if (cfg.startTime) {
-        t.start = *cfg.startTime;
-    } else if (fmi2_import_get_default_experiment_has_start(fmu)) {
-        t.start = fmi2_import_get_default_experiment_start(fmu);
-    } else {
-        t.start = 0.0;
+// Splits [begin, end) into up to `count` slices that each start at a line.
+std::vector<std::pair<const char*, const char*>> splitAtLines(const char* begin, const char* end, size_t count) {
+    std::vector<std::pair<const char*, const char*>> slices;
+    const size_t size = static_cast<size_t>(end - begin);
+    const char* start = begin;
+    for (size_t k = 1; k < count && start < end; ++k) {
+        const char* cut = begin + size / count * k;
+        if (cut <= start) {
+            continue;
+        }
+        const char* newline = static_cast<const char*>(std::memchr(cut, '\n', static_cast<size_t>(end - cut)));
+        const char* next = newline ? newline + 1 : end;
+        slices.emplace_back(start, next);
+        start = next;
     }
+    if (start < end || slices.empty()) {
+        slices.emplace_back(start, end);
+    }
+    return slices;
+}
 
-    if (cfg.stopTime) {
-        t.stop = *cfg.stopTime;
-    } else if (fmi2_import_get_default_experiment_has_stop(fmu)) {
-        t.stop = fmi2_import_get_default_experiment_stop(fmu);
-    } else {
-        t.stop = t.start + 1.0;
+// Decides which columns of headers are applied, and under which variable.
+void buildSeriesLayout(const InputSeriesConfig& cfg, const std::vector<std::string>& headers,
+                       InputSeriesData& series, SeriesLayout& layout) {
+    if (headers.empty()) {
+        fail("Input CSV '" + cfg.csvPath + "' is missing headers");
+    }
+    for (const auto& header : headers) {
+        if (header.empty()) {
+            fail("Input CSV '" + cfg.csvPath + "' contains an empty header");
+        }
     }
 
-    if (cfg.stepSize) {
-        t.step = *cfg.stepSize;
-    } else if (fmi2_import_get_default_experiment_has_step(fmu)) {
-        t.step = fmi2_import_get_default_experiment_step(fmu);
+    // Unapplied fields are skipped without being copied or converted.
+    layout.columnCount = headers.size();
+    layout.slotOf.assign(headers.size(), -1);
+    auto findHeader = [&](const std::string& name) {
+        return std::find(headers.begin(), headers.end(), name);
+    };
+    auto isIgnored = [&](const std::string& name) {
+        return std::find(cfg.ignore.begin(), cfg.ignore.end(), name) != cfg.ignore.end();
+    };
+    if (cfg.columns.empty()) {
+        if (layout.aeDialect) {
+            fail("AE input series '" + cfg.csvPath + "' requires a column map");
+        }
+        for (size_t i = 0; i < headers.size(); ++i) {
+            if (isIgnored(headers[i])) {
+                continue;
+            }
+            layout.slotOf[i] = static_cast<int>(series.variables.size());
+            series.variables.push_back(headers[i]);
+        }
     } else {
-        t.step = std::max(1e-3, (t.stop - t.start));
+        for (const auto& column : cfg.columns) {
+            auto found = findHeader(column.name);
+            if (found == headers.end()) {
+                fail("Input CSV '" + cfg.csvPath + "' has no column '" + column.name + "'");
+            }
+            if (isIgnored(column.name)) {
+                fail("Input CSV column '" + column.name + "' is both mapped and ignored");
+            }
+            size_t index = static_cast<size_t>(found - headers.begin());
+            if (layout.slotOf[index] >= 0) {
+                fail("Input CSV column '" + column.name + "' is mapped more than once");
+            }
+            layout.slotOf[index] = static_cast<int>(series.variables.size());
+            series.variables.push_back(column.value);
+        }
     }
-    return t;
+    layout.appliedCount = series.variables.size();
 }
 
-StepTimings deriveTimingsFmi3(fmi3_import_t* fmu, const Config& cfg) {
-    StepTimings t{};
-    if (cfg.startTime) {
-        t.start = *cfg.startTime;
-    } else if (fmi3_import_get_default_experiment_has_start(fmu)) {
-        t.start = fmi3_import_get_default_experiment_start(fmu);
+// Reads the preamble and header at cursor, fills in the applied variables and
+// the column layout, and leaves cursor at the first body line.
+void readSeriesHeader(const InputSeriesConfig& cfg, const char*& cursor, const char* end,
+                      InputSeriesData& series, SeriesLayout& layout, size_t& lineNumber) {
+    layout.aeDialect = cfg.dialect == CADS_INPUT_DIALECT_AE;
+    std::string headerLine;
+    if (layout.aeDialect) {
+        headerLine = readAePreamble(cursor, end, cfg.csvPath, series.metadata, lineNumber);
     } else {
-        t.start = 0.0;
+        if (cursor == end) {
+            fail("Input CSV '" + cfg.csvPath + "' is empty");
+        }
+        headerLine = std::string(nextLine(cursor, end));
+        lineNumber = 1;
     }
 
-    if (cfg.stopTime) {
-        t.stop = *cfg.stopTime;
-    } else if (fmi3_import_get_default_experiment_has_stop(fmu)) {
-        t.stop = fmi3_import_get_default_experiment_stop(fmu);
-    } else {
-        t.stop = t.start + 1.0;
-    }
+    buildSeriesLayout(cfg, splitCsvLine(headerLine), series, layout);
+}
 
-    if (cfg.stepSize) {
-        t.step = *cfg.stepSize;
-    } else if (fmi3_import_get_default_experiment_has_step_size(fmu)) {
-        t.step = fmi3_import_get_default_experiment_step_size(fmu);
+std::vector<SeriesChunk> parseMappedBody(const char* cursor, const char* end, const SeriesLayout& layout) {
+    // Large bodies are cut at line boundaries and parsed concurrently; the
+    // chunks are then stitched in file order.
+    size_t chunkCount = 1;
+    const size_t bodySize = static_cast<size_t>(end - cursor);
+    if (bodySize >= kParallelParseBytes) {
+        chunkCount = std::max<size_t>(1, std::min(parseThreads(), bodySize / kMinChunkBytes));
+    }
+    std::vector<std::pair<const char*, const char*>> slices = splitAtLines(cursor, end, chunkCount);
+    std::vector<SeriesChunk> chunks(slices.size());
+    if (slices.size() == 1) {
+        parseSeriesChunk(slices[0].first, slices[0].second, layout, chunks[0]);
     } else {
-        t.step = std::max(1e-3, (t.stop - t.start));
+        std::vector<std::thread> threads;
+        threads.reserve(slices.size());
+        for (size_t i = 0; i < slices.size(); ++i) {
+            threads.emplace_back(parseSeriesChunk, slices[i].first, slices[i].second, std::cref(layout), std::ref(chunks[i]));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
     }
-    return t;
+    return chunks;
 }
 
-std::vector<std::string> autoOutputsFmi2(fmi2_import_t* fmu) {
-    std::vector<std::string> names;
-    fmi2_import_variable_list_t* list = fmi2_import_get_variable_list(fmu, 0);
-    size_t n = fmi2_import_get_variable_list_size(list);
-    for (size_t i = 0; i < n; ++i) {
-        fmi2_import_variable_t* var = fmi2_import_get_variable(list, i);
-        fmi2_causality_enu_t causality = fmi2_import_get_causality(var);
-        if (causality == fmi2_causality_enu_output || causality == fmi2_causality_enu_calculated_parameter) {
-            names.emplace_back(fmi2_import_get_variable_name(var));
-        }
+// Magic numbers of the compressed input formats the loader understands.
+enum class InputCodec { None, Gzip, Zstd };
+
+InputCodec detectCodec(const char* begin, const char* end) {
+    const size_t size = static_cast<size_t>(end - begin);
+    if (size >= 2 && static_cast<unsigned char>(begin[0]) == 0x1f && static_cast<unsigned char>(begin[1]) == 0x8b) {
+        return InputCodec::Gzip;
     }
-    fmi2_import_free_variable_list(list);
-    if (names.empty()) {
-        names.push_back("time");
+    if (size >= 4 && std::memcmp(begin, "\x28\xb5\x2f\xfd", 4) == 0) {
+        return InputCodec::Zstd;
     }
-    return names;
+    return InputCodec::None;
 }
 
-std::vector<std::string> autoOutputsFmi3(fmi3_import_t* fmu) {
-    std::vector<std::string> names;
-    fmi3_import_variable_list_t* list = fmi3_import_get_variable_list(fmu, 0);
-    size_t n = fmi3_import_get_variable_list_size(list);
-    for (size_t i = 0; i < n; ++i) {
-        fmi3_import_variable_t* var = fmi3_import_get_variable(list, i);
-        fmi3_causality_enu_t causality = fmi3_import_get_variable_causality(var);
-        if (causality == fmi3_causality_enu_output || causality == fmi3_causality_enu_calculated_parameter) {
-            names.emplace_back(fmi3_import_get_variable_name(var));
-        }
+// Decompresses a mapped gzip or zstd file on a background thread into a small
+// queue of blocks, so parsing one block overlaps decompressing the next.
+class DecompressingReader {
+public:
+    DecompressingReader(const char* begin, const char* end, InputCodec codec, std::string path)
+        : begin_(begin), end_(end), codec_(codec), path_(std::move(path)) {
+        thread_ = std::thread([this] { run(); });
     }
-    fmi3_import_free_variable_list(list);
-    if (names.empty()) {
-        names.push_back("time");
+
+    DecompressingReader(const DecompressingReader&) = delete;
+    DecompressingReader& operator=(const DecompressingReader&) = delete;
+
+    ~DecompressingReader() {
+        {
+            std::lock_guard<std::mutex> guard(mu_);
+            cancelled_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
     }
-    return names;
-}
 
-void applyNumericValueFmi2(fmi2_import_t* fmu, const std::string& name, double value) {
-    fmi2_import_variable_t* var = fmi2_import_get_variable_by_name(fmu, name.c_str());
-    if (!var) {
-        fail("Unknown variable '" + name + "'");
+    // Moves the next decompressed block into out. Returns false at the end of
+    // the stream and rethrows decompression errors.
+    bool next(std::string& out) {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this] { return !blocks_.empty() || done_; });
+        if (!blocks_.empty()) {
+            out = std::move(blocks_.front());
+            blocks_.pop_front();
+            cv_.notify_all();
+            return true;
+        }
+        if (!error_.empty()) {
+            fail(error_);
+        }
+        return false;
     }
-    fmi2_value_reference_t vr = fmi2_import_get_variable_vr(var);
-    fmi2_base_type_enu_t baseType = fmi2_import_get_variable_base_type(var);
-    switch (baseType) {
-        case fmi2_base_type_real: {
-            fmi2_real_t v = static_cast<fmi2_real_t>(value);
-            if (fmi2_import_set_real(fmu, &vr, 1, &v) != fmi2_status_ok) {
-                fail("Failed setting real " + name);
+
+private:
+    static constexpr size_t kBlockBytes = 4u << 20;
+    static constexpr size_t kQueueDepth = 4;
+
+    void run() {
+        try {
+            if (codec_ == InputCodec::Gzip) {
+                inflateGzip();
+            } else {
+                inflateZstd();
             }
-            break;
+        } catch (const std::exception& ex) {
+            std::lock_guard<std::mutex> guard(mu_);
+            error_ = ex.what();
         }
-        case fmi2_base_type_int: {
-            fmi2_integer_t intVal = static_cast<fmi2_integer_t>(std::llround(value));
-            if (fmi2_import_set_integer(fmu, &vr, 1, &intVal) != fmi2_status_ok) {
-                fail("Failed setting integer " + name);
+        {
+            std::lock_guard<std::mutex> guard(mu_);
+            done_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    // Returns false once the consumer has gone away.
+    bool push(std::string& block, size_t filled) {
+        block.resize(filled);
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this] { return blocks_.size() < kQueueDepth || cancelled_; });
+        if (cancelled_) {
+            return false;
+        }
+        blocks_.push_back(std::move(block));
+        cv_.notify_all();
+        block.assign(kBlockBytes, '\0');
+        return true;
+    }
+
+    void inflateGzip() {
+        z_stream zs{};
+        if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) {
+            fail("Failed initializing gzip decoder for '" + path_ + "'");
+        }
+        struct InflateGuard {
+            z_stream* zs;
+            ~InflateGuard() {
+                inflateEnd(zs);
+            }
+        } guard{&zs};
+
+        const unsigned char* input = reinterpret_cast<const unsigned char*>(begin_);
+        size_t remaining = static_cast<size_t>(end_ - begin_);
+        std::string block(kBlockBytes, '\0');
+        size_t filled = 0;
+        for (;;) {
+            if (zs.avail_in == 0 && remaining > 0) {
+                uInt feed = static_cast<uInt>(std::min<size_t>(remaining, 1u << 30));
+                zs.next_in = const_cast<Bytef*>(input);
+                zs.avail_in = feed;
+                input += feed;
+                remaining -= feed;
+            }
+            zs.next_out = reinterpret_cast<Bytef*>(&block[filled]);
+            zs.avail_out = static_cast<uInt>(kBlockBytes - filled);
+            int rc = inflate(&zs, Z_NO_FLUSH);
+            filled = kBlockBytes - zs.avail_out;
+            if (filled == kBlockBytes) {
+                if (!push(block, filled)) {
+                    return;
+                }
+                filled = 0;
+            }
+            if (rc == Z_STREAM_END) {
+                if (zs.avail_in == 0 && remaining == 0) {
+                    break;
+                }
+                // Concatenated gzip members, as written by `cat a.gz b.gz`.
+                if (inflateReset(&zs) != Z_OK) {
+                    fail("Failed resetting gzip decoder for '" + path_ + "'");
+                }
+            } else if (rc == Z_BUF_ERROR) {
+                if (zs.avail_in == 0 && remaining == 0) {
+                    fail("Input CSV '" + path_ + "' is a truncated gzip stream");
+                }
+            } else if (rc != Z_OK) {
+                fail("Input CSV '" + path_ + "' is not a valid gzip stream: " + (zs.msg ? zs.msg : "inflate failed"));
             }
-            break;
         }
-        case fmi2_base_type_bool: {
-            fmi2_boolean_t boolVal = (value != 0.0) ? fmi2_true : fmi2_false;
-            if (fmi2_import_set_boolean(fmu, &vr, 1, &boolVal) != fmi2_status_ok) {
-                fail("Failed setting boolean " + name);
+        if (filled > 0) {
+            push(block, filled);
+        }
+    }
+
+    void inflateZstd() {
+        std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> dctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+        if (!dctx) {
+            fail("Failed initializing zstd decoder for '" + path_ + "'");
+        }
+        ZSTD_inBuffer input{begin_, static_cast<size_t>(end_ - begin_), 0};
+        std::string block(kBlockBytes, '\0');
+        size_t filled = 0;
+        size_t pending = 0;
+        for (;;) {
+            ZSTD_outBuffer output{&block[filled], kBlockBytes - filled, 0};
+            pending = ZSTD_decompressStream(dctx.get(), &output, &input);
+            if (ZSTD_isError(pending)) {
+                fail("Input CSV '" + path_ + "' is not a valid zstd stream: " + ZSTD_getErrorName(pending));
+            }
+            filled += output.pos;
+            const bool outputFull = filled == kBlockBytes;
+            if (outputFull) {
+                if (!push(block, filled)) {
+                    return;
+                }
+                filled = 0;
+            }
+            if (input.pos == input.size && !outputFull) {
+                break;
             }
-            break;
         }
-        default:
-            fail("Unsupported base type for " + name);
+        if (pending != 0) {
+            fail("Input CSV '" + path_ + "' is a truncated zstd stream");
+        }
+        if (filled > 0) {
+            push(block, filled);
+        }
     }
-}
 
-void applyStartValueFmi2(fmi2_import_t* fmu, const Assignment& assign) {
-    applyNumericValueFmi2(fmu, assign.name, parseNumber(assign.value));
-}
+    const char* begin_;
+    const char* end_;
+    InputCodec codec_;
+    std::string path_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<std::string> blocks_;
+    bool done_{false};
+    bool cancelled_{false};
+    std::string error_;
+    std::thread thread_;
+};
 
-void applySeriesPointFmi2(fmi2_import_t* fmu, const InputSeriesPoint& point) {
-    for (const auto& entry : point.values) {
-        applyNumericValueFmi2(fmu, entry.name, entry.value);
+// True once text holds the complete preamble and header line.
+bool hasSeriesHeader(const std::string& text, bool aeDialect) {
+    if (!aeDialect) {
+        return text.find('\n') != std::string::npos;
     }
+    const size_t start = text.compare(0, 3, "\xEF\xBB\xBF") == 0 ? 3 : 0;
+    size_t header = text.compare(start, 13, "Arrival time,") == 0 ? start : text.find("\nArrival time,");
+    return header != std::string::npos && text.find('\n', header + 1) != std::string::npos;
 }
 
-OutputValue readVariableFmi2(fmi2_import_t* fmu, const std::string& name) {
-    fmi2_import_variable_t* var = fmi2_import_get_variable_by_name(fmu, name.c_str());
-    if (!var) {
-        fail("Variable '" + name + "' not found");
+// Streams a compressed file through DecompressingReader, parsing every run of
+// complete lines as soon as it arrives. Stops at the first chunk with an error.
+std::vector<SeriesChunk> parseCompressedSeries(const InputSeriesConfig& cfg, const MappedFile& file, InputCodec codec,
+                                               InputSeriesData& series, SeriesLayout& layout, size_t& lineNumber) {
+    DecompressingReader reader(file.begin(), file.end(), codec, cfg.csvPath);
+    std::string pending;
+    std::string block;
+    bool more = true;
+    while (more && !hasSeriesHeader(pending, cfg.dialect == CADS_INPUT_DIALECT_AE)) {
+        more = reader.next(block);
+        pending += block;
+        block.clear();
     }
-    fmi2_value_reference_t vr = fmi2_import_get_variable_vr(var);
-    fmi2_base_type_enu_t baseType = fmi2_import_get_variable_base_type(var);
-    OutputValue ov{};
-    switch (baseType) {
-        case fmi2_base_type_real: {
-            fmi2_real_t value{};
-            fmi2_import_get_real(fmu, &vr, 1, &value);
-            ov.type = OutputValue::Type::Real;
-            ov.realVal = value;
-            break;
+    const char* cursor = pending.data();
+    readSeriesHeader(cfg, cursor, pending.data() + pending.size(), series, layout, lineNumber);
+    pending.erase(0, static_cast<size_t>(cursor - pending.data()));
+
+    std::vector<SeriesChunk> chunks;
+    for (;;) {
+        size_t lastNewline = pending.rfind('\n');
+        if (lastNewline != std::string::npos || (!more && !pending.empty())) {
+            size_t length = more ? lastNewline + 1 : pending.size();
+            chunks.emplace_back();
+            parseSeriesChunk(pending.data(), pending.data() + length, layout, chunks.back());
+            if (!chunks.back().error.empty()) {
+                break;
+            }
+            pending.erase(0, length);
         }
-        case fmi2_base_type_int: {
-            fmi2_integer_t iv{};
-            fmi2_import_get_integer(fmu, &vr, 1, &iv);
-            ov.type = OutputValue::Type::Integer;
-            ov.intVal = iv;
+        if (!more) {
             break;
         }
-        case fmi2_base_type_bool: {
-            fmi2_boolean_t bv{};
-            fmi2_import_get_boolean(fmu, &vr, 1, &bv);
-            ov.type = OutputValue::Type::Boolean;
-            ov.boolVal = (bv != fmi2_false);
-            break;
+        more = reader.next(block);
+        pending += block;
+        block.clear();
+    }
+    return chunks;
+}
+
+// Joins parsed chunks in file order into series, checking that time keeps
+// increasing across chunk edges and reporting the first chunk error.
+void stitchSeries(const InputSeriesConfig& cfg, const SeriesLayout& layout, std::vector<SeriesChunk>& chunks,
+                  size_t lineNumber, InputSeriesData& series) {
+    size_t total = 0;
+    for (const auto& chunk : chunks) {
+        total += chunk.times.size();
+    }
+    series.times.reserve(total);
+    series.columns.resize(layout.appliedCount);
+    for (auto& column : series.columns) {
+        column.reserve(total);
+    }
+
+    for (auto& chunk : chunks) {
+        if (!chunk.times.empty() && !series.times.empty() && chunk.times.front() + 1e-12 < series.times.back()) {
+            fail("Input CSV '" + cfg.csvPath + "' line " + std::to_string(lineNumber + chunk.firstRowLine) +
+                 " is not sorted by time");
         }
-        default:
-            fail("Unsupported variable type for " + name);
+        if (!chunk.error.empty()) {
+            fail("Input CSV '" + cfg.csvPath + "' line " + std::to_string(lineNumber + chunk.errorLine) + " " + chunk.error);
+        }
+        lineNumber += chunk.lines;
+        series.times.insert(series.times.end(), chunk.times.begin(), chunk.times.end());
+        for (size_t i = 0; i < chunk.columns.size(); ++i) {
+            series.columns[i].insert(series.columns[i].end(), chunk.columns[i].begin(), chunk.columns[i].end());
+        }
+        chunk = SeriesChunk{};
     }
-    return ov;
 }
 
-size_t checkedMultiply(size_t lhs, size_t rhs, const std::string& what) {
-    if (lhs == 0 || rhs == 0) {
-        fail("Array dimension for " + what + " resolved to zero");
+// Shifts AE times to seconds since origin, the file's first event, and fills in
+// the time column when it is applied.
+void finishSeries(const SeriesLayout& layout, double origin, InputSeriesData& series) {
+    if (layout.aeDialect) {
+        for (double& time : series.times) {
+            time -= origin;
+        }
     }
-    if (lhs > std::numeric_limits<size_t>::max() / rhs) {
-        fail("Array size overflow for " + what);
+    if (layout.slotOf[0] >= 0) {
+        series.columns[static_cast<size_t>(layout.slotOf[0])] = series.times;
     }
-    return lhs * rhs;
+}
+
+// Bodies of this size and more are loaded through a sparse index when a run
+// only needs a window of them.
+constexpr size_t kIndexedSeriesBytes = 16u << 20;
+constexpr std::uint32_t kIndexStride = 4096;
+constexpr char kIndexMagic[8] = {'C', 'A', 'D', 'S', 'I', 'D', 'X', '1'};
+
+struct SeriesIndexEntry {
+    double time;
+    std::uint64_t offset;
+    std::uint64_t line;
+};
+
+// Raw time and byte offset of every kIndexStride-th row of an input CSV, cached
+// in the index directory (see seriesIndexPath). The header identifies the file
+// version and parse settings the entries were built from.
+struct SeriesIndex {
+    std::uint64_t fileSize{0};
+    std::int64_t modified{0};
+    std::uint64_t bodyOffset{0};
+    std::uint32_t dialect{0};
+    std::uint32_t stride{kIndexStride};
+    // NaN when the file has a single row.
+    double firstInterval{std::numeric_limits<double>::quiet_NaN()};
+    std::vector<SeriesIndexEntry> entries;
+};
+
+// Walks the body line by line, parsing only the time of sampled rows. Returns
+// nothing when a sampled time is invalid or out of order, leaving the error to
+// the full parse.
+std::optional<SeriesIndex> buildSeriesIndex(const char* begin, const char* body, const char* end,
+                                            const SeriesLayout& layout, size_t lineNumber) {
+    SeriesIndex index;
+    size_t row = 0;
+    double firstTime = 0.0;
+    const char* cursor = body;
+    while (cursor < end) {
+        const char* lineStart = cursor;
+        std::string_view line = nextLine(cursor, end);
+        lineNumber += 1;
+        const bool blank = std::all_of(line.begin(), line.end(),
+                                       [](char ch) { return std::isspace(static_cast<unsigned char>(ch)); });
+        if (blank) {
+            continue;
+        }
+        if (row % kIndexStride == 0 || row == 1) {
+            size_t comma = line.find(',');
+            const char* fieldEnd = line.data() + (comma == std::string_view::npos ? line.size() : comma);
+            double time = 0.0;
+            bool parsed = layout.aeDialect ? parseArrivalTime(line.data(), fieldEnd, time)
+                                           : parseNumberField(line.data(), fieldEnd, time);
+            if (!parsed) {
+                return std::nullopt;
+            }
+            if (row == 0) {
+                firstTime = time;
+            } else if (row == 1) {
+                index.firstInterval = time - firstTime;
+            }
+            if (row % kIndexStride == 0) {
+                if (!index.entries.empty() && time + 1e-12 < index.entries.back().time) {
+                    return std::nullopt;
+                }
+                index.entries.push_back({time, static_cast<std::uint64_t>(lineStart - begin), lineNumber});
+            }
+        }
+        row += 1;
+    }
+    if (index.entries.empty()) {
+        return std::nullopt;
+    }
+    return index;
+}
+
+std::optional<SeriesIndex> readSeriesIndex(const std::string& path) {
+    std::unique_ptr<FILE, int (*)(FILE*)> in(std::fopen(path.c_str(), "rb"), std::fclose);
+    if (!in) {
+        return std::nullopt;
+    }
+    char magic[sizeof(kIndexMagic)];
+    SeriesIndex index;
+    std::uint64_t count = 0;
+    bool ok = std::fread(magic, sizeof(magic), 1, in.get()) == 1 &&
+              std::memcmp(magic, kIndexMagic, sizeof(magic)) == 0 &&
+              std::fread(&index.fileSize, sizeof(index.fileSize), 1, in.get()) == 1 &&
+              std::fread(&index.modified, sizeof(index.modified), 1, in.get()) == 1 &&
+              std::fread(&index.bodyOffset, sizeof(index.bodyOffset), 1, in.get()) == 1 &&
+              std::fread(&index.dialect, sizeof(index.dialect), 1, in.get()) == 1 &&
+              std::fread(&index.stride, sizeof(index.stride), 1, in.get()) == 1 &&
+              std::fread(&index.firstInterval, sizeof(index.firstInterval), 1, in.get()) == 1 &&
+              std::fread(&count, sizeof(count), 1, in.get()) == 1 && count > 0 && count <= index.fileSize;
+    if (!ok) {
+        return std::nullopt;
+    }
+    index.entries.resize(static_cast<size_t>(count));
+    if (std::fread(index.entries.data(), sizeof(SeriesIndexEntry), index.entries.size(), in.get()) !=
+        index.entries.size()) {
+        return std::nullopt;
+    }
+    return index;
+}
+
+// Best effort: the index is still used for this run when the directory is not
+// writable. Writing to a temporary name and renaming keeps concurrent runs from
+// seeing a partial file.
+void writeSeriesIndex(const std::string& path, const SeriesIndex& index) {
+    std::ostringstream tmpName;
+    tmpName << path << ".tmp." << ::getpid() << '.' << std::this_thread::get_id();
+    const std::string tmp = tmpName.str();
+    {
+        std::unique_ptr<FILE, int (*)(FILE*)> out(std::fopen(tmp.c_str(), "wb"), std::fclose);
+        if (!out) {
+            return;
+        }
+        const std::uint64_t count = index.entries.size();
+        bool ok = std::fwrite(kIndexMagic, sizeof(kIndexMagic), 1, out.get()) == 1 &&
+                  std::fwrite(&index.fileSize, sizeof(index.fileSize), 1, out.get()) == 1 &&
+                  std::fwrite(&index.modified, sizeof(index.modified), 1, out.get()) == 1 &&
+                  std::fwrite(&index.bodyOffset, sizeof(index.bodyOffset), 1, out.get()) == 1 &&
+                  std::fwrite(&index.dialect, sizeof(index.dialect), 1, out.get()) == 1 &&
+                  std::fwrite(&index.stride, sizeof(index.stride), 1, out.get()) == 1 &&
+                  std::fwrite(&index.firstInterval, sizeof(index.firstInterval), 1, out.get()) == 1 &&
+                  std::fwrite(&count, sizeof(count), 1, out.get()) == 1 &&
+                  std::fwrite(index.entries.data(), sizeof(SeriesIndexEntry), index.entries.size(), out.get()) ==
+                      index.entries.size();
+        if (std::fclose(out.release()) != 0 || !ok) {
+            std::remove(tmp.c_str());
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        std::remove(tmp.c_str());
+    }
+}
+
+bool underDirectory(const fs::path& path, const fs::path& dir) {
+    auto mismatch = std::mismatch(dir.begin(), dir.end(), path.begin(), path.end());
+    return mismatch.first == dir.end();
+}
+
+// Where the index of csvPath is cached: CADS_INDEX_DIR, or cads-fmi/series-index
+// under $XDG_CACHE_HOME or ~/.cache. Entries are named by a hash of the
+// canonical path, size and modification time, so data directories stay clean
+// and a rewritten file gets a new entry. Files in the temporary directory, such
+// as downloaded S3 inputs, are indexed for the current run only.
+std::optional<std::string> seriesIndexPath(const std::string& csvPath, const MappedFile& file) {
+    std::error_code ec;
+    const fs::path canonical = fs::canonical(csvPath, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    const fs::path temp = fs::canonical(fs::temp_directory_path(ec), ec);
+    if (!ec && underDirectory(canonical, temp)) {
+        return std::nullopt;
+    }
+    fs::path dir;
+    if (const char* configured = std::getenv("CADS_INDEX_DIR"); configured && *configured) {
+        dir = configured;
+    } else if (const char* cache = std::getenv("XDG_CACHE_HOME"); cache && *cache) {
+        dir = fs::path(cache) / "cads-fmi" / "series-index";
+    } else if (const char* home = std::getenv("HOME"); home && *home) {
+        dir = fs::path(home) / ".cache" / "cads-fmi" / "series-index";
+    } else {
+        return std::nullopt;
+    }
+    fs::create_directories(dir, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    const std::string key =
+        canonical.string() + '\n' + std::to_string(file.size()) + '\n' + std::to_string(file.modified());
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016zx.cads-index", std::hash<std::string>{}(key));
+    return (dir / name).string();
+}
+
+// Whether the entries of a cached index can be used on a file of its recorded
+// size: every offset within the body and entries in file order. The offsets
+// become pointers into the mapping, so a truncated, corrupt or hash-colliding
+// cache entry must not get past this.
+bool seriesIndexFits(const SeriesIndex& index) {
+    const SeriesIndexEntry* previous = nullptr;
+    for (const SeriesIndexEntry& entry : index.entries) {
+        if (entry.offset < index.bodyOffset || entry.offset >= index.fileSize || std::isnan(entry.time)) {
+            return false;
+        }
+        if (previous && (entry.offset < previous->offset || entry.time + 1e-12 < previous->time ||
+                         entry.line <= previous->line)) {
+            return false;
+        }
+        previous = &entry;
+    }
+    return true;
+}
+
+// Returns the cached index when it matches the file, otherwise builds and
+// caches a new one.
+std::optional<SeriesIndex> seriesIndexFor(const InputSeriesConfig& cfg, const MappedFile& file, const char* body,
+                                          const SeriesLayout& layout, size_t lineNumber) {
+    const std::optional<std::string> path = seriesIndexPath(cfg.csvPath, file);
+    const std::uint64_t bodyOffset = static_cast<std::uint64_t>(body - file.begin());
+    std::optional<SeriesIndex> index = path ? readSeriesIndex(*path) : std::nullopt;
+    if (index && index->fileSize == file.size() && index->modified == file.modified() &&
+        index->bodyOffset == bodyOffset && index->dialect == static_cast<std::uint32_t>(cfg.dialect) &&
+        index->stride == kIndexStride && seriesIndexFits(*index)) {
+        return index;
+    }
+    index = buildSeriesIndex(file.begin(), body, file.end(), layout, lineNumber);
+    if (index) {
+        index->fileSize = file.size();
+        index->modified = file.modified();
+        index->bodyOffset = bodyOffset;
+        index->dialect = static_cast<std::uint32_t>(cfg.dialect);
+        if (path) {
+            writeSeriesIndex(*path, *index);
+        }
+    }
+    return index;
+}
+
+// Keeps the rows a run over window can observe: the last row at or before its
+// start and the rows up to its stop.
+void trimSeriesToWindow(const SeriesWindow& window, InputSeriesData& series) {
+    auto& times = series.times;
+    size_t from = static_cast<size_t>(
+        std::upper_bound(times.begin(), times.end(), window.start + 1e-12) - times.begin());
+    from = from > 0 ? from - 1 : 0;
+    size_t to = static_cast<size_t>(std::upper_bound(times.begin(), times.end(), window.stop + 1e-12) - times.begin());
+    to = std::max(from, to);
+    auto trim = [from, to](std::vector<double>& values) {
+        values.erase(values.begin() + static_cast<std::ptrdiff_t>(to), values.end());
+        values.erase(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(from));
+    };
+    trim(times);
+    for (auto& column : series.columns) {
+        trim(column);
+    }
+}
+
+// Parses only the rows a run over window can observe: the last row at or
+// before its start, which holds the inputs when it begins, and the rows up to
+// its stop. The index narrows the parse to those rows plus at most one stride
+// on either side.
+void readSeriesWindow(const InputSeriesConfig& cfg, const MappedFile& file, const SeriesIndex& index,
+                      const SeriesLayout& layout, const SeriesWindow& window, InputSeriesData& series) {
+    // Absorbs rounding between raw AE times and times relative to the origin.
+    constexpr double kSeekSlack = 1e-6;
+    const double origin = layout.aeDialect ? index.entries.front().time : 0.0;
+    auto after = [&index](double time) {
+        return std::upper_bound(index.entries.begin(), index.entries.end(), time,
+                                [](double value, const SeriesIndexEntry& entry) { return value < entry.time; });
+    };
+    auto first = after(window.start + origin - kSeekSlack);
+    if (first != index.entries.begin()) {
+        --first;
+    }
+    auto last = after(window.stop + origin + kSeekSlack);
+    const char* begin = file.begin() + first->offset;
+    const char* end = last == index.entries.end() ? file.end() : file.begin() + last->offset;
+
+    std::vector<SeriesChunk> chunks = parseMappedBody(begin, end, layout);
+    stitchSeries(cfg, layout, chunks, static_cast<size_t>(first->line - 1), series);
+    finishSeries(layout, origin, series);
+
+    trimSeriesToWindow(window, series);
+    if (series.times.empty()) {
+        fail("Input CSV '" + cfg.csvPath + "' does not contain any samples");
+    }
+    if (!std::isnan(index.firstInterval)) {
+        series.firstInterval = index.firstInterval;
+    }
+}
+
+// Supplies the bytes of an input file as a sequence of spans: the mapping
+// itself for plain regular files, decompressed blocks for gzip and zstd files,
+// and read() blocks for pipes, which cannot be mapped.
+class InputByteSource {
+public:
+    explicit InputByteSource(const std::string& path) : path_(path) {
+        struct stat st {};
+        if (::stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+            file_ = std::make_unique<MappedFile>(path);
+            codec_ = detectCodec(file_->begin(), file_->end());
+            if (codec_ != InputCodec::None) {
+                reader_ = std::make_unique<DecompressingReader>(file_->begin(), file_->end(), codec_, path);
+            }
+            return;
+        }
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            fail("Failed opening input '" + path + "'");
+        }
+    }
+
+    InputByteSource(const InputByteSource&) = delete;
+    InputByteSource& operator=(const InputByteSource&) = delete;
+
+    ~InputByteSource() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    // Points data at the next span. Returns false at the end of the input.
+    bool next(const char*& data, size_t& size) {
+        if (reader_) {
+            if (!reader_->next(block_)) {
+                return false;
+            }
+        } else if (file_) {
+            if (mappedDone_) {
+                return false;
+            }
+            mappedDone_ = true;
+            data = file_->begin();
+            size = static_cast<size_t>(file_->end() - file_->begin());
+            return size > 0;
+        } else {
+            block_.resize(kReadBytes);
+            ssize_t got = 0;
+            do {
+                got = ::read(fd_, &block_[0], block_.size());
+            } while (got < 0 && errno == EINTR);
+            if (got < 0) {
+                fail("Failed reading input '" + path_ + "'");
+            }
+            if (got == 0) {
+                return false;
+            }
+            block_.resize(static_cast<size_t>(got));
+        }
+        data = block_.data();
+        size = block_.size();
+        return true;
+    }
+
+private:
+    static constexpr size_t kReadBytes = 1u << 20;
+
+    std::string path_;
+    std::unique_ptr<MappedFile> file_;
+    InputCodec codec_{InputCodec::None};
+    std::unique_ptr<DecompressingReader> reader_;
+    int fd_{-1};
+    std::string block_;
+    bool mappedDone_{false};
+};
+
+// Big-endian reads over an InputByteSource. Values may straddle two spans.
+class BinaryCursor {
+public:
+    explicit BinaryCursor(InputByteSource& source) : source_(source) {}
+
+    // Copies n bytes into out. Returns false when the input ends first.
+    bool read(char* out, size_t n) {
+        while (n > 0) {
+            if (pos_ == size_ && !refill()) {
+                return false;
+            }
+            size_t take = std::min(n, size_ - pos_);
+            std::memcpy(out, data_ + pos_, take);
+            pos_ += take;
+            out += take;
+            n -= take;
+        }
+        return true;
+    }
+
+    bool skip(size_t n) {
+        while (n > 0) {
+            if (pos_ == size_ && !refill()) {
+                return false;
+            }
+            size_t take = std::min(n, size_ - pos_);
+            pos_ += take;
+            n -= take;
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool readBig(T& value) {
+        unsigned char bytes[sizeof(T)];
+        if (!read(reinterpret_cast<char*>(bytes), sizeof(T))) {
+            return false;
+        }
+        std::uint64_t raw = 0;
+        for (unsigned char byte : bytes) {
+            raw = (raw << 8) | byte;
+        }
+        if constexpr (std::is_floating_point_v<T>) {
+            using Bits = std::conditional_t<sizeof(T) == 8, std::uint64_t, std::uint32_t>;
+            Bits bits = static_cast<Bits>(raw);
+            std::memcpy(&value, &bits, sizeof(T));
+        } else {
+            using Unsigned = std::make_unsigned_t<T>;
+            value = static_cast<T>(static_cast<Unsigned>(raw));
+        }
+        return true;
+    }
+
+private:
+    bool refill() {
+        pos_ = 0;
+        size_ = 0;
+        while (size_ == 0) {
+            if (!source_.next(data_, size_)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    InputByteSource& source_;
+    const char* data_{nullptr};
+    size_t size_{0};
+    size_t pos_{0};
+};
+
+// PostgreSQL types a binary COPY field can be decoded from.
+enum class PgType { Float8, Float4, Int8, Int4, Int2, Bool, Timestamp };
+
+std::optional<PgType> parsePgType(const std::string& name) {
+    std::string type = trimCopy(name);
+    std::transform(type.begin(), type.end(), type.begin(), [](unsigned char ch) {
+        return static_cast<char>(std::tolower(ch));
+    });
+    if (type == "float8" || type == "double precision") {
+        return PgType::Float8;
+    }
+    if (type == "float4" || type == "real") {
+        return PgType::Float4;
+    }
+    if (type == "int8" || type == "bigint") {
+        return PgType::Int8;
+    }
+    if (type == "int4" || type == "integer") {
+        return PgType::Int4;
+    }
+    if (type == "int2" || type == "smallint") {
+        return PgType::Int2;
+    }
+    if (type == "bool" || type == "boolean") {
+        return PgType::Bool;
+    }
+    if (type == "timestamp" || type == "timestamptz") {
+        return PgType::Timestamp;
+    }
+    return std::nullopt;
+}
+
+size_t pgTypeSize(PgType type) {
+    switch (type) {
+        case PgType::Float8:
+        case PgType::Int8:
+        case PgType::Timestamp:
+            return 8;
+        case PgType::Float4:
+        case PgType::Int4:
+            return 4;
+        case PgType::Int2:
+            return 2;
+        case PgType::Bool:
+            return 1;
+    }
+    return 0;
+}
+
+// Timestamps are microseconds since 2000-01-01 and are returned in seconds.
+bool readPgValue(BinaryCursor& in, PgType type, double& value) {
+    switch (type) {
+        case PgType::Float8: {
+            double v = 0.0;
+            bool ok = in.readBig(v);
+            value = v;
+            return ok;
+        }
+        case PgType::Float4: {
+            float v = 0.0f;
+            bool ok = in.readBig(v);
+            value = v;
+            return ok;
+        }
+        case PgType::Int8: {
+            std::int64_t v = 0;
+            bool ok = in.readBig(v);
+            value = static_cast<double>(v);
+            return ok;
+        }
+        case PgType::Int4: {
+            std::int32_t v = 0;
+            bool ok = in.readBig(v);
+            value = v;
+            return ok;
+        }
+        case PgType::Int2: {
+            std::int16_t v = 0;
+            bool ok = in.readBig(v);
+            value = v;
+            return ok;
+        }
+        case PgType::Bool: {
+            char v = 0;
+            bool ok = in.read(&v, 1);
+            value = v != 0 ? 1.0 : 0.0;
+            return ok;
+        }
+        case PgType::Timestamp: {
+            std::int64_t v = 0;
+            bool ok = in.readBig(v);
+            value = static_cast<double>(v) / 1e6;
+            return ok;
+        }
+    }
+    return false;
+}
+
+// Decodes a `COPY ... TO STDOUT (FORMAT binary)` stream straight into columns.
+// Binary COPY carries neither names nor types, so cfg.fields lists both in
+// column order; the first field is the time. Timestamp times become seconds
+// since the first row. Fields that are not applied are skipped by length and
+// may have any type.
+InputSeriesData loadPgCopySeries(const InputSeriesConfig& cfg) {
+    if (cfg.fields.empty()) {
+        fail("COPY input '" + cfg.csvPath + "' requires a field list");
+    }
+    InputSeriesData series;
+    SeriesLayout layout;
+    std::vector<std::string> names;
+    for (const auto& field : cfg.fields) {
+        names.push_back(field.name);
+    }
+    buildSeriesLayout(cfg, names, series, layout);
+    std::vector<PgType> types(names.size(), PgType::Float8);
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (i != 0 && layout.slotOf[i] < 0) {
+            continue;
+        }
+        std::optional<PgType> type = parsePgType(cfg.fields[i].value);
+        if (!type) {
+            fail("COPY field '" + names[i] + "' has unsupported type '" + cfg.fields[i].value +
+                 "' (want float8, float4, int8, int4, int2, bool, timestamp or timestamptz)");
+        }
+        types[i] = *type;
+    }
+    if (types[0] == PgType::Bool) {
+        fail("COPY time field '" + names[0] + "' cannot be bool");
+    }
+    // Timestamp times are offset from the first row in whole microseconds, so
+    // epoch-sized values do not cost precision.
+    const bool timestampTime = types[0] == PgType::Timestamp;
+    std::int64_t firstMicros = 0;
+
+    InputByteSource source(cfg.csvPath);
+    BinaryCursor in(source);
+    const std::string where = "COPY input '" + cfg.csvPath + "'";
+    static const char kSignature[11] = {'P', 'G', 'C', 'O', 'P', 'Y', '\n', '\xff', '\r', '\n', '\0'};
+    char signature[sizeof(kSignature)];
+    std::int32_t flags = 0;
+    std::int32_t extension = 0;
+    if (!in.read(signature, sizeof(signature)) || std::memcmp(signature, kSignature, sizeof(signature)) != 0) {
+        fail(where + " is not a binary COPY stream");
+    }
+    if (!in.readBig(flags) || !in.readBig(extension) || extension < 0 || !in.skip(static_cast<size_t>(extension))) {
+        fail(where + " has a truncated header");
+    }
+    const bool hasOids = (flags & (1 << 16)) != 0;
+
+    series.columns.resize(layout.appliedCount);
+    bool trailer = false;
+    for (size_t row = 1;; ++row) {
+        const std::string at = where + " row " + std::to_string(row);
+        std::int16_t count = 0;
+        if (!in.readBig(count)) {
+            break;
+        }
+        if (count == -1) {
+            trailer = true;
+            break;
+        }
+        if (hasOids) {
+            std::int32_t length = 0;
+            if (!in.readBig(length) || (length > 0 && !in.skip(static_cast<size_t>(length)))) {
+                fail(at + " is truncated");
+            }
+        }
+        if (count != static_cast<std::int16_t>(types.size())) {
+            fail(at + " has " + std::to_string(count) + " fields, expected " + std::to_string(types.size()));
+        }
+        double time = 0.0;
+        for (size_t i = 0; i < types.size(); ++i) {
+            std::int32_t length = 0;
+            if (!in.readBig(length)) {
+                fail(at + " is truncated");
+            }
+            const bool used = i == 0 || layout.slotOf[i] >= 0;
+            if (!used) {
+                if (length > 0 && !in.skip(static_cast<size_t>(length))) {
+                    fail(at + " is truncated");
+                }
+                continue;
+            }
+            if (length == -1) {
+                fail(at + " has a NULL '" + names[i] + "'");
+            }
+            if (static_cast<size_t>(length) != pgTypeSize(types[i])) {
+                fail(at + " field '" + names[i] + "' has " + std::to_string(length) + " bytes, expected " +
+                 std::to_string(pgTypeSize(types[i])) + " for " + cfg.fields[i].value);
+            }
+            if (i == 0 && timestampTime) {
+                std::int64_t micros = 0;
+                if (!in.readBig(micros)) {
+                    fail(at + " is truncated");
+                }
+                if (row == 1) {
+                    firstMicros = micros;
+                }
+                time = static_cast<double>(micros - firstMicros) / 1e6;
+                continue;
+            }
+            double value = 0.0;
+            if (!readPgValue(in, types[i], value)) {
+                fail(at + " is truncated");
+            }
+            if (i == 0) {
+                time = value;
+            } else {
+                series.columns[static_cast<size_t>(layout.slotOf[i])].push_back(value);
+            }
+        }
+        if (!series.times.empty() && time + 1e-12 < series.times.back()) {
+            fail(at + " is not sorted by time");
+        }
+        series.times.push_back(time);
+    }
+    if (!trailer) {
+        fail(where + " ends without the COPY trailer");
+    }
+    if (series.times.empty()) {
+        fail(where + " does not contain any rows");
+    }
+    finishSeries(layout, 0.0, series);
+    if (series.times.size() > 1) {
+        series.firstInterval = series.times[1] - series.times[0];
+    }
+    return series;
+}
+
+// Loads the input series of cfg. With a window, large plain files are read
+// through their sparse index instead of being parsed in full.
+InputSeriesData loadInputSeries(const InputSeriesConfig& cfg, const std::optional<SeriesWindow>& window) {
+    if (cfg.dialect == CADS_INPUT_DIALECT_PGCOPY) {
+        return loadPgCopySeries(cfg);
+    }
+    MappedFile file(cfg.csvPath);
+    InputSeriesData series;
+    SeriesLayout layout;
+    size_t lineNumber = 0;
+    std::vector<SeriesChunk> chunks;
+    InputCodec codec = detectCodec(file.begin(), file.end());
+    if (codec == InputCodec::None) {
+        const char* cursor = file.begin();
+        readSeriesHeader(cfg, cursor, file.end(), series, layout, lineNumber);
+        if (window && static_cast<size_t>(file.end() - cursor) >= kIndexedSeriesBytes) {
+            if (std::optional<SeriesIndex> index = seriesIndexFor(cfg, file, cursor, layout, lineNumber)) {
+                readSeriesWindow(cfg, file, *index, layout, *window, series);
+                return series;
+            }
+        }
+        chunks = parseMappedBody(cursor, file.end(), layout);
+    } else {
+        chunks = parseCompressedSeries(cfg, file, codec, series, layout, lineNumber);
+    }
+    stitchSeries(cfg, layout, chunks, lineNumber, series);
+    if (series.times.empty()) {
+        fail("Input CSV '" + cfg.csvPath + "' does not contain any samples");
+    }
+    finishSeries(layout, layout.aeDialect ? series.times.front() : 0.0, series);
+    if (series.times.size() > 1) {
+        series.firstInterval = series.times[1] - series.times[0];
+    }
+    return series;
+}
+
+// Opens a live endpoint: connects when path is a Unix socket, otherwise opens
+// it as a FIFO or file (created and truncated for output).
+int openLiveEndpoint(const std::string& path, bool output) {
+    struct stat st {};
+    if (::stat(path.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) {
+            fail("Live socket path '" + path + "' is too long");
+        }
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            fail("Failed creating socket for '" + path + "'");
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+            ::close(fd);
+            fail("Failed connecting to live socket '" + path + "'");
+        }
+        return fd;
+    }
+    int fd = output ? ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)
+                    : ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fail(std::string("Failed opening live ") + (output ? "output" : "input") + " '" + path + "'");
+    }
+    return fd;
+}
+
+// One live input frame, already mapped onto the applied variables.
+struct LiveSample {
+    double time{0.0};
+    std::vector<double> values;
+    std::chrono::steady_clock::time_point received;
+};
+
+// Reads frames on a background thread into a queue of at most queueDepth
+// samples. A full queue stops the reads, so a producer that outruns the FMU is
+// held back by the pipe or socket buffer instead of growing memory.
+class LiveReader {
+public:
+    explicit LiveReader(const LiveConfig& cfg) : cfg_(cfg) {
+        // Binary frames and CSV frames with a field list have a known layout
+        // before the first byte arrives; CSV without one waits for the header.
+        if (!cfg.fields.empty()) {
+            setLayout(cfg.fields);
+        }
+        fd_ = openLiveEndpoint(cfg.inputPath, false);
+        int wake[2];
+        if (::pipe(wake) != 0) {
+            ::close(fd_);
+            fail("Failed creating live reader wake pipe");
+        }
+        wakeRead_ = wake[0];
+        wakeWrite_ = wake[1];
+        thread_ = std::thread([this] { run(); });
+    }
+
+    LiveReader(const LiveReader&) = delete;
+    LiveReader& operator=(const LiveReader&) = delete;
+
+    ~LiveReader() {
+        {
+            std::lock_guard<std::mutex> guard(mu_);
+            cancelled_ = true;
+        }
+        cv_.notify_all();
+        char byte = 0;
+        (void)!::write(wakeWrite_, &byte, 1);
+        thread_.join();
+        ::close(fd_);
+        ::close(wakeRead_);
+        ::close(wakeWrite_);
+    }
+
+    // Blocks for the next sample, at most until deadline. Returns false once
+    // the input has ended or the deadline has passed, and rethrows read errors.
+    bool pop(LiveSample& sample, const std::optional<std::chrono::steady_clock::time_point>& deadline) {
+        std::unique_lock<std::mutex> lock(mu_);
+        auto ready = [this] { return !queue_.empty() || done_; };
+        if (!deadline) {
+            cv_.wait(lock, ready);
+        } else if (!cv_.wait_until(lock, *deadline, ready)) {
+            return false;
+        }
+        if (!queue_.empty()) {
+            sample = std::move(queue_.front());
+            queue_.pop_front();
+            cv_.notify_all();
+            return true;
+        }
+        if (!error_.empty()) {
+            fail(error_);
+        }
+        return false;
+    }
+
+    // Names of the applied variables, in LiveSample::values order. Valid once
+    // the first sample has been popped.
+    const std::vector<std::string>& variables() const {
+        return variables_;
+    }
+
+    size_t malformed() const {
+        std::lock_guard<std::mutex> guard(mu_);
+        return malformed_;
+    }
+
+private:
+    void setLayout(const std::vector<std::string>& names) {
+        InputSeriesConfig series;
+        series.csvPath = cfg_.inputPath;
+        series.columns = cfg_.columns;
+        InputSeriesData data;
+        buildSeriesLayout(series, names, data, layout_);
+        variables_ = std::move(data.variables);
+        layoutReady_ = true;
+    }
+
+    // Waits until fd_ is readable. Returns false when cancelled.
+    bool waitReadable() {
+        pollfd fds[2] = {{fd_, POLLIN, 0}, {wakeRead_, POLLIN, 0}};
+        for (;;) {
+            int rc = ::poll(fds, 2, -1);
+            if (rc < 0 && errno == EINTR) {
+                continue;
+            }
+            if (rc < 0) {
+                fail("Failed polling live input '" + cfg_.inputPath + "'");
+            }
+            return (fds[1].revents & POLLIN) == 0;
+        }
+    }
+
+    // Returns false when the consumer has gone away.
+    bool push(LiveSample sample) {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this] { return queue_.size() < cfg_.queueDepth || cancelled_; });
+        if (cancelled_) {
+            return false;
+        }
+        queue_.push_back(std::move(sample));
+        cv_.notify_all();
+        return true;
+    }
+
+    bool parseCsvLine(std::string_view line, LiveSample& sample) {
+        sample.values.assign(layout_.appliedCount, 0.0);
+        size_t column = 0;
+        size_t start = 0;
+        for (;;) {
+            size_t comma = line.find(',', start);
+            size_t end = comma == std::string_view::npos ? line.size() : comma;
+            if (column >= layout_.columnCount) {
+                return false;
+            }
+            const char* field = line.data() + start;
+            const char* fieldEnd = line.data() + end;
+            if (column == 0) {
+                if (!parseNumberField(field, fieldEnd, sample.time)) {
+                    return false;
+                }
+                if (layout_.slotOf[0] >= 0) {
+                    sample.values[static_cast<size_t>(layout_.slotOf[0])] = sample.time;
+                }
+            } else if (layout_.slotOf[column] >= 0 &&
+                       !parseNumberField(field, fieldEnd, sample.values[static_cast<size_t>(layout_.slotOf[column])])) {
+                return false;
+            }
+            column += 1;
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            start = comma + 1;
+        }
+        return column == layout_.columnCount;
+    }
+
+    void decodeBinary(const char* record, LiveSample& sample) {
+        sample.values.assign(layout_.appliedCount, 0.0);
+        for (size_t i = 0; i < layout_.columnCount; ++i) {
+            unsigned char bytes[8];
+            std::memcpy(bytes, record + i * 8, 8);
+            std::uint64_t bits = 0;
+            for (int b = 7; b >= 0; --b) {
+                bits = (bits << 8) | bytes[b];
+            }
+            double value = 0.0;
+            std::memcpy(&value, &bits, sizeof(value));
+            if (i == 0) {
+                sample.time = value;
+            }
+            if (layout_.slotOf[i] >= 0) {
+                sample.values[static_cast<size_t>(layout_.slotOf[i])] = value;
+            }
+        }
+    }
+
+    void run() {
+        try {
+            readFrames();
+        } catch (const std::exception& ex) {
+            std::lock_guard<std::mutex> guard(mu_);
+            error_ = ex.what();
+        }
+        {
+            std::lock_guard<std::mutex> guard(mu_);
+            done_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void readFrames() {
+        std::string pending;
+        char buffer[64 * 1024];
+        const size_t recordBytes = layout_.columnCount * 8;
+        for (;;) {
+            if (!waitReadable()) {
+                return;
+            }
+            ssize_t got = ::read(fd_, buffer, sizeof(buffer));
+            if (got < 0 && (errno == EINTR || errno == EAGAIN)) {
+                continue;
+            }
+            if (got < 0) {
+                fail("Failed reading live input '" + cfg_.inputPath + "'");
+            }
+            const bool eof = got == 0;
+            pending.append(buffer, static_cast<size_t>(got));
+            const auto received = std::chrono::steady_clock::now();
+
+            size_t consumed = 0;
+            if (cfg_.format == CADS_LIVE_FORMAT_BINARY) {
+                while (pending.size() - consumed >= recordBytes) {
+                    LiveSample sample;
+                    sample.received = received;
+                    decodeBinary(pending.data() + consumed, sample);
+                    consumed += recordBytes;
+                    if (!push(std::move(sample))) {
+                        return;
+                    }
+                }
+            } else {
+                for (;;) {
+                    size_t newline = pending.find('\n', consumed);
+                    if (newline == std::string::npos) {
+                        if (!eof || consumed == pending.size()) {
+                            break;
+                        }
+                        newline = pending.size();
+                    }
+                    std::string_view line(pending.data() + consumed, newline - consumed);
+                    consumed = std::min(newline + 1, pending.size());
+                    if (!line.empty() && line.back() == '\r') {
+                        line.remove_suffix(1);
+                    }
+                    if (trimCopy(std::string(line)).empty()) {
+                        continue;
+                    }
+                    if (!layoutReady_) {
+                        setLayout(splitCsvLine(std::string(line)));
+                        continue;
+                    }
+                    LiveSample sample;
+                    sample.received = received;
+                    if (!parseCsvLine(line, sample)) {
+                        std::lock_guard<std::mutex> guard(mu_);
+                        malformed_ += 1;
+                        continue;
+                    }
+                    if (!push(std::move(sample))) {
+                        return;
+                    }
+                }
+            }
+            pending.erase(0, consumed);
+            if (eof) {
+                return;
+            }
+        }
+    }
+
+    const LiveConfig& cfg_;
+    int fd_{-1};
+    int wakeRead_{-1};
+    int wakeWrite_{-1};
+    SeriesLayout layout_;
+    std::vector<std::string> variables_;
+    bool layoutReady_{false};
+    mutable std::mutex mu_;
+    std::condition_variable cv_;
+    std::deque<LiveSample> queue_;
+    bool done_{false};
+    bool cancelled_{false};
+    size_t malformed_{0};
+    std::string error_;
+    std::thread thread_;
+};
+
+// Writes one JSON line per sample to the live output endpoint. A reader that
+// goes away surfaces as EPIPE rather than a fatal SIGPIPE: sockets are written
+// with MSG_NOSIGNAL, and for FIFOs and files the Go runtime, whose handler
+// ignores SIGPIPE for descriptors other than stdout and stderr, lets write()
+// fail instead.
+class LiveWriter {
+public:
+    explicit LiveWriter(const std::string& path) : path_(path), fd_(openLiveEndpoint(path, true)) {
+        struct stat st {};
+        socket_ = ::fstat(fd_, &st) == 0 && S_ISSOCK(st.st_mode);
+    }
+
+    LiveWriter(const LiveWriter&) = delete;
+    LiveWriter& operator=(const LiveWriter&) = delete;
+
+    ~LiveWriter() {
+        ::close(fd_);
+    }
+
+    void write(const std::string& line) {
+        const char* data = line.data();
+        size_t left = line.size();
+        while (left > 0) {
+            ssize_t wrote = socket_ ? ::send(fd_, data, left, MSG_NOSIGNAL) : ::write(fd_, data, left);
+            if (wrote < 0 && errno == EINTR) {
+                continue;
+            }
+            if (wrote < 0) {
+                const int error = errno;
+                if (error == EPIPE || error == ECONNRESET) {
+                    fail("Live output '" + path_ + "' was closed by its reader: " + std::strerror(error));
+                }
+                fail("Failed writing live output '" + path_ + "': " + std::strerror(error));
+            }
+            data += wrote;
+            left -= static_cast<size_t>(wrote);
+        }
+    }
+
+private:
+    std::string path_;
+    int fd_{-1};
+    bool socket_{false};
+};
+
+// One input series of a run and the next of its rows to apply.
+struct SeriesCursor {
+    InputSeriesData data;
+    int interpolation{CADS_INPUT_INTERPOLATION_HOLD};
+    size_t next{0};
+    // Input binding of each of data.variables, resolved when the series loads.
+    std::vector<size_t> bindings;
+};
+
+// Defaults missing timings from the input series: the run spans every series
+// and steps at the spacing of the first one's first two rows.
+void alignTimingsWithSeries(StepTimings& timings, const Config& cfg, const std::vector<SeriesCursor>& inputs) {
+    if (inputs.empty()) {
+        return;
+    }
+
+    std::optional<double> first;
+    std::optional<double> last;
+    for (const auto& input : inputs) {
+        if (!input.data.times.empty()) {
+            first = std::min(first.value_or(input.data.times.front()), input.data.times.front());
+            last = std::max(last.value_or(input.data.times.back()), input.data.times.back());
+        }
+    }
+    if (!cfg.startTime && first) {
+        timings.start = *first;
+    }
+    if (!cfg.stopTime && last) {
+        timings.stop = *last;
+    }
+    if (!cfg.stepSize) {
+        const InputSeriesData& series = inputs.front().data;
+        if (series.firstInterval) {
+            if (*series.firstInterval > 0.0) {
+                timings.step = *series.firstInterval;
+            }
+        } else {
+            timings.step = std::max(1e-3, timings.stop - timings.start);
+        }
+    }
+}
+
+std::vector<std::string> buildTraceNames(const TraceConfig& trace) {
+    std::vector<std::string> names;
+    auto appendUnique = [&names](const std::vector<std::string>& values) {
+        for (const auto& value : values) {
+            if (std::find(names.begin(), names.end(), value) == names.end()) {
+                names.push_back(value);
+            }
+        }
+    };
+    appendUnique(trace.outputs);
+    appendUnique(trace.inputs);
+    return names;
+}
+
+double resolveTraceInterval(const Config& cfg, const StepTimings& timings) {
+    if (cfg.trace.sampleEvery) {
+        if (*cfg.trace.sampleEvery <= 0.0) {
+            fail("trace sample interval must be positive");
+        }
+        return *cfg.trace.sampleEvery;
+    }
+    if (timings.step > 0.0) {
+        return timings.step;
+    }
+    return std::max(1e-3, timings.stop - timings.start);
+}
+
+// One co-simulation advanced a communication step at a time. FmiSimulation
+// instantiates and initializes the FMU in its constructor and then calls
+// beginStepping(); advance() performs a single step and returns false once the
+// run is over, run() steps to the end, and finish() reads the outputs and
+// releases the instance.
+// Keeping the loop state in the object instead of on the stack lets a batch
+// worker interleave many small runs on one thread.
+class Simulation {
+public:
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+    virtual ~Simulation() = default;
+
+    // Performs a single communication step and returns false once the run is
+    // done; batch workers interleave runs with it.
+    virtual bool advance() = 0;
+
+    // Steps until the run is done. Runs that yield to interactive work check
+    // the priority gate before every step.
+    virtual void run(bool yieldsToInteractive) = 0;
+
+    FmuExecutionResult finish() {
+        double reached = result_.partial ? current_ : timings_.stop;
+        if (!traceNames_.empty() &&
+            (result_.traceTimes.empty() || std::fabs(result_.traceTimes.back() - reached) > 1e-9)) {
+            captureTrace(reached);
+        }
+        result_.reachedTime = reached;
+
+        for (size_t i = 0; i < outputNames_.size(); ++i) {
+            result_.values[outputNames_[i]] = readOutput(outputBindings_[i]);
+        }
+        for (size_t i = 0; i < traceNames_.size(); ++i) {
+            result_.traceSignals[traceNames_[i]] = std::move(traceColumns_[i]);
+        }
+        for (size_t i = 0; i < snapshotColumns_.size(); ++i) {
+            result_.snapshotValues[outputNames_[i]] = std::move(snapshotColumns_[i]);
+        }
+        shutdown();
+        return std::move(result_);
+    }
+
+    // Drives the run from cfg.live instead of the step loop. The first sample
+    // lands on the start time and later ones keep their spacing; each steps the
+    // FMU up to its time, is applied, and one JSON line of outputs is written.
+    // The run ends when the input closes, a sample passes stop_time (if set),
+    // the FMU terminates or the wall budget runs out.
+    void runLive() {
+        const LiveConfig& live = *cfg_.live;
+        FmuExecutionResult::LiveStats stats;
+        LiveReader reader(live);
+        std::vector<size_t> bindings;
+        for (const auto& variable : reader.variables()) {
+            bindings.push_back(bindInput(variable));
+        }
+        std::optional<LiveWriter> writer;
+        if (!live.outputPath.empty()) {
+            writer.emplace(live.outputPath);
+        }
+        std::optional<double> offset;
+        double previous = current_;
+        LiveSample sample;
+        while (!done_) {
+            if (!reader.pop(sample, budget_.deadline())) {
+                if (budget_.exhausted()) {
+                    result_.partial = true;
+                }
+                break;
+            }
+            if (!offset) {
+                offset = timings_.start - sample.time;
+            }
+            const double time = sample.time + *offset;
+            if (cfg_.stopTime && time > *cfg_.stopTime + 1e-12) {
+                stepTo(*cfg_.stopTime, false);
+                break;
+            }
+            if (time < current_ - 1e-12) {
+                stats.late += 1;
+                continue;
+            }
+            bool jump = false;
+            if (stats.samples > 0 && live.maxGap && time - previous > *live.maxGap) {
+                stats.gaps += 1;
+                if (live.gapPolicy == CADS_LIVE_GAP_FAIL) {
+                    std::ostringstream msg;
+                    msg << "Live input gap of " << (time - previous) << "s at t=" << time
+                        << " exceeds max_gap " << *live.maxGap << "s";
+                    fail(msg.str());
+                }
+                jump = live.gapPolicy == CADS_LIVE_GAP_JUMP;
+            }
+            stepTo(time, jump);
+            if (done_) {
+                break;
+            }
+
+            for (size_t v = 0; v < bindings.size(); ++v) {
+                applyInput(bindings[v], sample.values[v]);
+            }
+            if (!writer) {
+                stats.samples += 1;
+                previous = time;
+                continue;
+            }
+            std::ostringstream line;
+            line.precision(15);
+            line << "{\"time\":";
+            writeJsonFloat(line, time);
+            line << ",\"values\":{";
+            for (size_t i = 0; i < outputNames_.size(); ++i) {
+                if (i > 0) {
+                    line << ",";
+                }
+                line << "\"" << escapeJsonString(outputNames_[i]) << "\":";
+                writeJsonValue(line, readOutput(outputBindings_[i]));
+            }
+            line << "}}\n";
+            writer->write(line.str());
+
+            const std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - sample.received;
+            stats.maxLatencyMs = std::max(stats.maxLatencyMs, latency.count());
+            stats.samples += 1;
+            previous = time;
+        }
+        stats.malformed = reader.malformed();
+        result_.live = stats;
+        // finish() reports the time the live input actually reached.
+        timings_.stop = current_;
+        done_ = true;
+    }
+
+protected:
+    Simulation(const Config& cfg, const WallBudget& budget)
+        : cfg_(cfg), budget_(budget) {
+        result_.budgeted = budget_.enabled();
+    }
+
+    // Returns false when the FMU asked to terminate the simulation.
+    virtual bool doStep(double current, double step) = 0;
+    // Resolves an input variable once; applyInput then sets it by the
+    // returned binding without a name lookup.
+    virtual size_t bindInput(const std::string& variable) = 0;
+    virtual void applyInput(size_t binding, double value) = 0;
+    // Resolves an output, trace or snapshot variable once; readOutput then
+    // reads it by the returned binding.
+    virtual size_t bindOutput(const std::string& name) = 0;
+    virtual OutputValue readOutput(size_t binding) = 0;
+    virtual std::vector<std::string> autoOutputs() = 0;
+    virtual void shutdown() = 0;
+
+    // Loads every input series separately; they are merged by time as the
+    // run advances, so the joined table is never built.
+    void loadSeries() {
+        std::optional<SeriesWindow> window;
+        if (cfg_.startTime && cfg_.stopTime) {
+            window = SeriesWindow{*cfg_.startTime, *cfg_.stopTime};
+        }
+        inputs_.reserve(cfg_.inputSeries.size());
+        for (size_t i = 0; i < cfg_.inputSeries.size(); ++i) {
+            SeriesCursor input;
+            input.data = loadInputSeries(cfg_.inputSeries[i], window);
+            input.interpolation = cfg_.inputSeries[i].interpolation;
+            // Several series keep their metadata apart under "<position>.".
+            const std::string prefix = cfg_.inputSeries.size() > 1 ? std::to_string(i) + "." : "";
+            for (const auto& entry : input.data.metadata) {
+                result_.inputMetadata[prefix + entry.first] = entry.second;
+            }
+            for (const auto& variable : input.data.variables) {
+                input.bindings.push_back(bindInput(variable));
+            }
+            inputs_.push_back(std::move(input));
+        }
+        for (size_t i = 0; i < inputs_.size(); ++i) {
+            if (inputs_[i].interpolation == CADS_INPUT_INTERPOLATION_HOLD && !inputs_[i].data.times.empty()) {
+                heldHeads_.emplace(inputs_[i].data.times.front(), i);
+            }
+        }
+    }
+
+    void alignTimings(StepTimings timings) {
+        alignTimingsWithSeries(timings, cfg_, inputs_);
+        if (timings.step <= 0.0) {
+            timings.step = (timings.stop - timings.start);
+            if (timings.step <= 0.0) {
+                timings.step = 1.0;
+            }
+        }
+        timings_ = timings;
+    }
+
+    // Applies every input up to time. Rows of held series are applied in time
+    // order across files (a k-way merge on each file's next row, ties in list
+    // order), so the latest row wins when series share a variable. The merge
+    // heap lives for the whole run; a step only pops and re-pushes the series
+    // whose rows fall due. Linear series then set their variables to the value
+    // interpolated at time.
+    void applySeriesThrough(double time) {
+        if (inputs_.empty()) {
+            return;
+        }
+        auto due = [time](const SeriesCursor& input) {
+            return input.next < input.data.times.size() && input.data.times[input.next] <= time + 1e-12;
+        };
+        while (!heldHeads_.empty() && heldHeads_.top().first <= time + 1e-12) {
+            const size_t i = heldHeads_.top().second;
+            SeriesCursor& input = inputs_[i];
+            heldHeads_.pop();
+            const size_t row = input.next++;
+            for (size_t v = 0; v < input.bindings.size(); ++v) {
+                applyInput(input.bindings[v], input.data.columns[v][row]);
+            }
+            if (input.next < input.data.times.size()) {
+                heldHeads_.emplace(input.data.times[input.next], i);
+            }
+        }
+
+        for (auto& input : inputs_) {
+            if (input.interpolation != CADS_INPUT_INTERPOLATION_LINEAR) {
+                continue;
+            }
+            while (due(input)) {
+                input.next += 1;
+            }
+            if (input.next == 0) {
+                continue;
+            }
+            const auto& times = input.data.times;
+            const size_t row = input.next - 1;
+            const bool between = input.next < times.size() && times[input.next] > times[row];
+            const double weight = between ? (time - times[row]) / (times[input.next] - times[row]) : 0.0;
+            for (size_t v = 0; v < input.bindings.size(); ++v) {
+                const auto& column = input.data.columns[v];
+                double value = column[row];
+                if (between) {
+                    value += weight * (column[input.next] - column[row]);
+                }
+                applyInput(input.bindings[v], value);
+            }
+        }
+    }
+
+    // Widens the communication step of coalesce_steps runs to max_step, or to
+    // the whole horizon without one. Never narrows the configured step.
+    void coalesceSteps() {
+        const double horizon = timings_.stop - timings_.start;
+        const double widened = cfg_.maxStep ? std::min(*cfg_.maxStep, horizon) : horizon;
+        if (widened > timings_.step) {
+            timings_.step = widened;
+            result_.coalescedStep = widened;
+        }
+    }
+
+    // Whether the run has a stop time to announce to the FMU. Live runs without
+    // stop_time end with their input.
+    bool stopTimeDefined() const {
+        return !cfg_.live || cfg_.stopTime.has_value();
+    }
+
+    // Called once the FMU has left initialization mode.
+    void beginStepping() {
+        outputNames_ = cfg_.outputs.empty() ? autoOutputs() : cfg_.outputs;
+        for (const auto& name : outputNames_) {
+            outputBindings_.push_back(bindOutput(name));
+        }
+        traceNames_ = buildTraceNames(cfg_.trace);
+        for (const auto& name : traceNames_) {
+            traceBindings_.push_back(bindOutput(name));
+        }
+        traceColumns_.resize(traceNames_.size());
+        traceInterval_ = traceNames_.empty() ? 0.0 : resolveTraceInterval(cfg_, timings_);
+        current_ = timings_.start;
+        if (!traceNames_.empty()) {
+            captureTrace(current_);
+        }
+        nextTraceTime_ = current_ + traceInterval_;
+
+        if (!cfg_.outputsAt.empty()) {
+            snapshotColumns_.resize(outputNames_.size());
+            // Times before the start are never reached.
+            const auto& times = cfg_.outputsAt;
+            nextSnapshot_ = std::lower_bound(times.begin(), times.end(), current_ - 1e-12) - times.begin();
+            captureSnapshots();
+        }
+    }
+
+    // Reads the outputs at every outputs_at time the run has reached. Without
+    // split steps that is the first communication point at or after the time,
+    // and the snapshot carries that point's time; requests that land on one
+    // point share a snapshot.
+    void captureSnapshots() {
+        const auto& times = cfg_.outputsAt;
+        bool due = false;
+        while (nextSnapshot_ < times.size() && times[nextSnapshot_] <= current_ + 1e-12) {
+            ++nextSnapshot_;
+            due = true;
+        }
+        if (!due) {
+            return;
+        }
+        result_.snapshotTimes.push_back(snapshotsSplitSteps_ ? times[nextSnapshot_ - 1] : current_);
+        for (size_t i = 0; i < outputBindings_.size(); ++i) {
+            snapshotColumns_[i].push_back(readOutput(outputBindings_[i]));
+        }
+    }
+
+    void captureTrace(double time) {
+        if (traceNames_.empty()) {
+            return;
+        }
+        result_.traceTimes.push_back(time);
+        for (size_t i = 0; i < traceBindings_.size(); ++i) {
+            traceColumns_[i].push_back(readOutput(traceBindings_[i]));
+        }
+    }
+
+    const Config& cfg_;
+    StepTimings timings_;
+    WallBudget budget_;
+    std::vector<SeriesCursor> inputs_;
+    // Next row time and index of every held series with rows left.
+    using SeriesHead = std::pair<double, size_t>;
+    std::priority_queue<SeriesHead, std::vector<SeriesHead>, std::greater<SeriesHead>> heldHeads_;
+    FmuExecutionResult result_;
+    // Outputs (explicit or automatic) with their bindings; outputs_at
+    // snapshots read the same variables.
+    std::vector<std::string> outputNames_;
+    std::vector<size_t> outputBindings_;
+    // Trace samples are collected per binding and moved into the result by
+    // finish().
+    std::vector<std::string> traceNames_;
+    std::vector<size_t> traceBindings_;
+    std::vector<std::vector<OutputValue>> traceColumns_;
+    double traceInterval_{0.0};
+    double current_{0.0};
+    double nextTraceTime_{0.0};
+    std::vector<std::vector<OutputValue>> snapshotColumns_;
+    size_t nextSnapshot_{0};
+    // Whether communication steps are cut at outputs_at times; only for FMUs
+    // that accept variable communication step sizes.
+    bool snapshotsSplitSteps_{true};
+    bool done_{false};
+
+private:
+    // Steps from the current time to time, at the configured step size or, when
+    // jump is set, in a single doStep. Sets done_ when the budget runs out or
+    // the FMU terminates.
+    void stepTo(double time, bool jump) {
+        while (current_ < time - 1e-12) {
+            if (budget_.exhausted()) {
+                result_.partial = true;
+                done_ = true;
+                return;
+            }
+            double next = jump ? time : std::min(current_ + timings_.step, time);
+            if (!traceNames_.empty() && nextTraceTime_ > current_ + 1e-12 && nextTraceTime_ < next - 1e-12) {
+                next = nextTraceTime_;
+            }
+            if (!doStep(current_, next - current_)) {
+                done_ = true;
+                return;
+            }
+            current_ = next;
+            if (!traceNames_.empty() && nextTraceTime_ <= current_ + 1e-12) {
+                captureTrace(current_);
+                nextTraceTime_ += traceInterval_;
+            }
+        }
+    }
+
+};
+
+StepTimings deriveTimingsFmi2(fmi2_import_t* fmu, const Config& cfg) {
+    StepTimings t{};
+    if (cfg.startTime) {
+        t.start = *cfg.startTime;
+    } else if (fmi2_import_get_default_experiment_has_start(fmu)) {
+        t.start = fmi2_import_get_default_experiment_start(fmu);
+    } else {
+        t.start = 0.0;
+    }
+
+    if (cfg.stopTime) {
+        t.stop = *cfg.stopTime;
+    } else if (fmi2_import_get_default_experiment_has_stop(fmu)) {
+        t.stop = fmi2_import_get_default_experiment_stop(fmu);
+    } else {
+        t.stop = t.start + 1.0;
+    }
+
+    if (cfg.stepSize) {
+        t.step = *cfg.stepSize;
+    } else if (fmi2_import_get_default_experiment_has_step(fmu)) {
+        t.step = fmi2_import_get_default_experiment_step(fmu);
+    } else {
+        t.step = std::max(1e-3, (t.stop - t.start));
+    }
+    return t;
+}
+
+StepTimings deriveTimingsFmi3(fmi3_import_t* fmu, const Config& cfg) {
+    StepTimings t{};
+    if (cfg.startTime) {
+        t.start = *cfg.startTime;
+    } else if (fmi3_import_get_default_experiment_has_start(fmu)) {
+        t.start = fmi3_import_get_default_experiment_start(fmu);
+    } else {
+        t.start = 0.0;
+    }
+
+    if (cfg.stopTime) {
+        t.stop = *cfg.stopTime;
+    } else if (fmi3_import_get_default_experiment_has_stop(fmu)) {
+        t.stop = fmi3_import_get_default_experiment_stop(fmu);
+    } else {
+        t.stop = t.start + 1.0;
+    }
+
+    if (cfg.stepSize) {
+        t.step = *cfg.stepSize;
+    } else if (fmi3_import_get_default_experiment_has_step_size(fmu)) {
+        t.step = fmi3_import_get_default_experiment_step_size(fmu);
+    } else {
+        t.step = std::max(1e-3, (t.stop - t.start));
+    }
+    return t;
+}
+
+std::vector<std::string> autoOutputsFmi2(fmi2_import_t* fmu) {
+    std::vector<std::string> names;
+    fmi2_import_variable_list_t* list = fmi2_import_get_variable_list(fmu, 0);
+    size_t n = fmi2_import_get_variable_list_size(list);
+    for (size_t i = 0; i < n; ++i) {
+        fmi2_import_variable_t* var = fmi2_import_get_variable(list, i);
+        fmi2_causality_enu_t causality = fmi2_import_get_causality(var);
+        if (causality == fmi2_causality_enu_output || causality == fmi2_causality_enu_calculated_parameter) {
+            names.emplace_back(fmi2_import_get_variable_name(var));
+        }
+    }
+    fmi2_import_free_variable_list(list);
+    if (names.empty()) {
+        names.push_back("time");
+    }
+    return names;
+}
+
+std::vector<std::string> autoOutputsFmi3(fmi3_import_t* fmu) {
+    std::vector<std::string> names;
+    fmi3_import_variable_list_t* list = fmi3_import_get_variable_list(fmu, 0);
+    size_t n = fmi3_import_get_variable_list_size(list);
+    for (size_t i = 0; i < n; ++i) {
+        fmi3_import_variable_t* var = fmi3_import_get_variable(list, i);
+        fmi3_causality_enu_t causality = fmi3_import_get_variable_causality(var);
+        if (causality == fmi3_causality_enu_output || causality == fmi3_causality_enu_calculated_parameter) {
+            names.emplace_back(fmi3_import_get_variable_name(var));
+        }
+    }
+    fmi3_import_free_variable_list(list);
+    if (names.empty()) {
+        names.push_back("time");
+    }
+    return names;
+}
+
+// An FMI 2.0 input variable resolved for applyInputFmi2.
+struct Fmi2InputBinding {
+    std::string name;
+    fmi2_value_reference_t vr;
+    fmi2_base_type_enu_t type;
+};
+
+Fmi2InputBinding bindInputFmi2(fmi2_import_t* fmu, const std::string& name) {
+    fmi2_import_variable_t* var = fmi2_import_get_variable_by_name(fmu, name.c_str());
+    if (!var) {
+        fail("Unknown variable '" + name + "'");
+    }
+    const fmi2_base_type_enu_t baseType = fmi2_import_get_variable_base_type(var);
+    if (baseType != fmi2_base_type_real && baseType != fmi2_base_type_int && baseType != fmi2_base_type_bool) {
+        fail("Unsupported base type for " + name);
+    }
+    return Fmi2InputBinding{name, fmi2_import_get_variable_vr(var), baseType};
+}
+
+void applyInputFmi2(fmi2_import_t* fmu, const Fmi2InputBinding& input, double value) {
+    switch (input.type) {
+        case fmi2_base_type_real: {
+            fmi2_real_t v = static_cast<fmi2_real_t>(value);
+            if (fmi2_import_set_real(fmu, &input.vr, 1, &v) != fmi2_status_ok) {
+                fail("Failed setting real " + input.name);
+            }
+            break;
+        }
+        case fmi2_base_type_int: {
+            fmi2_integer_t intVal = static_cast<fmi2_integer_t>(std::llround(value));
+            if (fmi2_import_set_integer(fmu, &input.vr, 1, &intVal) != fmi2_status_ok) {
+                fail("Failed setting integer " + input.name);
+            }
+            break;
+        }
+        default: {
+            fmi2_boolean_t boolVal = (value != 0.0) ? fmi2_true : fmi2_false;
+            if (fmi2_import_set_boolean(fmu, &input.vr, 1, &boolVal) != fmi2_status_ok) {
+                fail("Failed setting boolean " + input.name);
+            }
+            break;
+        }
+    }
+}
+
+void applyStartValueFmi2(fmi2_import_t* fmu, const StartValue& start) {
+    fmi2_import_variable_t* var = fmi2_import_get_variable_by_name(fmu, start.name.c_str());
+    if (!var) {
+        fail("Unknown variable '" + start.name + "'");
+    }
+    fmi2_value_reference_t vr = fmi2_import_get_variable_vr(var);
+    switch (fmi2_import_get_variable_base_type(var)) {
+        case fmi2_base_type_real: {
+            fmi2_real_t v = startReal(start);
+            if (fmi2_import_set_real(fmu, &vr, 1, &v) != fmi2_status_ok) {
+                fail("Failed setting real " + start.name);
+            }
+            break;
+        }
+        case fmi2_base_type_int: {
+            fmi2_integer_t v = startInteger<fmi2_integer_t>(start);
+            if (fmi2_import_set_integer(fmu, &vr, 1, &v) != fmi2_status_ok) {
+                fail("Failed setting integer " + start.name);
+            }
+            break;
+        }
+        case fmi2_base_type_bool: {
+            fmi2_boolean_t v = (startReal(start) != 0.0) ? fmi2_true : fmi2_false;
+            if (fmi2_import_set_boolean(fmu, &vr, 1, &v) != fmi2_status_ok) {
+                fail("Failed setting boolean " + start.name);
+            }
+            break;
+        }
+        case fmi2_base_type_str: {
+            fmi2_string_t v = startText(start);
+            if (fmi2_import_set_string(fmu, &vr, 1, &v) != fmi2_status_ok) {
+                fail("Failed setting string " + start.name);
+            }
+            break;
+        }
+        default:
+            fail("Unsupported base type for " + start.name);
+    }
+}
+
+// An FMI 2.0 output, trace or snapshot variable resolved for readOutputFmi2.
+struct Fmi2OutputBinding {
+    std::string name;
+    fmi2_value_reference_t vr;
+    fmi2_base_type_enu_t type;
+};
+
+Fmi2OutputBinding bindOutputFmi2(fmi2_import_t* fmu, const std::string& name) {
+    fmi2_import_variable_t* var = fmi2_import_get_variable_by_name(fmu, name.c_str());
+    if (!var) {
+        fail("Variable '" + name + "' not found");
+    }
+    const fmi2_base_type_enu_t baseType = fmi2_import_get_variable_base_type(var);
+    if (baseType != fmi2_base_type_real && baseType != fmi2_base_type_int && baseType != fmi2_base_type_bool) {
+        fail("Unsupported variable type for " + name);
+    }
+    return Fmi2OutputBinding{name, fmi2_import_get_variable_vr(var), baseType};
+}
+
+OutputValue readOutputFmi2(fmi2_import_t* fmu, const Fmi2OutputBinding& output) {
+    OutputValue ov{};
+    switch (output.type) {
+        case fmi2_base_type_real: {
+            fmi2_real_t value{};
+            fmi2_import_get_real(fmu, &output.vr, 1, &value);
+            ov.type = OutputValue::Type::Real;
+            ov.realVal = value;
+            break;
+        }
+        case fmi2_base_type_int: {
+            fmi2_integer_t iv{};
+            fmi2_import_get_integer(fmu, &output.vr, 1, &iv);
+            ov.type = OutputValue::Type::Integer;
+            ov.intVal = iv;
+            break;
+        }
+        case fmi2_base_type_bool: {
+            fmi2_boolean_t bv{};
+            fmi2_import_get_boolean(fmu, &output.vr, 1, &bv);
+            ov.type = OutputValue::Type::Boolean;
+            ov.boolVal = (bv != fmi2_false);
+            break;
+        }
+        default:
+            fail("Unsupported variable type for " + output.name);
+    }
+    return ov;
+}
+
+size_t checkedMultiply(size_t lhs, size_t rhs, const std::string& what) {
+    if (lhs == 0 || rhs == 0) {
+        fail("Array dimension for " + what + " resolved to zero");
+    }
+    if (lhs > std::numeric_limits<size_t>::max() / rhs) {
+        fail("Array size overflow for " + what);
+    }
+    return lhs * rhs;
 }
 
 size_t normalizeDimensionSize(double value, const std::string& what) {
     if (!std::isfinite(value) || value <= 0.0) {
         fail("Array dimension for " + what + " must be a positive finite number");
     }
-    double rounded = std::round(value);
-    if (std::fabs(value - rounded) > 1e-9) {
-        fail("Array dimension for " + what + " must be an integer");
+    double rounded = std::round(value);
+    if (std::fabs(value - rounded) > 1e-9) {
+        fail("Array dimension for " + what + " must be an integer");
+    }
+    if (rounded > static_cast<double>(std::numeric_limits<size_t>::max())) {
+        fail("Array dimension for " + what + " is too large");
+    }
+    return static_cast<size_t>(rounded);
+}
+
+size_t readFmi3SizeVariable(fmi3_import_t* fmu, fmi3_import_variable_t* var, const std::string& owner) {
+    if (!var) {
+        fail("Missing dimension variable for " + owner);
+    }
+    if (fmi3_import_variable_is_array(var)) {
+        fail("Array-valued dimension variables are not supported for " + owner);
+    }
+
+    fmi3_value_reference_t vr = fmi3_import_get_variable_vr(var);
+    fmi3_base_type_enu_t baseType = fmi3_import_get_variable_base_type(var);
+
+    switch (baseType) {
+        case fmi3_base_type_float64: {
+            fmi3_float64_t value{};
+            if (fmi3_import_get_float64(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
+                fail("Failed reading float64 dimension for " + owner);
+            }
+            return normalizeDimensionSize(value, owner);
+        }
+        case fmi3_base_type_float32: {
+            fmi3_float32_t value{};
+            if (fmi3_import_get_float32(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
+                fail("Failed reading float32 dimension for " + owner);
+            }
+            return normalizeDimensionSize(value, owner);
+        }
+        case fmi3_base_type_int64: {
+            fmi3_int64_t value{};
+            if (fmi3_import_get_int64(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
+                fail("Failed reading int64 dimension for " + owner);
+            }
+            return normalizeDimensionSize(static_cast<double>(value), owner);
+        }
+        case fmi3_base_type_int32: {
+            fmi3_int32_t value{};
+            if (fmi3_import_get_int32(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
+                fail("Failed reading int32 dimension for " + owner);
+            }
+            return normalizeDimensionSize(static_cast<double>(value), owner);
+        }
+        case fmi3_base_type_int16: {
+            fmi3_int16_t value{};
+            if (fmi3_import_get_int16(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
+                fail("Failed reading int16 dimension for " + owner);
+            }
+            return normalizeDimensionSize(static_cast<double>(value), owner);
+        }
+        case fmi3_base_type_int8: {
+            fmi3_int8_t value{};
+            if (fmi3_import_get_int8(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
+                fail("Failed reading int8 dimension for " + owner);
+            }
+            return normalizeDimensionSize(static_cast<double>(value), owner);
+        }
+        case fmi3_base_type_uint64: {
+            fmi3_uint64_t value{};
+            if (fmi3_import_get_uint64(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
+                fail("Failed reading uint64 dimension for " + owner);
+            }
+            if (value > std::numeric_limits<size_t>::max()) {
+                fail("Array dimension for " + owner + " is too large");
+            }
+            return static_cast<size_t>(value);
+        }
+        case fmi3_base_type_uint32: {
+            fmi3_uint32_t value{};
+            if (fmi3_import_get_uint32(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
+                fail("Failed reading uint32 dimension for " + owner);
+            }
+            return static_cast<size_t>(value);
+        }
+        case fmi3_base_type_uint16: {
+            fmi3_uint16_t value{};
+            if (fmi3_import_get_uint16(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
+                fail("Failed reading uint16 dimension for " + owner);
+            }
+            return static_cast<size_t>(value);
+        }
+        case fmi3_base_type_uint8: {
+            fmi3_uint8_t value{};
+            if (fmi3_import_get_uint8(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
+                fail("Failed reading uint8 dimension for " + owner);
+            }
+            return static_cast<size_t>(value);
+        }
+        default:
+            fail("Unsupported dimension base type for " + owner);
+    }
+}
+
+size_t resolveFmi3ValueCount(fmi3_import_t* fmu, fmi3_import_variable_t* var, const std::string& name) {
+    if (!fmi3_import_variable_is_array(var)) {
+        return 1;
+    }
+
+    fmi3_import_dimension_list_t* dims = fmi3_import_get_variable_dimension_list(var);
+    if (!dims) {
+        fail("Missing dimension metadata for array output " + name);
+    }
+
+    size_t count = 1;
+    size_t dimCount = fmi3_import_get_dimension_list_size(dims);
+    if (dimCount == 0) {
+        fail("Array output " + name + " does not define any dimensions");
+    }
+    for (size_t i = 0; i < dimCount; ++i) {
+        fmi3_import_dimension_t* dim = fmi3_import_get_dimension(dims, i);
+        if (!dim) {
+            fail("Failed reading dimension metadata for array output " + name);
+        }
+
+        size_t dimSize = 0;
+        if (fmi3_import_get_dimension_has_start(dim)) {
+            fmi3_uint64_t start = fmi3_import_get_dimension_start(dim);
+            if (start > std::numeric_limits<size_t>::max()) {
+                fail("Array dimension for " + name + " is too large");
+            }
+            dimSize = static_cast<size_t>(start);
+            if (dimSize == 0) {
+                fail("Array dimension for " + name + " resolved to zero");
+            }
+        } else if (fmi3_import_get_dimension_has_vr(dim)) {
+            fmi3_value_reference_t dimVR = fmi3_import_get_dimension_vr(dim);
+            fmi3_import_variable_t* dimVar = fmi3_import_get_variable_by_vr(fmu, dimVR);
+            dimSize = readFmi3SizeVariable(fmu, dimVar, name);
+        } else {
+            fail("Array dimension for " + name + " is missing both start and valueReference");
+        }
+        count = checkedMultiply(count, dimSize, name);
+    }
+    return count;
+}
+
+FmuCapabilities capabilitiesFmi2(fmi2_import_t* fmu, const std::string& unpackDir) {
+    FmuCapabilities caps;
+    caps.modelIdentifier = nonNull(fmi2_import_get_model_identifier_CS(fmu));
+    caps.token = nonNull(fmi2_import_get_GUID(fmu));
+    caps.onlyOncePerProcess = fmi2_import_get_capability(fmu, fmi2_cs_canBeInstantiatedOnlyOncePerProcess) != 0;
+    caps.pythonFmu = looksLikePythonFmu(fmi2_import_get_generation_tool(fmu), unpackDir);
+    return caps;
+}
+
+// FMI 2.0 calls behind FmiSimulation.
+struct Fmi2Traits {
+    using Import = fmi2_import_t;
+    using ScopedImport = ScopedFmu2;
+    static constexpr const char* kKind = "fmi2";
+
+    static Import* parse(fmi_import_context_t* ctx, const std::string& unpackDir) {
+        Import* fmu = fmi2_import_parse_xml(ctx, unpackDir.c_str(), nullptr);
+        if (!fmu) {
+            fail("Failed parsing FMI2 XML");
+        }
+        if (fmi2_import_get_fmu_kind(fmu) != fmi2_fmu_kind_cs) {
+            fmi2_import_free(fmu);
+            fail("FMU is not Co-Simulation");
+        }
+        return fmu;
+    }
+
+    static FmuCapabilities capabilities(Import* fmu, const std::string& unpackDir) {
+        return capabilitiesFmi2(fmu, unpackDir);
+    }
+
+    static void instantiate(Import* fmu) {
+        fmi2_callback_functions_t callbacks{};
+        callbacks.allocateMemory = calloc;
+        callbacks.freeMemory = free;
+        callbacks.logger = fmi2LoggerCallback;
+        callbacks.componentEnvironment = nullptr;
+
+        if (fmi2_import_create_dllfmu(fmu, fmi2_fmu_kind_cs, &callbacks) != jm_status_success) {
+            fail("Failed loading FMU binaries");
+        }
+
+        if (fmi2_import_instantiate(fmu, "cads-runner", fmi2_cosimulation, nullptr, fmi2_false) != jm_status_success) {
+            fail("Failed to instantiate FMI2 FMU");
+        }
+    }
+
+    static StepTimings timings(Import* fmu, const Config& cfg) {
+        return deriveTimingsFmi2(fmu, cfg);
+    }
+
+    static bool variableStepSize(Import* fmu) {
+        return fmi2_import_get_capability(fmu, fmi2_cs_canHandleVariableCommunicationStepSize) != 0;
+    }
+
+    static void enterInitialization(Import* fmu, double start, bool stopDefined, double stop) {
+        double tolerance = fmi2_import_get_default_experiment_has_tolerance(fmu)
+                               ? fmi2_import_get_default_experiment_tolerance(fmu)
+                               : 1e-4;
+
+        if (fmi2_import_setup_experiment(fmu, fmi2_true, tolerance, start,
+                                         stopDefined ? fmi2_true : fmi2_false, stop) != fmi2_status_ok) {
+            fail("fmi2_setup_experiment failed");
+        }
+
+        if (fmi2_import_enter_initialization_mode(fmu) != fmi2_status_ok) {
+            fail("Failed entering initialization mode");
+        }
+    }
+
+    static void exitInitialization(Import* fmu) {
+        if (fmi2_import_exit_initialization_mode(fmu) != fmi2_status_ok) {
+            fail("Failed exiting initialization mode");
+        }
+    }
+
+    static void applyStartValue(Import* fmu, const StartValue& start) {
+        applyStartValueFmi2(fmu, start);
+    }
+
+    static bool doStep(Import* fmu, double current, double step) {
+        if (fmi2_import_do_step(fmu, current, step, fmi2_true) != fmi2_status_ok) {
+            fail("fmi2_do_step failed");
+        }
+        return true;
+    }
+
+    using InputBinding = Fmi2InputBinding;
+
+    static InputBinding bindInput(Import* fmu, const std::string& variable) {
+        return bindInputFmi2(fmu, variable);
+    }
+
+    static void applyInput(Import* fmu, const InputBinding& input, double value) {
+        applyInputFmi2(fmu, input, value);
+    }
+
+    using OutputBinding = Fmi2OutputBinding;
+
+    static OutputBinding bindOutput(Import* fmu, const std::string& name) {
+        return bindOutputFmi2(fmu, name);
+    }
+
+    static OutputValue readOutput(Import* fmu, const OutputBinding& output) {
+        return readOutputFmi2(fmu, output);
+    }
+
+    static std::vector<std::string> autoOutputs(Import* fmu) {
+        return autoOutputsFmi2(fmu);
+    }
+
+    static void shutdown(Import* fmu) {
+        fmi2_import_terminate(fmu);
+        fmi2_import_free_instance(fmu);
+        fmi2_import_destroy_dllfmu(fmu);
+    }
+};
+
+// An FMI 3.0 input variable resolved for applyInputFmi3.
+struct Fmi3InputBinding {
+    std::string name;
+    fmi3_value_reference_t vr;
+    fmi3_base_type_enu_t type;
+};
+
+Fmi3InputBinding bindInputFmi3(fmi3_import_t* fmu, const std::string& name) {
+    fmi3_import_variable_t* var = fmi3_import_get_variable_by_name(fmu, name.c_str());
+    if (!var) {
+        fail("Unknown variable '" + name + "'");
+    }
+    const fmi3_base_type_enu_t baseType = fmi3_import_get_variable_base_type(var);
+    if (baseType != fmi3_base_type_float64 && baseType != fmi3_base_type_int32 && baseType != fmi3_base_type_bool) {
+        fail("Unsupported FMI3 base type for " + name);
+    }
+    return Fmi3InputBinding{name, fmi3_import_get_variable_vr(var), baseType};
+}
+
+void applyInputFmi3(fmi3_import_t* fmu, const Fmi3InputBinding& input, double value) {
+    switch (input.type) {
+        case fmi3_base_type_float64: {
+            fmi3_float64_t v = static_cast<fmi3_float64_t>(value);
+            if (fmi3_import_set_float64(fmu, &input.vr, 1, &v, 1) != fmi3_status_ok) {
+                fail("Failed setting real " + input.name);
+            }
+            break;
+        }
+        case fmi3_base_type_int32: {
+            fmi3_int32_t iv = static_cast<fmi3_int32_t>(std::llround(value));
+            if (fmi3_import_set_int32(fmu, &input.vr, 1, &iv, 1) != fmi3_status_ok) {
+                fail("Failed setting integer " + input.name);
+            }
+            break;
+        }
+        default: {
+            fmi3_boolean_t bv = (value != 0.0) ? fmi3_true : fmi3_false;
+            if (fmi3_import_set_boolean(fmu, &input.vr, 1, &bv, 1) != fmi3_status_ok) {
+                fail("Failed setting boolean " + input.name);
+            }
+            break;
+        }
+    }
+}
+
+void applyStartValueFmi3(fmi3_import_t* fmu, const StartValue& start) {
+    fmi3_import_variable_t* var = fmi3_import_get_variable_by_name(fmu, start.name.c_str());
+    if (!var) {
+        fail("Unknown variable '" + start.name + "'");
+    }
+    fmi3_value_reference_t vr = fmi3_import_get_variable_vr(var);
+    switch (fmi3_import_get_variable_base_type(var)) {
+        case fmi3_base_type_float64: {
+            fmi3_float64_t v = startReal(start);
+            if (fmi3_import_set_float64(fmu, &vr, 1, &v, 1) != fmi3_status_ok) {
+                fail("Failed setting real " + start.name);
+            }
+            break;
+        }
+        case fmi3_base_type_int32: {
+            fmi3_int32_t v = startInteger<fmi3_int32_t>(start);
+            if (fmi3_import_set_int32(fmu, &vr, 1, &v, 1) != fmi3_status_ok) {
+                fail("Failed setting integer " + start.name);
+            }
+            break;
+        }
+        case fmi3_base_type_int64: {
+            fmi3_int64_t v = startInteger<fmi3_int64_t>(start);
+            if (fmi3_import_set_int64(fmu, &vr, 1, &v, 1) != fmi3_status_ok) {
+                fail("Failed setting integer " + start.name);
+            }
+            break;
+        }
+        case fmi3_base_type_bool: {
+            fmi3_boolean_t v = (startReal(start) != 0.0) ? fmi3_true : fmi3_false;
+            if (fmi3_import_set_boolean(fmu, &vr, 1, &v, 1) != fmi3_status_ok) {
+                fail("Failed setting boolean " + start.name);
+            }
+            break;
+        }
+        case fmi3_base_type_str: {
+            fmi3_string_t v = startText(start);
+            if (fmi3_import_set_string(fmu, &vr, 1, &v, 1) != fmi3_status_ok) {
+                fail("Failed setting string " + start.name);
+            }
+            break;
+        }
+        default:
+            fail("Unsupported FMI3 base type for " + start.name);
+    }
+}
+
+// An FMI 3.0 output, trace or snapshot variable resolved for readOutputFmi3.
+// Arrays keep the variable so their size is resolved at read time, since it
+// can follow structural parameters.
+struct Fmi3OutputBinding {
+    std::string name;
+    fmi3_value_reference_t vr;
+    fmi3_base_type_enu_t type;
+    fmi3_import_variable_t* array;
+};
+
+Fmi3OutputBinding bindOutputFmi3(fmi3_import_t* fmu, const std::string& name) {
+    fmi3_import_variable_t* var = fmi3_import_get_variable_by_name(fmu, name.c_str());
+    if (!var) {
+        fail("Variable '" + name + "' not found");
     }
-    if (rounded > static_cast<double>(std::numeric_limits<size_t>::max())) {
-        fail("Array dimension for " + what + " is too large");
+    const fmi3_base_type_enu_t baseType = fmi3_import_get_variable_base_type(var);
+    if (baseType != fmi3_base_type_float64 && baseType != fmi3_base_type_int32 && baseType != fmi3_base_type_bool) {
+        fail("Unsupported variable type for " + name);
     }
-    return static_cast<size_t>(rounded);
+    return Fmi3OutputBinding{name, fmi3_import_get_variable_vr(var), baseType,
+                             fmi3_import_variable_is_array(var) ? var : nullptr};
 }
 
-size_t readFmi3SizeVariable(fmi3_import_t* fmu, fmi3_import_variable_t* var, const std::string& owner) {
-    if (!var) {
-        fail("Missing dimension variable for " + owner);
+OutputValue readOutputFmi3(fmi3_import_t* fmu, const Fmi3OutputBinding& output) {
+    const std::string& name = output.name;
+    const fmi3_value_reference_t& vr = output.vr;
+    size_t valueCount = output.array ? resolveFmi3ValueCount(fmu, output.array, name) : 1;
+    OutputValue ov{};
+    switch (output.type) {
+        case fmi3_base_type_float64: {
+            std::vector<fmi3_float64_t> values(valueCount);
+            if (fmi3_import_get_float64(fmu, &vr, 1, values.data(), valueCount) != fmi3_status_ok) {
+                fail("Failed reading float64 output " + name);
+            }
+            if (valueCount == 1) {
+                ov.type = OutputValue::Type::Real;
+                ov.realVal = values[0];
+            } else {
+                ov.type = OutputValue::Type::RealArray;
+                ov.realArray.assign(values.begin(), values.end());
+            }
+            break;
+        }
+        case fmi3_base_type_int32: {
+            std::vector<fmi3_int32_t> values(valueCount);
+            if (fmi3_import_get_int32(fmu, &vr, 1, values.data(), valueCount) != fmi3_status_ok) {
+                fail("Failed reading int32 output " + name);
+            }
+            if (valueCount == 1) {
+                ov.type = OutputValue::Type::Integer;
+                ov.intVal = values[0];
+            } else {
+                ov.type = OutputValue::Type::IntegerArray;
+                ov.intArray.reserve(values.size());
+                for (fmi3_int32_t value : values) {
+                    ov.intArray.push_back(value);
+                }
+            }
+            break;
+        }
+        case fmi3_base_type_bool: {
+            std::unique_ptr<fmi3_boolean_t[]> rawValues(new fmi3_boolean_t[valueCount]);
+            if (fmi3_import_get_boolean(fmu, &vr, 1, rawValues.get(), valueCount) != fmi3_status_ok) {
+                fail("Failed reading boolean output " + name);
+            }
+            if (valueCount == 1) {
+                ov.type = OutputValue::Type::Boolean;
+                ov.boolVal = (rawValues[0] != fmi3_false);
+            } else {
+                ov.type = OutputValue::Type::BooleanArray;
+                ov.boolArray.reserve(valueCount);
+                for (size_t i = 0; i < valueCount; ++i) {
+                    ov.boolArray.push_back(rawValues[i] != fmi3_false);
+                }
+            }
+            break;
+        }
+        default:
+            fail("Unsupported variable type for " + name);
     }
-    if (fmi3_import_variable_is_array(var)) {
-        fail("Array-valued dimension variables are not supported for " + owner);
+    return ov;
+}
+
+FmuCapabilities capabilitiesFmi3(fmi3_import_t* fmu, const std::string& unpackDir) {
+    FmuCapabilities caps;
+    caps.modelIdentifier = nonNull(fmi3_import_get_model_identifier_CS(fmu));
+    caps.token = nonNull(fmi3_import_get_instantiation_token(fmu));
+    caps.onlyOncePerProcess = fmi3_import_get_capability(fmu, fmi3_cs_canBeInstantiatedOnlyOncePerProcess) != 0;
+    caps.pythonFmu = looksLikePythonFmu(fmi3_import_get_generation_tool(fmu), unpackDir);
+    return caps;
+}
+
+// FMI 3.0 calls behind FmiSimulation.
+struct Fmi3Traits {
+    using Import = fmi3_import_t;
+    using ScopedImport = ScopedFmu3;
+    static constexpr const char* kKind = "fmi3";
+
+    static Import* parse(fmi_import_context_t* ctx, const std::string& unpackDir) {
+        Import* fmu = fmi3_import_parse_xml(ctx, unpackDir.c_str(), nullptr);
+        if (!fmu) {
+            fail("Failed parsing FMI3 XML");
+        }
+        if (fmi3_import_get_fmu_kind(fmu) != fmi3_fmu_kind_cs) {
+            fmi3_import_free(fmu);
+            fail("FMI3 FMU is not Co-Simulation");
+        }
+        return fmu;
     }
 
-    fmi3_value_reference_t vr = fmi3_import_get_variable_vr(var);
-    fmi3_base_type_enu_t baseType = fmi3_import_get_variable_base_type(var);
+    static FmuCapabilities capabilities(Import* fmu, const std::string& unpackDir) {
+        return capabilitiesFmi3(fmu, unpackDir);
+    }
 
-    switch (baseType) {
-        case fmi3_base_type_float64: {
-            fmi3_float64_t value{};
-            if (fmi3_import_get_float64(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
-                fail("Failed reading float64 dimension for " + owner);
+    static void instantiate(Import* fmu) {
+        if (fmi3_import_create_dllfmu(fmu, fmi3_fmu_kind_cs, nullptr, nullptr) != jm_status_success) {
+            fail("Failed loading FMI3 binaries");
+        }
+
+        if (fmi3_import_instantiate_co_simulation(
+                fmu, "cads-runner", nullptr, fmi3_false, fmi3_false,
+                fmi3_false, fmi3_false, nullptr, 0, nullptr) != jm_status_success) {
+            fail("Failed instantiating FMI3 FMU");
+        }
+    }
+
+    static StepTimings timings(Import* fmu, const Config& cfg) {
+        return deriveTimingsFmi3(fmu, cfg);
+    }
+
+    static bool variableStepSize(Import* fmu) {
+        return fmi3_import_get_capability(fmu, fmi3_cs_canHandleVariableCommunicationStepSize) != 0;
+    }
+
+    static void enterInitialization(Import* fmu, double start, bool stopDefined, double stop) {
+        double tolerance = fmi3_import_get_default_experiment_has_tolerance(fmu)
+                               ? fmi3_import_get_default_experiment_tolerance(fmu)
+                               : 1e-4;
+
+        if (fmi3_import_enter_initialization_mode(
+                fmu, fmi3_true, tolerance, start,
+                stopDefined ? fmi3_true : fmi3_false, stop) != fmi3_status_ok) {
+            fail("Failed entering FMI3 initialization");
+        }
+    }
+
+    static void exitInitialization(Import* fmu) {
+        if (fmi3_import_exit_initialization_mode(fmu) != fmi3_status_ok) {
+            fail("Failed exiting FMI3 initialization");
+        }
+    }
+
+    static void applyStartValue(Import* fmu, const StartValue& start) {
+        applyStartValueFmi3(fmu, start);
+    }
+
+    static bool doStep(Import* fmu, double current, double step) {
+        fmi3_boolean_t eventNeeded = fmi3_false;
+        fmi3_boolean_t terminate = fmi3_false;
+        fmi3_boolean_t earlyReturn = fmi3_false;
+        fmi3_float64_t lastSuccessfulTime{};
+        if (fmi3_import_do_step(
+                fmu, current, step, fmi3_false,
+                &eventNeeded, &terminate, &earlyReturn, &lastSuccessfulTime) != fmi3_status_ok) {
+            fail("fmi3_do_step failed");
+        }
+        return terminate != fmi3_true;
+    }
+
+    using InputBinding = Fmi3InputBinding;
+
+    static InputBinding bindInput(Import* fmu, const std::string& variable) {
+        return bindInputFmi3(fmu, variable);
+    }
+
+    static void applyInput(Import* fmu, const InputBinding& input, double value) {
+        applyInputFmi3(fmu, input, value);
+    }
+
+    using OutputBinding = Fmi3OutputBinding;
+
+    static OutputBinding bindOutput(Import* fmu, const std::string& name) {
+        return bindOutputFmi3(fmu, name);
+    }
+
+    static OutputValue readOutput(Import* fmu, const OutputBinding& output) {
+        return readOutputFmi3(fmu, output);
+    }
+
+    static std::vector<std::string> autoOutputs(Import* fmu) {
+        return autoOutputsFmi3(fmu);
+    }
+
+    static void shutdown(Import* fmu) {
+        fmi3_import_terminate(fmu);
+        fmi3_import_free_instance(fmu);
+        fmi3_import_destroy_dllfmu(fmu);
+    }
+};
+
+// One simulation of either FMI version. The step loop is instantiated for
+// every combination of the features that cost something per step (trace
+// sampling, input series, a wall budget, outputs_at snapshots) and the matching instance is picked
+// once when stepping begins, so a plain run pays a direct do_step call and the
+// stop-time check per communication point.
+template <class Traits>
+class FmiSimulation final : public Simulation {
+public:
+    FmiSimulation(const Config& cfg, const std::string& unpackDir, fmi_import_context_t* ctx, const WallBudget& budget)
+        : Simulation(cfg, budget), fmu_(Traits::parse(ctx, unpackDir)) {
+        const FmuCapabilities caps = Traits::capabilities(fmu_.fmu, unpackDir);
+        admission_ = AdmissionRegistry::instance().admit(caps, cfg.allowIsolation);
+        preparePythonFmu(caps, unpackDir);
+
+        Traits::instantiate(fmu_.fmu);
+
+        loadSeries();
+        alignTimings(Traits::timings(fmu_.fmu, cfg));
+        const bool variableStep = Traits::variableStepSize(fmu_.fmu);
+        if (cfg.coalesceSteps && variableStep) {
+            coalesceSteps();
+        }
+        snapshotsSplitSteps_ = variableStep;
+
+        Traits::enterInitialization(fmu_.fmu, timings_.start, stopTimeDefined(), timings_.stop);
+        for (const auto& entry : cfg.startValues) {
+            Traits::applyStartValue(fmu_.fmu, entry);
+        }
+        applySeriesThrough(timings_.start);
+        Traits::exitInitialization(fmu_.fmu);
+
+        beginStepping();
+        selectLoop(std::make_integer_sequence<unsigned, kVariants>{});
+    }
+
+    bool advance() override {
+        return (this->*step_)();
+    }
+
+    void run(bool yieldsToInteractive) override {
+        (this->*run_)(yieldsToInteractive);
+    }
+
+protected:
+    bool doStep(double current, double step) override {
+        return Traits::doStep(fmu_.fmu, current, step);
+    }
+
+    size_t bindInput(const std::string& variable) override {
+        inputBindings_.push_back(Traits::bindInput(fmu_.fmu, variable));
+        return inputBindings_.size() - 1;
+    }
+
+    void applyInput(size_t binding, double value) override {
+        Traits::applyInput(fmu_.fmu, inputBindings_[binding], value);
+    }
+
+    size_t bindOutput(const std::string& name) override {
+        boundOutputs_.push_back(Traits::bindOutput(fmu_.fmu, name));
+        return boundOutputs_.size() - 1;
+    }
+
+    OutputValue readOutput(size_t binding) override {
+        return Traits::readOutput(fmu_.fmu, boundOutputs_[binding]);
+    }
+
+    std::vector<std::string> autoOutputs() override {
+        return Traits::autoOutputs(fmu_.fmu);
+    }
+
+    void shutdown() override {
+        Traits::shutdown(fmu_.fmu);
+    }
+
+private:
+    using StepFn = bool (FmiSimulation::*)();
+    using RunFn = void (FmiSimulation::*)(bool);
+
+    // Per-step features a loop instance is compiled with.
+    enum : unsigned {
+        kTrace = 1u << 0,
+        kInputs = 1u << 1,
+        kBudget = 1u << 2,
+        kSnapshots = 1u << 3,
+        kVariants = 1u << 4,
+    };
+
+    // Performs one communication step; returns false once the run is done.
+    template <unsigned kFeatures>
+    bool step() {
+        for (;;) {
+            if (done_) {
+                return false;
             }
-            return normalizeDimensionSize(value, owner);
+            if (current_ >= timings_.stop - 1e-12) {
+                done_ = true;
+                return false;
+            }
+            if constexpr ((kFeatures & kBudget) != 0) {
+                if (budget_.exhausted()) {
+                    result_.partial = true;
+                    done_ = true;
+                    return false;
+                }
+            }
+            double next = std::min(current_ + timings_.step, timings_.stop);
+            if constexpr ((kFeatures & kTrace) != 0) {
+                if (nextTraceTime_ < next - 1e-12) {
+                    next = nextTraceTime_;
+                }
+            }
+            if constexpr ((kFeatures & kSnapshots) != 0) {
+                if (snapshotsSplitSteps_ && nextSnapshot_ < cfg_.outputsAt.size() &&
+                    cfg_.outputsAt[nextSnapshot_] < next - 1e-12) {
+                    next = cfg_.outputsAt[nextSnapshot_];
+                }
+            }
+            if (next <= current_ + 1e-12) {
+                if constexpr ((kFeatures & kInputs) != 0) {
+                    applySeriesThrough(current_);
+                }
+                if constexpr ((kFeatures & kTrace) != 0) {
+                    if (nextTraceTime_ <= current_ + 1e-12) {
+                        captureTrace(current_);
+                        nextTraceTime_ += traceInterval_;
+                        continue;
+                    }
+                }
+                fail(std::string(Traits::kKind) + " execution stalled due to zero-length step");
+            }
+            if (!Traits::doStep(fmu_.fmu, current_, next - current_)) {
+                done_ = true;
+                return false;
+            }
+            current_ = next;
+            if constexpr ((kFeatures & kInputs) != 0) {
+                applySeriesThrough(current_);
+            }
+            if constexpr ((kFeatures & kTrace) != 0) {
+                if (nextTraceTime_ <= current_ + 1e-12) {
+                    captureTrace(current_);
+                    nextTraceTime_ += traceInterval_;
+                }
+            }
+            if constexpr ((kFeatures & kSnapshots) != 0) {
+                captureSnapshots();
+            }
+            return true;
         }
-        case fmi3_base_type_float32: {
-            fmi3_float32_t value{};
-            if (fmi3_import_get_float32(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
-                fail("Failed reading float32 dimension for " + owner);
+    }
+
+    template <unsigned kFeatures>
+    void runSteps(bool yieldsToInteractive) {
+        if (yieldsToInteractive) {
+            do {
+                PriorityGate::instance().yieldIfPressured();
+            } while (step<kFeatures>());
+            return;
+        }
+        while (step<kFeatures>()) {
+        }
+    }
+
+    template <unsigned... kFeatures>
+    void selectLoop(std::integer_sequence<unsigned, kFeatures...>) {
+        static constexpr StepFn kSteps[] = {&FmiSimulation::step<kFeatures>...};
+        static constexpr RunFn kRuns[] = {&FmiSimulation::runSteps<kFeatures>...};
+        const unsigned features = (traceNames_.empty() ? 0u : kTrace) | (inputs_.empty() ? 0u : kInputs) |
+                                  (budget_.enabled() ? kBudget : 0u) |
+                                  (cfg_.outputsAt.empty() ? 0u : kSnapshots);
+        step_ = kSteps[features];
+        run_ = kRuns[features];
+    }
+
+    // Declared first so the slot is released only after the FMU is freed.
+    AdmissionTicket admission_;
+    typename Traits::ScopedImport fmu_;
+    std::vector<typename Traits::InputBinding> inputBindings_;
+    std::vector<typename Traits::OutputBinding> boundOutputs_;
+    StepFn step_{nullptr};
+    RunFn run_{nullptr};
+};
+
+InputSeriesConfig inputSeriesFromC(const cads_input_series& source) {
+    if (!source.csv_path || source.csv_path[0] == '\0') {
+        fail("Input series CSV path is required");
+    }
+    InputSeriesConfig series;
+    series.csvPath = source.csv_path;
+    if (source.dialect != CADS_INPUT_DIALECT_PLAIN && source.dialect != CADS_INPUT_DIALECT_AE &&
+        source.dialect != CADS_INPUT_DIALECT_PGCOPY) {
+        fail("Unknown input series dialect " + std::to_string(source.dialect));
+    }
+    series.dialect = source.dialect;
+    if (source.interpolation != CADS_INPUT_INTERPOLATION_HOLD &&
+        source.interpolation != CADS_INPUT_INTERPOLATION_LINEAR) {
+        fail("Unknown input series interpolation " + std::to_string(source.interpolation));
+    }
+    series.interpolation = source.interpolation;
+    if (source.columns && source.column_count > 0) {
+        series.columns.reserve(source.column_count);
+        for (size_t i = 0; i < source.column_count; ++i) {
+            const cads_assignment& column = source.columns[i];
+            if (!column.name || !column.value || column.name[0] == '\0' || column.value[0] == '\0') {
+                fail("Input series column mappings must include both column and variable");
             }
-            return normalizeDimensionSize(value, owner);
+            series.columns.push_back({column.name, column.value});
         }
-        case fmi3_base_type_int64: {
-            fmi3_int64_t value{};
-            if (fmi3_import_get_int64(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
-                fail("Failed reading int64 dimension for " + owner);
+    }
+    if (source.ignore_columns && source.ignore_column_count > 0) {
+        series.ignore.reserve(source.ignore_column_count);
+        for (size_t i = 0; i < source.ignore_column_count; ++i) {
+            const char* name = source.ignore_columns[i];
+            if (!name) {
+                fail("Ignored input column name cannot be null");
             }
-            return normalizeDimensionSize(static_cast<double>(value), owner);
+            series.ignore.emplace_back(name);
         }
-        case fmi3_base_type_int32: {
-            fmi3_int32_t value{};
-            if (fmi3_import_get_int32(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
-                fail("Failed reading int32 dimension for " + owner);
+    }
+    if (source.fields && source.field_count > 0) {
+        series.fields.reserve(source.field_count);
+        for (size_t i = 0; i < source.field_count; ++i) {
+            const cads_assignment& field = source.fields[i];
+            if (!field.name || !field.value || field.name[0] == '\0' || field.value[0] == '\0') {
+                fail("Input series fields must include both name and type");
             }
-            return normalizeDimensionSize(static_cast<double>(value), owner);
+            series.fields.push_back({field.name, field.value});
+        }
+    }
+    return series;
+}
+
+Config fromCConfig(const cads_fmu_config& cfg) {
+    Config result;
+    if (!cfg.fmu_path) {
+        fail("FMU path is required");
+    }
+    result.fmuPath = cfg.fmu_path;
+    if (cfg.has_start_time) {
+        result.startTime = cfg.start_time;
+    }
+    if (cfg.has_stop_time) {
+        result.stopTime = cfg.stop_time;
+    }
+    if (cfg.has_step_size) {
+        result.stepSize = cfg.step_size;
+    }
+    if (cfg.start_values && cfg.start_value_count > 0) {
+        result.startValues.reserve(cfg.start_value_count);
+        for (size_t i = 0; i < cfg.start_value_count; ++i) {
+            const cads_assignment& entry = cfg.start_values[i];
+            if (!entry.name || !entry.value) {
+                fail("Start values must include both name and value");
+            }
+            StartValue value;
+            value.name = entry.name;
+            value.real = parseNumber(entry.value);
+            result.startValues.push_back(std::move(value));
+        }
+    }
+    if (cfg.typed_start_value_count > 0) {
+        if (!cfg.typed_start_values) {
+            fail("Typed start values cannot be null");
+        }
+        if (cfg.string_table_size > 0 && !cfg.string_table) {
+            fail("String table cannot be null");
+        }
+        auto tableString = [&cfg](const cads_string_ref& ref) {
+            if (ref.offset > cfg.string_table_size || ref.length > cfg.string_table_size - ref.offset) {
+                fail("Start value string lies outside the string table");
+            }
+            return ref.length == 0 ? std::string() : std::string(cfg.string_table + ref.offset, ref.length);
+        };
+        result.startValues.reserve(result.startValues.size() + cfg.typed_start_value_count);
+        for (size_t i = 0; i < cfg.typed_start_value_count; ++i) {
+            const cads_start_value& entry = cfg.typed_start_values[i];
+            StartValue value;
+            value.name = tableString(entry.name);
+            value.type = entry.type;
+            switch (entry.type) {
+                case CADS_VALUE_REAL:
+                    if (!std::isfinite(entry.value.real)) {
+                        fail("Start value " + value.name + " is not finite");
+                    }
+                    value.real = entry.value.real;
+                    break;
+                case CADS_VALUE_INTEGER:
+                    value.integer = entry.value.integer;
+                    break;
+                case CADS_VALUE_BOOLEAN:
+                    value.boolean = entry.value.boolean;
+                    break;
+                case CADS_VALUE_STRING:
+                    value.text = tableString(entry.value.text);
+                    break;
+                default:
+                    fail("Start value " + value.name + " has unknown type " + std::to_string(entry.type));
+            }
+            result.startValues.push_back(std::move(value));
+        }
+    }
+    if (cfg.input_series_count > 0 && !cfg.input_series) {
+        fail("Input series list cannot be null");
+    }
+    for (size_t n = 0; n < cfg.input_series_count; ++n) {
+        result.inputSeries.push_back(inputSeriesFromC(cfg.input_series[n]));
+    }
+    if (cfg.live) {
+        const cads_live_input& source = *cfg.live;
+        if (!result.inputSeries.empty()) {
+            fail("Live input cannot be combined with input series");
+        }
+        if (!source.input_path || source.input_path[0] == '\0') {
+            fail("Live input path is required");
+        }
+        LiveConfig live;
+        live.inputPath = source.input_path;
+        if (source.output_path) {
+            live.outputPath = source.output_path;
+        }
+        if (source.format != CADS_LIVE_FORMAT_CSV && source.format != CADS_LIVE_FORMAT_BINARY) {
+            fail("Unknown live input format " + std::to_string(source.format));
         }
-        case fmi3_base_type_int16: {
-            fmi3_int16_t value{};
-            if (fmi3_import_get_int16(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
-                fail("Failed reading int16 dimension for " + owner);
+        live.format = source.format;
+        if (source.columns && source.column_count > 0) {
+            live.columns.reserve(source.column_count);
+            for (size_t i = 0; i < source.column_count; ++i) {
+                const cads_assignment& column = source.columns[i];
+                if (!column.name || !column.value || column.name[0] == '\0' || column.value[0] == '\0') {
+                    fail("Live input column mappings must include both field and variable");
+                }
+                live.columns.push_back({column.name, column.value});
             }
-            return normalizeDimensionSize(static_cast<double>(value), owner);
         }
-        case fmi3_base_type_int8: {
-            fmi3_int8_t value{};
-            if (fmi3_import_get_int8(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
-                fail("Failed reading int8 dimension for " + owner);
+        if (source.fields && source.field_count > 0) {
+            live.fields.reserve(source.field_count);
+            for (size_t i = 0; i < source.field_count; ++i) {
+                const char* name = source.fields[i];
+                if (!name || name[0] == '\0') {
+                    fail("Live input field name cannot be empty");
+                }
+                live.fields.emplace_back(name);
             }
-            return normalizeDimensionSize(static_cast<double>(value), owner);
         }
-        case fmi3_base_type_uint64: {
-            fmi3_uint64_t value{};
-            if (fmi3_import_get_uint64(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
-                fail("Failed reading uint64 dimension for " + owner);
+        if (live.format == CADS_LIVE_FORMAT_BINARY && live.fields.size() < 2) {
+            fail("Live binary input requires a time field and at least one value field");
+        }
+        if (source.queue_depth > 0) {
+            live.queueDepth = source.queue_depth;
+        }
+        if (source.has_max_gap) {
+            if (!(source.max_gap > 0.0)) {
+                fail("Live input max_gap must be positive");
             }
-            if (value > std::numeric_limits<size_t>::max()) {
-                fail("Array dimension for " + owner + " is too large");
+            live.maxGap = source.max_gap;
+        }
+        if (source.gap_policy != CADS_LIVE_GAP_STEP && source.gap_policy != CADS_LIVE_GAP_JUMP &&
+            source.gap_policy != CADS_LIVE_GAP_FAIL) {
+            fail("Unknown live input gap policy " + std::to_string(source.gap_policy));
+        }
+        live.gapPolicy = source.gap_policy;
+        result.live = std::move(live);
+    }
+    if (cfg.outputs && cfg.output_count > 0) {
+        result.outputs.reserve(cfg.output_count);
+        for (size_t i = 0; i < cfg.output_count; ++i) {
+            const char* name = cfg.outputs[i];
+            if (!name) {
+                fail("Output name cannot be null");
             }
-            return static_cast<size_t>(value);
+            result.outputs.emplace_back(name);
         }
-        case fmi3_base_type_uint32: {
-            fmi3_uint32_t value{};
-            if (fmi3_import_get_uint32(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
-                fail("Failed reading uint32 dimension for " + owner);
+    }
+    if (cfg.outputs_at && cfg.outputs_at_count > 0) {
+        if (result.live) {
+            fail("Live input cannot be combined with outputs_at");
+        }
+        result.outputsAt.assign(cfg.outputs_at, cfg.outputs_at + cfg.outputs_at_count);
+        for (double time : result.outputsAt) {
+            if (!std::isfinite(time)) {
+                fail("outputs_at times must be finite");
             }
-            return static_cast<size_t>(value);
         }
-        case fmi3_base_type_uint16: {
-            fmi3_uint16_t value{};
-            if (fmi3_import_get_uint16(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
-                fail("Failed reading uint16 dimension for " + owner);
+        std::sort(result.outputsAt.begin(), result.outputsAt.end());
+        result.outputsAt.erase(std::unique(result.outputsAt.begin(), result.outputsAt.end()), result.outputsAt.end());
+    }
+    if (cfg.trace_outputs && cfg.trace_output_count > 0) {
+        result.trace.outputs.reserve(cfg.trace_output_count);
+        for (size_t i = 0; i < cfg.trace_output_count; ++i) {
+            const char* name = cfg.trace_outputs[i];
+            if (!name) {
+                fail("Trace output name cannot be null");
             }
-            return static_cast<size_t>(value);
+            result.trace.outputs.emplace_back(name);
         }
-        case fmi3_base_type_uint8: {
-            fmi3_uint8_t value{};
-            if (fmi3_import_get_uint8(fmu, &vr, 1, &value, 1) != fmi3_status_ok) {
-                fail("Failed reading uint8 dimension for " + owner);
+    }
+    if (cfg.trace_inputs && cfg.trace_input_count > 0) {
+        result.trace.inputs.reserve(cfg.trace_input_count);
+        for (size_t i = 0; i < cfg.trace_input_count; ++i) {
+            const char* name = cfg.trace_inputs[i];
+            if (!name) {
+                fail("Trace input name cannot be null");
             }
-            return static_cast<size_t>(value);
+            result.trace.inputs.emplace_back(name);
         }
-        default:
-            fail("Unsupported dimension base type for " + owner);
     }
+    if (cfg.has_trace_interval) {
+        result.trace.sampleEvery = cfg.trace_interval;
+    }
+    result.allowIsolation = cfg.allow_isolation;
+    if (cfg.priority != CADS_PRIORITY_INTERACTIVE && cfg.priority != CADS_PRIORITY_BATCH) {
+        fail("Unknown run priority " + std::to_string(cfg.priority));
+    }
+    result.priority = cfg.priority;
+    if (cfg.has_wall_budget) {
+        if (!(cfg.wall_budget > 0.0)) {
+            fail("wall budget must be positive");
+        }
+        result.wallBudget = cfg.wall_budget;
+    }
+    if (cfg.has_max_step) {
+        if (!cfg.coalesce_steps) {
+            fail("max_step requires coalesce_steps");
+        }
+        if (!(cfg.max_step > 0.0)) {
+            fail("max_step must be positive");
+        }
+        result.maxStep = cfg.max_step;
+    }
+    if (cfg.coalesce_steps) {
+        if (result.trace.enabled() || !result.inputSeries.empty() || result.live) {
+            fail("coalesce_steps cannot be combined with trace, input series or live input");
+        }
+        result.coalesceSteps = true;
+    }
+    return result;
 }
 
-size_t resolveFmi3ValueCount(fmi3_import_t* fmu, fmi3_import_variable_t* var, const std::string& name) {
-    if (!fmi3_import_variable_is_array(var)) {
-        return 1;
-    }
+// One signal of an operator step, sorted by time.
+struct Signal {
+    std::vector<double> times;
+    std::vector<double> values;
+};
 
-    fmi3_import_dimension_list_t* dims = fmi3_import_get_variable_dimension_list(var);
-    if (!dims) {
-        fail("Missing dimension metadata for array output " + name);
-    }
+struct OperatorConfig {
+    int op{CADS_OP_SCALE};
+    Signal signal;
+    std::optional<InputSeriesConfig> inputSeries;
+    // Span of inputSeries the operator reads.
+    std::optional<SeriesWindow> seriesWindow;
+    double window{0.0};
+    double interval{0.0};
+    int interpolation{CADS_INPUT_INTERPOLATION_LINEAR};
+    double quantile{0.5};
+    double factor{1.0};
+    double offset{0.0};
+    double level{0.0};
+};
 
-    size_t count = 1;
-    size_t dimCount = fmi3_import_get_dimension_list_size(dims);
-    if (dimCount == 0) {
-        fail("Array output " + name + " does not define any dimensions");
+OperatorConfig operatorFromC(const cads_operator_config& cfg) {
+    OperatorConfig result;
+    if (cfg.op < CADS_OP_SCALE || cfg.op > CADS_OP_QUANTILE) {
+        fail("Unknown operator " + std::to_string(cfg.op));
     }
-    for (size_t i = 0; i < dimCount; ++i) {
-        fmi3_import_dimension_t* dim = fmi3_import_get_dimension(dims, i);
-        if (!dim) {
-            fail("Failed reading dimension metadata for array output " + name);
+    result.op = cfg.op;
+    if (cfg.input_series) {
+        if (cfg.count > 0) {
+            fail("Operator input must be either samples or an input series");
         }
-
-        size_t dimSize = 0;
-        if (fmi3_import_get_dimension_has_start(dim)) {
-            fmi3_uint64_t start = fmi3_import_get_dimension_start(dim);
-            if (start > std::numeric_limits<size_t>::max()) {
-                fail("Array dimension for " + name + " is too large");
-            }
-            dimSize = static_cast<size_t>(start);
-            if (dimSize == 0) {
-                fail("Array dimension for " + name + " resolved to zero");
+        result.inputSeries = inputSeriesFromC(*cfg.input_series);
+        result.interpolation = result.inputSeries->interpolation;
+        if (cfg.has_start_time != cfg.has_stop_time) {
+            fail("Operator input series needs both start_time and stop_time or neither");
+        }
+        if (cfg.has_start_time) {
+            if (!(cfg.start_time <= cfg.stop_time)) {
+                fail("Operator start_time must not be after stop_time");
             }
-        } else if (fmi3_import_get_dimension_has_vr(dim)) {
-            fmi3_value_reference_t dimVR = fmi3_import_get_dimension_vr(dim);
-            fmi3_import_variable_t* dimVar = fmi3_import_get_variable_by_vr(fmu, dimVR);
-            dimSize = readFmi3SizeVariable(fmu, dimVar, name);
-        } else {
-            fail("Array dimension for " + name + " is missing both start and valueReference");
+            result.seriesWindow = SeriesWindow{cfg.start_time, cfg.stop_time};
         }
-        count = checkedMultiply(count, dimSize, name);
+    } else {
+        if (cfg.has_start_time || cfg.has_stop_time) {
+            fail("Operator start_time and stop_time apply only to input series");
+        }
+        if (cfg.count > 0 && (!cfg.times || !cfg.values)) {
+            fail("Operator samples cannot be null");
+        }
+        result.signal.times.assign(cfg.times, cfg.times + cfg.count);
+        result.signal.values.assign(cfg.values, cfg.values + cfg.count);
+        if (cfg.interpolation != CADS_INPUT_INTERPOLATION_HOLD &&
+            cfg.interpolation != CADS_INPUT_INTERPOLATION_LINEAR) {
+            fail("Unknown operator interpolation " + std::to_string(cfg.interpolation));
+        }
+        result.interpolation = cfg.interpolation;
     }
-    return count;
+    switch (cfg.op) {
+        case CADS_OP_ROLLING_MEAN:
+        case CADS_OP_ROLLING_QUANTILE:
+            if (!(cfg.window > 0.0)) {
+                fail("Operator window must be positive");
+            }
+            break;
+        case CADS_OP_RESAMPLE:
+            if (!(cfg.interval > 0.0)) {
+                fail("Operator interval must be positive");
+            }
+            break;
+    }
+    if ((cfg.op == CADS_OP_ROLLING_QUANTILE || cfg.op == CADS_OP_QUANTILE) &&
+        !(cfg.quantile >= 0.0 && cfg.quantile <= 1.0)) {
+        fail("Operator quantile must be within [0, 1]");
+    }
+    result.window = cfg.window;
+    result.interval = cfg.interval;
+    result.quantile = cfg.quantile;
+    result.factor = cfg.factor;
+    result.offset = cfg.offset;
+    result.level = cfg.level;
+    return result;
 }
 
-FmuExecutionResult runFmi2(const Config& cfg, const std::string& unpackDir, fmi_import_context_t* ctx) {
-    ScopedFmu2 fmu(fmi2_import_parse_xml(ctx, unpackDir.c_str(), nullptr));
-    if (!fmu.fmu) {
-        fail("Failed parsing FMI2 XML");
+// Loads the operator's signal, limited to the rows its series window covers.
+// metadata receives the preamble of AE input series.
+Signal loadOperatorSignal(OperatorConfig& cfg, std::map<std::string, std::string>& metadata) {
+    if (!cfg.inputSeries) {
+        return std::move(cfg.signal);
     }
-
-    if (fmi2_import_get_fmu_kind(fmu.fmu) != fmi2_fmu_kind_cs) {
-        fail("FMU is not Co-Simulation");
+    InputSeriesData data = loadInputSeries(*cfg.inputSeries, cfg.seriesWindow);
+    metadata = std::move(data.metadata);
+    if (cfg.seriesWindow) {
+        // Small files are parsed whole even with a window.
+        trimSeriesToWindow(*cfg.seriesWindow, data);
     }
-
-    fmi2_callback_functions_t callbacks{};
-    callbacks.allocateMemory = calloc;
-    callbacks.freeMemory = free;
-    callbacks.logger = fmi2LoggerCallback;
-    callbacks.componentEnvironment = nullptr;
-
-    if (fmi2_import_create_dllfmu(fmu.fmu, fmi2_fmu_kind_cs, &callbacks) != jm_status_success) {
-        fail("Failed loading FMU binaries");
+    if (data.variables.size() != 1) {
+        fail("Operator input series must apply exactly one column, got " + std::to_string(data.variables.size()));
     }
+    Signal signal;
+    signal.times = std::move(data.times);
+    signal.values = std::move(data.columns.front());
+    return signal;
+}
 
-    if (fmi2_import_instantiate(fmu.fmu, "cads-runner", fmi2_cosimulation, nullptr, fmi2_false) != jm_status_success) {
-        fail("Failed to instantiate FMI2 FMU");
+// Quantile of sorted values, interpolated between the two closest ranks.
+double sortedQuantile(const double* sorted, size_t count, double q) {
+    const double rank = q * static_cast<double>(count - 1);
+    const size_t lower = static_cast<size_t>(rank);
+    if (lower + 1 >= count) {
+        return sorted[count - 1];
     }
+    return sorted[lower] + (rank - static_cast<double>(lower)) * (sorted[lower + 1] - sorted[lower]);
+}
 
-    std::optional<InputSeriesData> inputSeries;
-    if (cfg.inputSeries) {
-        inputSeries = loadInputSeries(*cfg.inputSeries);
-    }
+// The kernels below keep their inner loops free of calls and branches on
+// data-independent state so the compiler can vectorize them.
 
-    StepTimings timings = deriveTimingsFmi2(fmu.fmu, cfg);
-    alignTimingsWithSeries(timings, cfg, inputSeries);
-    if (timings.step <= 0.0) {
-        timings.step = (timings.stop - timings.start);
-        if (timings.step <= 0.0) {
-            timings.step = 1.0;
-        }
+void scaleValues(std::vector<double>& values, double factor, double offset) {
+    double* data = values.data();
+    const size_t count = values.size();
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = data[i] * factor + offset;
     }
+}
 
-    double tolerance = fmi2_import_get_default_experiment_has_tolerance(fmu.fmu)
-                           ? fmi2_import_get_default_experiment_tolerance(fmu.fmu)
-                           : 1e-4;
-
-    if (fmi2_import_setup_experiment(fmu.fmu, fmi2_true, tolerance, timings.start, fmi2_true, timings.stop) != fmi2_status_ok) {
-        fail("fmi2_setup_experiment failed");
+void thresholdValues(std::vector<double>& values, double level) {
+    double* data = values.data();
+    const size_t count = values.size();
+    for (size_t i = 0; i < count; ++i) {
+        data[i] = data[i] >= level ? 1.0 : 0.0;
     }
+}
 
-    if (fmi2_import_enter_initialization_mode(fmu.fmu) != fmi2_status_ok) {
-        fail("Failed entering initialization mode");
+// Running sum with Neumaier compensation, so adding and removing samples over
+// a long signal does not accumulate rounding error.
+class CompensatedSum {
+public:
+    void add(double value) {
+        const double total = sum_ + value;
+        if (std::fabs(sum_) >= std::fabs(value)) {
+            compensation_ += (sum_ - total) + value;
+        } else {
+            compensation_ += (value - total) + sum_;
+        }
+        sum_ = total;
     }
 
-    for (const auto& entry : cfg.startValues) {
-        applyStartValueFmi2(fmu.fmu, entry);
+    double value() const {
+        return sum_ + compensation_;
     }
 
-    size_t nextInputIndex = 0;
-    auto applySeriesThrough = [&](double time) {
-        if (!inputSeries) {
-            return;
+private:
+    double sum_{0.0};
+    double compensation_{0.0};
+};
+
+// Mean of the window's samples that have a value; a window without any is
+// NaN. The window slides by adding entering and subtracting leaving samples.
+std::vector<double> rollingMean(const Signal& signal, double window) {
+    const size_t count = signal.values.size();
+    std::vector<double> out(count);
+    CompensatedSum sum;
+    size_t present = 0;
+    size_t first = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isnan(signal.values[i])) {
+            sum.add(signal.values[i]);
+            ++present;
         }
-        while (nextInputIndex < inputSeries->points.size() &&
-               inputSeries->points[nextInputIndex].time <= time + 1e-12) {
-            applySeriesPointFmi2(fmu.fmu, inputSeries->points[nextInputIndex]);
-            nextInputIndex += 1;
+        while (signal.times[first] <= signal.times[i] - window) {
+            if (!std::isnan(signal.values[first])) {
+                sum.add(-signal.values[first]);
+                --present;
+            }
+            ++first;
         }
-    };
-    applySeriesThrough(timings.start);
+        out[i] = present > 0 ? sum.value() / static_cast<double>(present) : std::nan("");
+    }
+    return out;
+}
 
-    if (fmi2_import_exit_initialization_mode(fmu.fmu) != fmi2_status_ok) {
-        fail("Failed exiting initialization mode");
+// Keeps the window's values sorted; entering and leaving samples are placed by
+// binary search, so each step costs O(log w) comparisons plus one memmove.
+std::vector<double> rollingQuantile(const Signal& signal, double window, double q) {
+    const size_t count = signal.values.size();
+    std::vector<double> out(count);
+    std::vector<double> sorted;
+    size_t first = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const double value = signal.values[i];
+        sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), value), value);
+        while (signal.times[first] <= signal.times[i] - window) {
+            sorted.erase(std::lower_bound(sorted.begin(), sorted.end(), signal.values[first]));
+            ++first;
+        }
+        out[i] = sortedQuantile(sorted.data(), sorted.size(), q);
     }
+    return out;
+}
 
-    FmuExecutionResult result;
-    std::vector<std::string> traceNames = buildTraceNames(cfg.trace);
-    double traceInterval = traceNames.empty() ? 0.0 : resolveTraceInterval(cfg, timings);
-    auto captureTrace = [&](double time) {
-        if (traceNames.empty()) {
-            return;
+// Resampled signals are held in memory and serialized whole, so their length
+// is capped.
+constexpr size_t kMaxResamplePoints = 10'000'000;
+
+Signal resampleSignal(const Signal& signal, double interval, int interpolation) {
+    const double start = signal.times.front();
+    const double steps = std::floor((signal.times.back() - start) / interval + 1e-9);
+    if (!(steps < static_cast<double>(kMaxResamplePoints))) {
+        std::ostringstream msg;
+        msg << "Operator resample at interval " << interval << " would produce more than " << kMaxResamplePoints
+            << " points";
+        fail(msg.str());
+    }
+    const size_t points = static_cast<size_t>(steps) + 1;
+    Signal out;
+    out.times.resize(points);
+    out.values.resize(points);
+    size_t row = 0;
+    for (size_t k = 0; k < points; ++k) {
+        const double time = start + static_cast<double>(k) * interval;
+        while (row + 1 < signal.times.size() && signal.times[row + 1] <= time + 1e-12) {
+            ++row;
         }
-        result.traceTimes.push_back(time);
-        for (const auto& name : traceNames) {
-            result.traceSignals[name].push_back(readVariableFmi2(fmu.fmu, name));
+        double value = signal.values[row];
+        if (interpolation == CADS_INPUT_INTERPOLATION_LINEAR && row + 1 < signal.times.size() &&
+            signal.times[row + 1] > signal.times[row]) {
+            const double weight = (time - signal.times[row]) / (signal.times[row + 1] - signal.times[row]);
+            value += weight * (signal.values[row + 1] - signal.values[row]);
         }
-    };
+        out.times[k] = time;
+        out.values[k] = value;
+    }
+    return out;
+}
 
-    double current = timings.start;
-    if (!traceNames.empty()) {
-        captureTrace(current);
-    }
-    double nextTraceTime = current + traceInterval;
-    while (current < timings.stop - 1e-12) {
-        double next = std::min(current + timings.step, timings.stop);
-        if (!traceNames.empty() && nextTraceTime < next - 1e-12) {
-            next = nextTraceTime;
-        }
-        if (next <= current + 1e-12) {
-            applySeriesThrough(current);
-            if (!traceNames.empty() && nextTraceTime <= current + 1e-12) {
-                captureTrace(current);
-                nextTraceTime += traceInterval;
-                continue;
+std::string serializeOperatorJson(double value, const Signal* signal,
+                                  const std::map<std::string, std::string>& metadata) {
+    std::string out = "{\"value\":";
+    appendJsonFloat(out, value);
+    if (!metadata.empty()) {
+        out += ",\"input_metadata\":{";
+        bool first = true;
+        for (const auto& [key, entry] : metadata) {
+            if (!first) {
+                out += ',';
             }
-            fail("fmi2 execution stalled due to zero-length step");
+            first = false;
+            out += "\"" + escapeJsonString(key) + "\":\"" + escapeJsonString(entry) + "\"";
         }
-        double step = next - current;
-        if (fmi2_import_do_step(fmu.fmu, current, step, fmi2_true) != fmi2_status_ok) {
-            fail("fmi2_do_step failed");
+        out += '}';
+    }
+    if (signal) {
+        out.reserve(out.size() + signal->times.size() * 24 + 64);
+        out += ",\"trace\":{\"time\":[";
+        for (size_t i = 0; i < signal->times.size(); ++i) {
+            if (i > 0) {
+                out += ',';
+            }
+            appendJsonFloat(out, signal->times[i]);
         }
-        current = next;
-        applySeriesThrough(current);
-        if (!traceNames.empty() && nextTraceTime <= current + 1e-12) {
-            captureTrace(current);
-            nextTraceTime += traceInterval;
+        out += "],\"signals\":{\"value\":[";
+        for (size_t i = 0; i < signal->values.size(); ++i) {
+            if (i > 0) {
+                out += ',';
+            }
+            appendJsonFloat(out, signal->values[i]);
         }
+        out += "]}}";
     }
+    out += "}";
+    return out;
+}
 
-    if (!traceNames.empty() && (result.traceTimes.empty() || std::fabs(result.traceTimes.back() - timings.stop) > 1e-9)) {
-        captureTrace(timings.stop);
+std::string runOperator(OperatorConfig& cfg) {
+    std::map<std::string, std::string> metadata;
+    Signal signal = loadOperatorSignal(cfg, metadata);
+    if (signal.values.empty()) {
+        fail("Operator input is empty");
     }
-
-    std::vector<std::string> outputs = cfg.outputs.empty() ? autoOutputsFmi2(fmu.fmu) : cfg.outputs;
-    for (const auto& name : outputs) {
-        result.values[name] = readVariableFmi2(fmu.fmu, name);
+    for (size_t i = 1; i < signal.times.size(); ++i) {
+        if (signal.times[i] < signal.times[i - 1]) {
+            fail("Operator input times must be sorted");
+        }
     }
-
-    fmi2_import_terminate(fmu.fmu);
-    fmi2_import_free_instance(fmu.fmu);
-    fmi2_import_destroy_dllfmu(fmu.fmu);
-    return result;
-}
-
-void applyNumericValueFmi3(fmi3_import_t* fmu, const std::string& name, double value) {
-    fmi3_import_variable_t* var = fmi3_import_get_variable_by_name(fmu, name.c_str());
-    if (!var) {
-        fail("Unknown variable '" + name + "'");
+    if (cfg.op == CADS_OP_ROLLING_QUANTILE || cfg.op == CADS_OP_QUANTILE) {
+        for (size_t i = 0; i < signal.values.size(); ++i) {
+            if (std::isnan(signal.values[i])) {
+                std::ostringstream msg;
+                msg << "Operator input has no value at t=" << signal.times[i];
+                fail(msg.str());
+            }
+        }
     }
-    fmi3_value_reference_t vr = fmi3_import_get_variable_vr(var);
-    fmi3_base_type_enu_t baseType = fmi3_import_get_variable_base_type(var);
 
-    switch (baseType) {
-        case fmi3_base_type_float64: {
-            fmi3_float64_t v = static_cast<fmi3_float64_t>(value);
-            if (fmi3_import_set_float64(fmu, &vr, 1, &v, 1) != fmi3_status_ok) {
-                fail("Failed setting real " + name);
-            }
+    switch (cfg.op) {
+        case CADS_OP_SCALE:
+            scaleValues(signal.values, cfg.factor, cfg.offset);
             break;
-        }
-        case fmi3_base_type_int32: {
-            fmi3_int32_t iv = static_cast<fmi3_int32_t>(std::llround(value));
-            if (fmi3_import_set_int32(fmu, &vr, 1, &iv, 1) != fmi3_status_ok) {
-                fail("Failed setting integer " + name);
-            }
+        case CADS_OP_THRESHOLD:
+            thresholdValues(signal.values, cfg.level);
             break;
-        }
-        case fmi3_base_type_bool: {
-            fmi3_boolean_t bv = (value != 0.0) ? fmi3_true : fmi3_false;
-            if (fmi3_import_set_boolean(fmu, &vr, 1, &bv, 1) != fmi3_status_ok) {
-                fail("Failed setting boolean " + name);
-            }
+        case CADS_OP_ROLLING_MEAN:
+            signal.values = rollingMean(signal, cfg.window);
+            break;
+        case CADS_OP_ROLLING_QUANTILE:
+            signal.values = rollingQuantile(signal, cfg.window, cfg.quantile);
+            break;
+        case CADS_OP_RESAMPLE:
+            signal = resampleSignal(signal, cfg.interval, cfg.interpolation);
             break;
+        case CADS_OP_QUANTILE: {
+            std::sort(signal.values.begin(), signal.values.end());
+            return serializeOperatorJson(sortedQuantile(signal.values.data(), signal.values.size(), cfg.quantile),
+                                         nullptr, metadata);
         }
-        default:
-            fail("Unsupported FMI3 base type for " + name);
     }
+    return serializeOperatorJson(signal.values.back(), &signal, metadata);
 }
 
-void applyStartValueFmi3(fmi3_import_t* fmu, const Assignment& assign) {
-    applyNumericValueFmi3(fmu, assign.name, parseNumber(assign.value));
-}
+// Streaming SHA-256 (FIPS 180-4), enough to fingerprint FMU archives without
+// linking a crypto library.
+class Sha256 {
+public:
+    void update(const unsigned char* data, size_t length) {
+        total_ += length;
+        while (length > 0) {
+            const size_t take = std::min(length, sizeof(block_) - used_);
+            std::memcpy(block_ + used_, data, take);
+            used_ += take;
+            data += take;
+            length -= take;
+            if (used_ == sizeof(block_)) {
+                compress();
+                used_ = 0;
+            }
+        }
+    }
 
-void applySeriesPointFmi3(fmi3_import_t* fmu, const InputSeriesPoint& point) {
-    for (const auto& entry : point.values) {
-        applyNumericValueFmi3(fmu, entry.name, entry.value);
+    std::string hex() {
+        const std::uint64_t bits = total_ * 8;
+        const unsigned char pad = 0x80;
+        update(&pad, 1);
+        const unsigned char zero = 0;
+        while (used_ != 56) {
+            update(&zero, 1);
+        }
+        unsigned char length[8];
+        for (int i = 0; i < 8; ++i) {
+            length[i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+        }
+        update(length, sizeof(length));
+        char out[65];
+        for (int i = 0; i < 8; ++i) {
+            std::snprintf(out + 8 * i, 9, "%08x", state_[i]);
+        }
+        return std::string(out, 64);
     }
-}
 
-OutputValue readVariableFmi3(fmi3_import_t* fmu, const std::string& name) {
-    fmi3_import_variable_t* var = fmi3_import_get_variable_by_name(fmu, name.c_str());
-    if (!var) {
-        fail("Variable '" + name + "' not found");
+private:
+    static std::uint32_t rotr(std::uint32_t x, int n) {
+        return (x >> n) | (x << (32 - n));
     }
-    fmi3_value_reference_t vr = fmi3_import_get_variable_vr(var);
-    fmi3_base_type_enu_t baseType = fmi3_import_get_variable_base_type(var);
-    size_t valueCount = resolveFmi3ValueCount(fmu, var, name);
-    OutputValue ov{};
-    switch (baseType) {
-        case fmi3_base_type_float64: {
-            std::vector<fmi3_float64_t> values(valueCount);
-            if (fmi3_import_get_float64(fmu, &vr, 1, values.data(), valueCount) != fmi3_status_ok) {
-                fail("Failed reading float64 output " + name);
-            }
-            if (valueCount == 1) {
-                ov.type = OutputValue::Type::Real;
-                ov.realVal = values[0];
-            } else {
-                ov.type = OutputValue::Type::RealArray;
-                ov.realArray.assign(values.begin(), values.end());
-            }
-            break;
+
+    void compress() {
+        static constexpr std::uint32_t k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+        };
+        std::uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = std::uint32_t{block_[4 * i]} << 24 | std::uint32_t{block_[4 * i + 1]} << 16 |
+                   std::uint32_t{block_[4 * i + 2]} << 8 | std::uint32_t{block_[4 * i + 3]};
         }
-        case fmi3_base_type_int32: {
-            std::vector<fmi3_int32_t> values(valueCount);
-            if (fmi3_import_get_int32(fmu, &vr, 1, values.data(), valueCount) != fmi3_status_ok) {
-                fail("Failed reading int32 output " + name);
-            }
-            if (valueCount == 1) {
-                ov.type = OutputValue::Type::Integer;
-                ov.intVal = values[0];
-            } else {
-                ov.type = OutputValue::Type::IntegerArray;
-                ov.intArray.reserve(values.size());
-                for (fmi3_int32_t value : values) {
-                    ov.intArray.push_back(value);
-                }
-            }
-            break;
+        for (int i = 16; i < 64; ++i) {
+            const std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
         }
-        case fmi3_base_type_bool: {
-            std::unique_ptr<fmi3_boolean_t[]> rawValues(new fmi3_boolean_t[valueCount]);
-            if (fmi3_import_get_boolean(fmu, &vr, 1, rawValues.get(), valueCount) != fmi3_status_ok) {
-                fail("Failed reading boolean output " + name);
-            }
-            if (valueCount == 1) {
-                ov.type = OutputValue::Type::Boolean;
-                ov.boolVal = (rawValues[0] != fmi3_false);
-            } else {
-                ov.type = OutputValue::Type::BooleanArray;
-                ov.boolArray.reserve(valueCount);
-                for (size_t i = 0; i < valueCount; ++i) {
-                    ov.boolArray.push_back(rawValues[i] != fmi3_false);
-                }
-            }
+        std::uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+        std::uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+        for (int i = 0; i < 64; ++i) {
+            const std::uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+            const std::uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        state_[0] += a;
+        state_[1] += b;
+        state_[2] += c;
+        state_[3] += d;
+        state_[4] += e;
+        state_[5] += f;
+        state_[6] += g;
+        state_[7] += h;
+    }
+
+    std::uint32_t state_[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                               0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    unsigned char block_[64];
+    size_t used_{0};
+    std::uint64_t total_{0};
+};
+
+// SHA-256 of the archive's bytes. Identical FMUs stored under different paths
+// (per-run downloads, copies) share a digest; different ones never do in
+// practice, so they can never be handed each other's unpacked binaries.
+std::string fmuDigest(const std::string& fmuPath) {
+    int fd = ::open(fmuPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        fail("FMU not found: " + fmuPath);
+    }
+    Sha256 sha;
+    std::vector<unsigned char> buffer(1 << 20);
+    for (;;) {
+        ssize_t got = ::read(fd, buffer.data(), buffer.size());
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got < 0) {
+            ::close(fd);
+            fail("Failed reading FMU '" + fmuPath + "'");
+        }
+        if (got == 0) {
             break;
         }
-        default:
-            fail("Unsupported variable type for " + name);
+        sha.update(buffer.data(), static_cast<size_t>(got));
     }
-    return ov;
+    ::close(fd);
+    return sha.hex();
 }
 
-FmuExecutionResult runFmi3(const Config& cfg, const std::string& unpackDir, fmi_import_context_t* ctx) {
-    ScopedFmu3 fmu(fmi3_import_parse_xml(ctx, unpackDir.c_str(), nullptr));
-    if (!fmu.fmu) {
-        fail("Failed parsing FMI3 XML");
+// Process-wide unpacked FMUs, one per archive digest, shared by every run that
+// uses the archive. Runs sharing an unpack load the binary from the same path,
+// so the dynamic loader maps and relocates it once and later create_dllfmu
+// calls only take a reference; each run still parses its own model description
+// and owns its instance. The directory is removed with its last user.
+class UnpackRegistry {
+public:
+    struct Unpacked {
+        std::unique_ptr<ScopedTempDir> dir;
+        fmi_version_enu_t version{fmi_version_unknown_enu};
+    };
+
+    static UnpackRegistry& instance() {
+        static UnpackRegistry registry;
+        return registry;
     }
-    if (fmi3_import_get_fmu_kind(fmu.fmu) != fmi3_fmu_kind_cs) {
-        fail("FMI3 FMU is not Co-Simulation");
+
+    std::shared_ptr<const Unpacked> unpack(const std::string& fmuPath, fmi_import_context_t* ctx) {
+        const std::string digest = digestOf(fmuPath);
+        std::shared_ptr<Slot> slot;
+        {
+            std::lock_guard<std::mutex> guard(mu_);
+            for (auto it = slots_.begin(); it != slots_.end();) {
+                it = it->second.expired() ? slots_.erase(it) : std::next(it);
+            }
+            std::weak_ptr<Slot>& entry = slots_[digest];
+            slot = entry.lock();
+            if (!slot) {
+                slot = std::make_shared<Slot>();
+                entry = slot;
+            }
+        }
+        // Runs that arrive while the first one unzips wait here for its result.
+        std::lock_guard<std::mutex> guard(slot->mu);
+        if (!slot->unpacked.dir) {
+            auto dir = std::make_unique<ScopedTempDir>(makeTempDir());
+            fmi_version_enu_t version = fmi_import_get_fmi_version(ctx, fmuPath.c_str(), dir->path.c_str());
+            if (version == fmi_version_unknown_enu) {
+                fail("Unable to detect FMI version");
+            }
+            slot->unpacked.version = version;
+            slot->unpacked.dir = std::move(dir);
+        }
+        return std::shared_ptr<const Unpacked>(slot, &slot->unpacked);
     }
 
-    if (fmi3_import_create_dllfmu(fmu.fmu, fmi3_fmu_kind_cs, nullptr, nullptr) != jm_status_success) {
-        fail("Failed loading FMI3 binaries");
+private:
+    struct Slot {
+        std::mutex mu;
+        Unpacked unpacked;
+    };
+
+    struct KnownDigest {
+        std::uint64_t inode;
+        std::int64_t size;
+        std::int64_t modified;
+        std::string digest;
+        std::list<std::string>::iterator recent;
+    };
+
+    // Paths whose digest is remembered, so services that run a new FMU path
+    // per request do not grow digests_ without bound.
+    static constexpr size_t kMaxKnownDigests = 1024;
+
+    // Archives are only re-read when their inode, size or modification time
+    // changes, so a file replaced by rename is hashed again.
+    std::string digestOf(const std::string& fmuPath) {
+        struct stat st {};
+        if (::stat(fmuPath.c_str(), &st) != 0) {
+            fail("FMU not found: " + fmuPath);
+        }
+#ifdef __APPLE__
+        const std::int64_t modified = static_cast<std::int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+        const std::int64_t modified = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+        const std::int64_t size = static_cast<std::int64_t>(st.st_size);
+        const std::uint64_t inode = static_cast<std::uint64_t>(st.st_ino);
+        {
+            std::lock_guard<std::mutex> guard(mu_);
+            auto found = digests_.find(fmuPath);
+            if (found != digests_.end() && found->second.inode == inode && found->second.size == size &&
+                found->second.modified == modified) {
+                recentPaths_.splice(recentPaths_.begin(), recentPaths_, found->second.recent);
+                return found->second.digest;
+            }
+        }
+        std::string digest = fmuDigest(fmuPath);
+        std::lock_guard<std::mutex> guard(mu_);
+        auto found = digests_.find(fmuPath);
+        if (found != digests_.end()) {
+            recentPaths_.erase(found->second.recent);
+            digests_.erase(found);
+        }
+        recentPaths_.push_front(fmuPath);
+        digests_.emplace(fmuPath, KnownDigest{inode, size, modified, digest, recentPaths_.begin()});
+        if (digests_.size() > kMaxKnownDigests) {
+            digests_.erase(recentPaths_.back());
+            recentPaths_.pop_back();
+        }
+        return digest;
     }
 
-    if (fmi3_import_instantiate_co_simulation(
-            fmu.fmu, "cads-runner", nullptr, fmi3_false, fmi3_false,
-            fmi3_false, fmi3_false, nullptr, 0, nullptr) != jm_status_success) {
-        fail("Failed instantiating FMI3 FMU");
+    std::mutex mu_;
+    std::map<std::string, std::weak_ptr<Slot>> slots_;
+    std::map<std::string, KnownDigest> digests_;
+    // Keys of digests_, most recently used first.
+    std::list<std::string> recentPaths_;
+};
+
+// FMIL context plus the FMUs one thread is using. Batch workers keep theirs
+// across runs, and concurrent runs of the same archive share its unpack through
+// UnpackRegistry.
+class FmuWorkspace {
+public:
+    FmuWorkspace() : callbacks_(*jm_get_default_callbacks()), ctx_(&callbacks_) {
+        if (!ctx_.ctx) {
+            fail("Failed to create FMIL context");
+        }
     }
 
-    std::optional<InputSeriesData> inputSeries;
-    if (cfg.inputSeries) {
-        inputSeries = loadInputSeries(*cfg.inputSeries);
+    FmuWorkspace(const FmuWorkspace&) = delete;
+    FmuWorkspace& operator=(const FmuWorkspace&) = delete;
+
+    fmi_import_context_t* context() const {
+        return ctx_.ctx;
     }
 
-    StepTimings timings = deriveTimingsFmi3(fmu.fmu, cfg);
-    alignTimingsWithSeries(timings, cfg, inputSeries);
-    if (timings.step <= 0.0) {
-        timings.step = (timings.stop - timings.start);
-        if (timings.step <= 0.0) {
-            timings.step = 1.0;
+    using Unpacked = UnpackRegistry::Unpacked;
+
+    const Unpacked& unpack(const std::string& fmuPath) {
+        auto found = unpacked_.find(fmuPath);
+        if (found != unpacked_.end()) {
+            return *found->second;
         }
+        if (!fs::exists(fmuPath)) {
+            fail("FMU not found: " + fmuPath);
+        }
+        auto shared = UnpackRegistry::instance().unpack(fmuPath, ctx_.ctx);
+        return *unpacked_.emplace(fmuPath, std::move(shared)).first->second;
     }
 
-    double tolerance = fmi3_import_get_default_experiment_has_tolerance(fmu.fmu)
-                           ? fmi3_import_get_default_experiment_tolerance(fmu.fmu)
-                           : 1e-4;
+private:
+    jm_callbacks callbacks_;
+    ScopedCtx ctx_;
+    std::map<std::string, std::shared_ptr<const Unpacked>> unpacked_;
+};
 
-    if (fmi3_import_enter_initialization_mode(
-            fmu.fmu, fmi3_true, tolerance, timings.start, fmi3_true, timings.stop) != fmi3_status_ok) {
-        fail("Failed entering FMI3 initialization");
+std::unique_ptr<Simulation> startSimulation(const Config& cfg, FmuWorkspace& workspace) {
+    WallBudget budget(cfg.wallBudget);
+    const FmuWorkspace::Unpacked& unpacked = workspace.unpack(cfg.fmuPath);
+    if (unpacked.version == fmi_version_2_0_enu) {
+        return std::make_unique<FmiSimulation<Fmi2Traits>>(cfg, unpacked.dir->path, workspace.context(), budget);
     }
+    if (unpacked.version == fmi_version_3_0_enu) {
+        return std::make_unique<FmiSimulation<Fmi3Traits>>(cfg, unpacked.dir->path, workspace.context(), budget);
+    }
+    fail("Unsupported FMI version");
+}
 
-    for (const auto& entry : cfg.startValues) {
-        applyStartValueFmi3(fmu.fmu, entry);
+FmuExecutionResult executeFmu(const Config& cfg, FmuWorkspace& workspace) {
+    std::unique_ptr<Simulation> sim = startSimulation(cfg, workspace);
+    if (cfg.live) {
+        sim->runLive();
+        return sim->finish();
     }
+    sim->run(cfg.priority == CADS_PRIORITY_BATCH);
+    return sim->finish();
+}
 
-    size_t nextInputIndex = 0;
-    auto applySeriesThrough = [&](double time) {
-        if (!inputSeries) {
-            return;
-        }
-        while (nextInputIndex < inputSeries->points.size() &&
-               inputSeries->points[nextInputIndex].time <= time + 1e-12) {
-            applySeriesPointFmi3(fmu.fmu, inputSeries->points[nextInputIndex]);
-            nextInputIndex += 1;
-        }
-    };
-    applySeriesThrough(timings.start);
+std::string runConfiguredFmu(const Config& cfg) {
+    ScopedPriorityHold interactive(cfg.priority == CADS_PRIORITY_INTERACTIVE);
+    FmuWorkspace workspace;
+    return serializeJson(executeFmu(cfg, workspace));
+}
 
-    if (fmi3_import_exit_initialization_mode(fmu.fmu) != fmi3_status_ok) {
-        fail("Failed exiting FMI3 initialization");
+// Double-ended task queue of one batch worker. The owner pops from the back so
+// it keeps working on the FMUs it has already unpacked; idle workers steal from
+// the front.
+class WorkStealingDeque {
+public:
+    void push(size_t task) {
+        std::lock_guard<std::mutex> guard(mu_);
+        tasks_.push_back(task);
     }
 
-    FmuExecutionResult result;
-    std::vector<std::string> traceNames = buildTraceNames(cfg.trace);
-    double traceInterval = traceNames.empty() ? 0.0 : resolveTraceInterval(cfg, timings);
-    auto captureTrace = [&](double time) {
-        if (traceNames.empty()) {
-            return;
+    std::optional<size_t> pop() {
+        std::lock_guard<std::mutex> guard(mu_);
+        if (tasks_.empty()) {
+            return std::nullopt;
         }
-        result.traceTimes.push_back(time);
-        for (const auto& name : traceNames) {
-            result.traceSignals[name].push_back(readVariableFmi3(fmu.fmu, name));
+        size_t task = tasks_.back();
+        tasks_.pop_back();
+        return task;
+    }
+
+    std::optional<size_t> steal() {
+        std::lock_guard<std::mutex> guard(mu_);
+        if (tasks_.empty()) {
+            return std::nullopt;
         }
+        size_t task = tasks_.front();
+        tasks_.pop_front();
+        return task;
+    }
+
+private:
+    std::mutex mu_;
+    std::deque<size_t> tasks_;
+};
+
+struct BatchItemResult {
+    enum class Status { Ok, Error, Isolate } status{Status::Error};
+    std::string payload;
+};
+
+size_t resolveWorkerCount(size_t requested, size_t taskCount) {
+    size_t workers = requested;
+    if (workers == 0) {
+        workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    return std::max<size_t>(1, std::min(workers, taskCount));
+}
+
+// Runs every config on a fixed set of worker threads. Tasks are seeded onto
+// the worker chosen by their FMU path so runs of the same FMU share a warm
+// workspace; a worker whose deque runs dry steals from the others, so long and
+// short runs mixed in one batch keep every worker busy until the end.
+//
+// Each worker keeps up to `interleave` runs in flight and advances them round
+// robin, one communication step per quantum, so thousands of short runs are
+// multiplexed onto a few threads instead of handed off one by one. Started runs
+// stay on their worker; only runs that have not started yet are stolen.
+std::vector<BatchItemResult> runBatch(const std::vector<Config>& cfgs, size_t requestedWorkers, size_t interleave) {
+    std::vector<BatchItemResult> results(cfgs.size());
+    if (cfgs.empty()) {
+        return results;
+    }
+
+    const size_t workerCount = resolveWorkerCount(requestedWorkers, cfgs.size());
+    const size_t window = std::max<size_t>(1, interleave);
+    std::vector<WorkStealingDeque> deques(workerCount);
+    std::hash<std::string> hasher;
+    for (size_t i = 0; i < cfgs.size(); ++i) {
+        deques[hasher(cfgs[i].fmuPath) % workerCount].push(i);
+    }
+
+    struct ActiveRun {
+        size_t task;
+        std::unique_ptr<ScopedPriorityHold> hold;
+        std::unique_ptr<Simulation> sim;
     };
 
-    double current = timings.start;
-    if (!traceNames.empty()) {
-        captureTrace(current);
-    }
-    double nextTraceTime = current + traceInterval;
-    while (current < timings.stop - 1e-12) {
-        double next = std::min(current + timings.step, timings.stop);
-        if (!traceNames.empty() && nextTraceTime < next - 1e-12) {
-            next = nextTraceTime;
-        }
-        if (next <= current + 1e-12) {
-            applySeriesThrough(current);
-            if (!traceNames.empty() && nextTraceTime <= current + 1e-12) {
-                captureTrace(current);
-                nextTraceTime += traceInterval;
-                continue;
+    auto recordFailure = [&](size_t task, const std::exception& ex) {
+        BatchItemResult& item = results[task];
+        item.status = dynamic_cast<const IsolationRequired*>(&ex) ? BatchItemResult::Status::Isolate
+                                                                   : BatchItemResult::Status::Error;
+        item.payload = ex.what();
+    };
+
+    auto work = [&](size_t self) {
+        std::optional<FmuWorkspace> workspace;
+        std::vector<ActiveRun> active;
+        active.reserve(window);
+        bool drained = false;
+        for (;;) {
+            while (!drained && active.size() < window) {
+                std::optional<size_t> task = deques[self].pop();
+                for (size_t offset = 1; !task && offset < workerCount; ++offset) {
+                    task = deques[(self + offset) % workerCount].steal();
+                }
+                if (!task) {
+                    drained = true;
+                    break;
+                }
+
+                const Config& cfg = cfgs[*task];
+                try {
+                    if (!workspace) {
+                        workspace.emplace();
+                    }
+                    ActiveRun run{*task, std::make_unique<ScopedPriorityHold>(cfg.priority == CADS_PRIORITY_INTERACTIVE), nullptr};
+                    run.sim = startSimulation(cfg, *workspace);
+                    if (cfg.live) {
+                        // Live runs block on their input, so they are not interleaved.
+                        run.sim->runLive();
+                        results[*task].payload = serializeJson(run.sim->finish());
+                        results[*task].status = BatchItemResult::Status::Ok;
+                        continue;
+                    }
+                    active.push_back(std::move(run));
+                } catch (const std::exception& ex) {
+                    recordFailure(*task, ex);
+                }
+            }
+            if (active.empty()) {
+                return;
+            }
+
+            // Batch work parks here while interactive work is pending, unless
+            // this worker is itself carrying an interactive run.
+            bool allBatch = std::all_of(active.begin(), active.end(), [&](const ActiveRun& run) {
+                return cfgs[run.task].priority == CADS_PRIORITY_BATCH;
+            });
+            if (allBatch) {
+                PriorityGate::instance().yieldIfPressured();
+            }
+
+            for (size_t i = 0; i < active.size();) {
+                ActiveRun& run = active[i];
+                bool finished = true;
+                try {
+                    if (run.sim->advance()) {
+                        finished = false;
+                    } else {
+                        BatchItemResult& item = results[run.task];
+                        item.payload = serializeJson(run.sim->finish());
+                        item.status = BatchItemResult::Status::Ok;
+                    }
+                } catch (const std::exception& ex) {
+                    recordFailure(run.task, ex);
+                }
+                if (!finished) {
+                    ++i;
+                    continue;
+                }
+                if (i + 1 != active.size()) {
+                    std::swap(active[i], active.back());
+                }
+                active.pop_back();
             }
-            fail("fmi3 execution stalled due to zero-length step");
-        }
-        double step = next - current;
-        fmi3_boolean_t eventNeeded = fmi3_false;
-        fmi3_boolean_t terminate = fmi3_false;
-        fmi3_boolean_t earlyReturn = fmi3_false;
-        fmi3_float64_t lastSuccessfulTime{};
-        if (fmi3_import_do_step(
-                fmu.fmu, current, step, fmi3_false,
-                &eventNeeded, &terminate, &earlyReturn, &lastSuccessfulTime) != fmi3_status_ok) {
-            fail("fmi3_do_step failed");
         }
-        if (terminate == fmi3_true) {
-            break;
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(workerCount - 1);
+    for (size_t i = 1; i < workerCount; ++i) {
+        threads.emplace_back(work, i);
+    }
+    work(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return results;
+}
+
+std::string serializeBatchJson(const std::vector<BatchItemResult>& results) {
+    std::ostringstream oss;
+    oss << "[";
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (i > 0) {
+            oss << ",";
         }
-        current = next;
-        applySeriesThrough(current);
-        if (!traceNames.empty() && nextTraceTime <= current + 1e-12) {
-            captureTrace(current);
-            nextTraceTime += traceInterval;
+        const BatchItemResult& item = results[i];
+        switch (item.status) {
+            case BatchItemResult::Status::Ok:
+                oss << "{\"status\":\"ok\",\"result\":" << item.payload << "}";
+                break;
+            case BatchItemResult::Status::Isolate:
+                oss << "{\"status\":\"isolate\",\"error\":\"" << escapeJsonString(item.payload) << "\"}";
+                break;
+            case BatchItemResult::Status::Error:
+                oss << "{\"status\":\"error\",\"error\":\"" << escapeJsonString(item.payload) << "\"}";
+                break;
         }
     }
+    oss << "]";
+    return oss.str();
+}
 
-    if (!traceNames.empty() && (result.traceTimes.empty() || std::fabs(result.traceTimes.back() - timings.stop) > 1e-9)) {
-        captureTrace(timings.stop);
+// Concurrency facts and libpython of an unpacked FMU, read without loading its
+// binary.
+FmuCapabilities inspectFmu(const FmuWorkspace::Unpacked& unpacked, fmi_import_context_t* ctx) {
+    const std::string& dir = unpacked.dir->path;
+    if (unpacked.version == fmi_version_2_0_enu) {
+        ScopedFmu2 fmu(fmi2_import_parse_xml(ctx, dir.c_str(), nullptr));
+        if (!fmu.fmu) {
+            fail("Failed parsing FMI2 XML");
+        }
+        return capabilitiesFmi2(fmu.fmu, dir);
     }
-
-    std::vector<std::string> outputs = cfg.outputs.empty() ? autoOutputsFmi3(fmu.fmu) : cfg.outputs;
-    for (const auto& name : outputs) {
-        result.values[name] = readVariableFmi3(fmu.fmu, name);
+    if (unpacked.version == fmi_version_3_0_enu) {
+        ScopedFmu3 fmu(fmi3_import_parse_xml(ctx, dir.c_str(), nullptr));
+        if (!fmu.fmu) {
+            fail("Failed parsing FMI3 XML");
+        }
+        return capabilitiesFmi3(fmu.fmu, dir);
     }
-
-    fmi3_import_terminate(fmu.fmu);
-    fmi3_import_free_instance(fmu.fmu);
-    fmi3_import_destroy_dllfmu(fmu.fmu);
-    return result;
+    fail("Unsupported FMI version");
 }
 
-Config fromCConfig(const cads_fmu_config& cfg) {
-    Config result;
-    if (!cfg.fmu_path) {
-        fail("FMU path is required");
-    }
-    result.fmuPath = cfg.fmu_path;
-    if (cfg.has_start_time) {
-        result.startTime = cfg.start_time;
+// A process holding an initialized CPython interpreter, with the usual modules
+// already imported, from which pythonfmu runs are forked. The zygote is served
+// from a static initializer, before the Go runtime starts any threads, so every
+// fork happens in a single-threaded process. Children return from the
+// initializer and boot the Go runtime as a fresh worker would, but with the
+// warm interpreter and the zygote's unpacked FMUs, so they skip the interpreter
+// start, the common imports and the unzip. The bridge does not link against
+// Python, so the few C API calls it needs are resolved with dlsym.
+class PythonZygote {
+public:
+    static PythonZygote& instance() {
+        static PythonZygote zygote;
+        return zygote;
     }
-    if (cfg.has_stop_time) {
-        result.stopTime = cfg.stop_time;
+
+    // Prepares the interpreter, reports readiness and forks one child per
+    // connection until stdin closes. Returns only in a child, with the
+    // connection on zygoteListenFd and CADS_FMI_WORKER set to zygote-run.
+    void serve() {
+        try {
+            prepare(envOr("CADS_PYTHON_ZYGOTE_FMU", ""), envOr("CADS_PYTHON_ZYGOTE_IMPORTS", ""));
+        } catch (const std::exception& ex) {
+            writeAll(zygoteReadyFd, std::string("error: ") + ex.what() + "\n");
+            ::_exit(1);
+        }
+        writeAll(zygoteReadyFd, "ok\n");
+        ::close(zygoteReadyFd);
+
+        for (;;) {
+            while (::waitpid(-1, nullptr, WNOHANG) > 0) {
+            }
+            pollfd fds[2] = {{zygoteListenFd, POLLIN, 0}, {STDIN_FILENO, POLLIN, 0}};
+            const int ready = ::poll(fds, 2, 1000);
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ready < 0) {
+                ::_exit(1);
+            }
+            if (fds[1].revents != 0) {
+                // The parent process closed our stdin: it is gone or done.
+                char discard[256];
+                const ssize_t got = ::read(STDIN_FILENO, discard, sizeof(discard));
+                if (got == 0 || (got < 0 && errno != EINTR && errno != EAGAIN)) {
+                    ::_exit(0);
+                }
+            }
+            if ((fds[0].revents & POLLIN) == 0) {
+                continue;
+            }
+            const int conn = ::accept(zygoteListenFd, nullptr, nullptr);
+            if (conn < 0) {
+                continue;
+            }
+            if (forkChild(conn)) {
+                return;
+            }
+            ::close(conn);
+        }
     }
-    if (cfg.has_step_size) {
-        result.stepSize = cfg.step_size;
+
+    // Whether fmuPath is a pythonfmu FMU built against the zygote's libpython.
+    // Kept per unpack, which the zygote holds on to so children find it too.
+    bool suits(const std::string& fmuPath) {
+        std::lock_guard<std::mutex> guard(mu_);
+        if (!prepared_) {
+            fail("Python zygote is not prepared");
+        }
+        const FmuWorkspace::Unpacked& unpacked = workspace_.unpack(fmuPath);
+        auto found = suits_.find(&unpacked);
+        if (found == suits_.end()) {
+            const FmuCapabilities caps = inspectFmu(unpacked, workspace_.context());
+            const bool match = caps.pythonFmu && libPythonForFmu(unpacked.dir->path, caps.modelIdentifier) == soname_;
+            found = suits_.emplace(&unpacked, match).first;
+        }
+        return found->second;
     }
-    if (cfg.start_values && cfg.start_value_count > 0) {
-        result.startValues.reserve(cfg.start_value_count);
-        for (size_t i = 0; i < cfg.start_value_count; ++i) {
-            const cads_assignment& entry = cfg.start_values[i];
-            if (!entry.name || !entry.value) {
-                fail("Start values must include both name and value");
-            }
-            result.startValues.push_back({entry.name, entry.value});
+
+private:
+    // Descriptors the Go parent passes: the listening socket and the pipe the
+    // zygote reports readiness on.
+    static constexpr int zygoteListenFd = 3;
+    static constexpr int zygoteReadyFd = 4;
+
+    struct Api {
+        int (*isInitialized)();
+        void (*initializeEx)(int);
+        int (*runSimpleString)(const char*);
+        void* (*saveThread)();
+        int (*gilEnsure)();
+        void (*gilRelease)(int);
+        void (*beforeFork)();
+        void (*afterForkParent)();
+        void (*afterForkChild)();
+    };
+
+    void prepare(const std::string& fmuPath, const std::string& imports) {
+        std::lock_guard<std::mutex> guard(mu_);
+        const FmuWorkspace::Unpacked& unpacked = workspace_.unpack(fmuPath);
+        const FmuCapabilities caps = inspectFmu(unpacked, workspace_.context());
+        if (!caps.pythonFmu) {
+            fail("FMU '" + fmuPath + "' is not a pythonfmu FMU");
+        }
+        soname_ = libPythonForFmu(unpacked.dir->path, caps.modelIdentifier);
+        void* python = loadLibPython(soname_);
+        if (!python) {
+            fail("Failed loading libpython for '" + fmuPath + "'");
+        }
+        resolve(python);
+
+        if (!api_.isInitialized()) {
+            api_.initializeEx(0);
         }
+        api_.runSimpleString(importScript(imports).c_str());
+        // pythonfmu instances take the GIL with PyGILState_Ensure, so the
+        // zygote and its children keep it released between calls.
+        api_.saveThread();
+        prepared_ = true;
     }
-    if (cfg.input_series) {
-        if (!cfg.input_series->csv_path || cfg.input_series->csv_path[0] == '\0') {
-            fail("Input series CSV path is required");
+
+    // Forks a child for conn. Returns true in the child.
+    bool forkChild(int conn) {
+        const int gil = api_.gilEnsure();
+        api_.beforeFork();
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            api_.afterForkChild();
+            api_.gilRelease(gil);
+            ::dup2(conn, zygoteListenFd);
+            ::close(conn);
+            // The variable is already set, so setenv replaces its slot in the
+            // startup environment block that the Go runtime reads.
+            ::setenv("CADS_FMI_WORKER", "zygote-run", 1);
+            return true;
+        }
+        api_.afterForkParent();
+        api_.gilRelease(gil);
+        if (pid < 0) {
+            writeAll(conn, "{\"error\":\"Failed forking Python zygote: " + escapeJsonString(std::strerror(errno)) + "\"}\n");
         }
-        result.inputSeries = InputSeriesConfig{cfg.input_series->csv_path};
+        return false;
     }
-    if (cfg.outputs && cfg.output_count > 0) {
-        result.outputs.reserve(cfg.output_count);
-        for (size_t i = 0; i < cfg.output_count; ++i) {
-            const char* name = cfg.outputs[i];
-            if (!name) {
-                fail("Output name cannot be null");
+
+    void resolve(void* python) {
+        auto symbol = [python](auto& fn, const char* name) {
+            void* address = dlsym(python, name);
+            if (!address) {
+                fail(std::string("libpython does not export ") + name);
             }
-            result.outputs.emplace_back(name);
-        }
+            fn = reinterpret_cast<std::remove_reference_t<decltype(fn)>>(address);
+        };
+        symbol(api_.isInitialized, "Py_IsInitialized");
+        symbol(api_.initializeEx, "Py_InitializeEx");
+        symbol(api_.runSimpleString, "PyRun_SimpleString");
+        symbol(api_.saveThread, "PyEval_SaveThread");
+        symbol(api_.gilEnsure, "PyGILState_Ensure");
+        symbol(api_.gilRelease, "PyGILState_Release");
+        symbol(api_.beforeFork, "PyOS_BeforeFork");
+        symbol(api_.afterForkParent, "PyOS_AfterFork_Parent");
+        symbol(api_.afterForkChild, "PyOS_AfterFork_Child");
     }
-    if (cfg.trace_outputs && cfg.trace_output_count > 0) {
-        result.trace.outputs.reserve(cfg.trace_output_count);
-        for (size_t i = 0; i < cfg.trace_output_count; ++i) {
-            const char* name = cfg.trace_outputs[i];
-            if (!name) {
-                fail("Trace output name cannot be null");
+
+    // Imports each comma-separated module, skipping those that fail.
+    static std::string importScript(const std::string& imports) {
+        std::ostringstream script;
+        script << "import importlib\n";
+        std::stringstream names(imports);
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            name = trimCopy(name);
+            const bool dotted = std::all_of(name.begin(), name.end(), [](unsigned char ch) {
+                return std::isalnum(ch) || ch == '_' || ch == '.';
+            });
+            if (name.empty()) {
+                continue;
             }
-            result.trace.outputs.emplace_back(name);
+            if (!dotted) {
+                fail("Invalid Python module name '" + name + "'");
+            }
+            script << "try:\n    importlib.import_module('" << name << "')\nexcept Exception:\n    pass\n";
         }
+        return script.str();
     }
-    if (cfg.trace_inputs && cfg.trace_input_count > 0) {
-        result.trace.inputs.reserve(cfg.trace_input_count);
-        for (size_t i = 0; i < cfg.trace_input_count; ++i) {
-            const char* name = cfg.trace_inputs[i];
-            if (!name) {
-                fail("Trace input name cannot be null");
+
+    static std::string envOr(const char* name, const char* fallback) {
+        const char* value = std::getenv(name);
+        return value ? value : fallback;
+    }
+
+    static void writeAll(int fd, const std::string& text) {
+        const char* data = text.data();
+        size_t left = text.size();
+        while (left > 0) {
+            const ssize_t wrote = ::write(fd, data, left);
+            if (wrote < 0 && errno == EINTR) {
+                continue;
             }
-            result.trace.inputs.emplace_back(name);
+            if (wrote < 0) {
+                return;
+            }
+            data += wrote;
+            left -= static_cast<size_t>(wrote);
         }
     }
-    if (cfg.has_trace_interval) {
-        result.trace.sampleEvery = cfg.trace_interval;
+
+    std::mutex mu_;
+    bool prepared_{false};
+    std::string soname_;
+    Api api_{};
+    FmuWorkspace workspace_;
+    std::map<const FmuWorkspace::Unpacked*, bool> suits_;
+};
+
+void setErrorOut(char** err_out, const std::string& msg) {
+    if (!err_out) {
+        return;
+    }
+    *err_out = static_cast<char*>(std::malloc(msg.size() + 1));
+    if (*err_out) {
+        std::memcpy(*err_out, msg.c_str(), msg.size() + 1);
     }
-    return result;
 }
 
-std::string runConfiguredFmu(const Config& cfg) {
-    preloadLibPythonIfAvailable();
+void setJsonOut(char** json_out, const std::string& json) {
+    if (!json_out) {
+        return;
+    }
+    *json_out = static_cast<char*>(std::malloc(json.size() + 1));
+    if (!*json_out) {
+        fail("Failed allocating JSON buffer");
+    }
+    std::memcpy(*json_out, json.c_str(), json.size() + 1);
+}
 
-    if (!fs::exists(cfg.fmuPath)) {
-        fail("FMU not found: " + cfg.fmuPath);
+extern "C" int cads_run_fmu(const cads_fmu_config* cfg, char** json_out, char** err_out) {
+    if (json_out) {
+        *json_out = nullptr;
+    }
+    if (err_out) {
+        *err_out = nullptr;
+    }
+    if (!cfg) {
+        setErrorOut(err_out, "Config pointer is null");
+        return CADS_RUN_ERROR;
     }
 
-    jm_callbacks callbacks = *jm_get_default_callbacks();
-    ScopedCtx ctx(&callbacks);
-    if (!ctx.ctx) {
-        fail("Failed to create FMIL context");
+    try {
+        Config native = fromCConfig(*cfg);
+        setJsonOut(json_out, runConfiguredFmu(native));
+        return CADS_RUN_OK;
+    } catch (const IsolationRequired& ex) {
+        setErrorOut(err_out, ex.what());
+        return CADS_RUN_NEEDS_ISOLATION;
+    } catch (const std::exception& ex) {
+        setErrorOut(err_out, ex.what());
+        return CADS_RUN_ERROR;
     }
+}
 
-    ScopedTempDir tempDir(makeTempDir());
-    fmi_version_enu_t version = fmi_import_get_fmi_version(ctx.ctx, cfg.fmuPath.c_str(), tempDir.path.c_str());
-    if (version == fmi_version_unknown_enu) {
-        fail("Unable to detect FMI version");
+extern "C" int cads_run_batch(
+    const cads_fmu_config* cfgs, size_t count, size_t workers, size_t interleave, char** json_out, char** err_out) {
+    if (json_out) {
+        *json_out = nullptr;
+    }
+    if (err_out) {
+        *err_out = nullptr;
+    }
+    if (!cfgs && count > 0) {
+        setErrorOut(err_out, "Config array pointer is null");
+        return CADS_RUN_ERROR;
     }
 
-    FmuExecutionResult result;
-    if (version == fmi_version_2_0_enu) {
-        result = runFmi2(cfg, tempDir.path, ctx.ctx);
-    } else if (version == fmi_version_3_0_enu) {
-        result = runFmi3(cfg, tempDir.path, ctx.ctx);
-    } else {
-        fail("Unsupported FMI version");
+    try {
+        std::vector<Config> native;
+        native.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            native.push_back(fromCConfig(cfgs[i]));
+        }
+        setJsonOut(json_out, serializeBatchJson(runBatch(native, workers, interleave)));
+        return CADS_RUN_OK;
+    } catch (const std::exception& ex) {
+        setErrorOut(err_out, ex.what());
+        return CADS_RUN_ERROR;
     }
-    return serializeJson(result);
 }
 
-extern "C" int cads_run_fmu(const cads_fmu_config* cfg, char** json_out, char** err_out) {
+extern "C" int cads_run_operator(const cads_operator_config* cfg, char** json_out, char** err_out) {
     if (json_out) {
         *json_out = nullptr;
     }
@@ -1287,37 +5591,79 @@ extern "C" int cads_run_fmu(const cads_fmu_config* cfg, char** json_out, char**
         *err_out = nullptr;
     }
     if (!cfg) {
-        if (err_out) {
-            const char* msg = "Config pointer is null";
-            *err_out = static_cast<char*>(std::malloc(std::strlen(msg) + 1));
-            std::strcpy(*err_out, msg);
-        }
-        return 1;
+        setErrorOut(err_out, "Operator config pointer is null");
+        return CADS_RUN_ERROR;
     }
 
     try {
-        Config native = fromCConfig(*cfg);
-        std::string json = runConfiguredFmu(native);
-        if (json_out) {
-            *json_out = static_cast<char*>(std::malloc(json.size() + 1));
-            if (!*json_out) {
-                fail("Failed allocating JSON buffer");
-            }
-            std::memcpy(*json_out, json.c_str(), json.size() + 1);
-        }
-        return 0;
+        OperatorConfig native = operatorFromC(*cfg);
+        setJsonOut(json_out, runOperator(native));
+        return CADS_RUN_OK;
     } catch (const std::exception& ex) {
-        if (err_out) {
-            const std::string msg = ex.what();
-            *err_out = static_cast<char*>(std::malloc(msg.size() + 1));
-            if (*err_out) {
-                std::memcpy(*err_out, msg.c_str(), msg.size() + 1);
-            }
-        }
-        return 1;
+        setErrorOut(err_out, ex.what());
+        return CADS_RUN_ERROR;
+    }
+}
+
+extern "C" int cads_zygote_suits(const char* fmu_path, int* suits, char** err_out) {
+    if (err_out) {
+        *err_out = nullptr;
+    }
+    if (!fmu_path || !suits) {
+        setErrorOut(err_out, "FMU path and result are required");
+        return CADS_RUN_ERROR;
+    }
+    try {
+        *suits = PythonZygote::instance().suits(fmu_path) ? 1 : 0;
+        return CADS_RUN_OK;
+    } catch (const std::exception& ex) {
+        setErrorOut(err_out, ex.what());
+        return CADS_RUN_ERROR;
+    }
+}
+
+extern "C" int cads_fmu_digest(const char* fmu_path, char** digest_out, char** err_out) {
+    if (err_out) {
+        *err_out = nullptr;
+    }
+    if (digest_out) {
+        *digest_out = nullptr;
+    }
+    if (!fmu_path || !digest_out) {
+        setErrorOut(err_out, "FMU path and result are required");
+        return CADS_RUN_ERROR;
+    }
+    try {
+        setJsonOut(digest_out, fmuDigest(fmu_path));
+        return CADS_RUN_OK;
+    } catch (const std::exception& ex) {
+        setErrorOut(err_out, ex.what());
+        return CADS_RUN_ERROR;
     }
 }
 
 extern "C" void cads_free_string(char* ptr) {
     std::free(ptr);
 }
+
+extern "C" void cads_priority_hold(void) {
+    PriorityGate::instance().hold();
+}
+
+extern "C" void cads_priority_release(void) {
+    PriorityGate::instance().release();
+}
+
+// A process started as the Python zygote serves it here, from the last static
+// initializer of the bridge, and never returns to Go; only its forked children
+// do.
+bool serveZygoteIfRequested() {
+    const char* worker = std::getenv("CADS_FMI_WORKER");
+    if (!worker || std::strcmp(worker, "zygote") != 0) {
+        return false;
+    }
+    PythonZygote::instance().serve();
+    return true;
+}
+
+const bool zygoteChild = serveZygoteIfRequested();
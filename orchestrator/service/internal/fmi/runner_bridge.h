@@ -7,15 +7,139 @@
 extern "C" {
 #endif
 
+/* Return codes of cads_run_fmu. */
+enum {
+    CADS_RUN_OK = 0,
+    CADS_RUN_ERROR = 1,
+    /* The FMU is not reentrant and another run in this process currently holds
+       its admission slot; the caller should retry in an isolated worker process. */
+    CADS_RUN_NEEDS_ISOLATION = 2,
+};
+
+/* Scheduling classes. Batch runs pause at communication-step boundaries while
+   interactive work is running or queued, and resume where they stopped. */
+enum {
+    CADS_PRIORITY_INTERACTIVE = 0,
+    CADS_PRIORITY_BATCH = 1,
+};
+
 typedef struct {
     const char* name;
     const char* value;
 } cads_assignment;
 
+/* Types of cads_start_value. */
+enum {
+    CADS_VALUE_REAL = 0,
+    CADS_VALUE_INTEGER = 1,
+    CADS_VALUE_BOOLEAN = 2,
+    /* Bytes of the string table; only string variables accept them. */
+    CADS_VALUE_STRING = 3,
+};
+
+/* Byte range [offset, offset + length) of a config's string table. */
+typedef struct {
+    size_t offset;
+    size_t length;
+} cads_string_ref;
+
+/* A start value set without a text round trip. Integer variables take
+   integers exactly; reals are rounded as for text start values. */
+typedef struct {
+    cads_string_ref name;
+    int type;
+    union {
+        double real;
+        long long integer;
+        bool boolean;
+        cads_string_ref text;
+    } value;
+} cads_start_value;
+
+/* Input series file layouts. */
+enum {
+    /* Header on the first line, numeric seconds in the first column. */
+    CADS_INPUT_DIALECT_PLAIN = 0,
+    /* Raw acoustic-emission export: a Key:,Value metadata preamble, then a
+       header whose first column is "Arrival time" (D:HH:MM:SS:frac). Times are
+       seconds since the first event and the preamble is returned as
+       "input_metadata". Requires a column map. */
+    CADS_INPUT_DIALECT_AE = 1,
+    /* PostgreSQL `COPY ... TO STDOUT (FORMAT binary)` output, from a file or a
+       pipe. Requires a field list; the first field is the time. Timestamp
+       times are seconds since the first row. */
+    CADS_INPUT_DIALECT_PGCOPY = 2,
+};
+
+/* How an input series sets its variables between rows. */
+enum {
+    /* Each row is applied once simulation time reaches it and held. */
+    CADS_INPUT_INTERPOLATION_HOLD = 0,
+    /* Variables follow the straight line between the rows around the current
+       communication point; before the first row nothing is applied and after
+       the last row its values are held. */
+    CADS_INPUT_INTERPOLATION_LINEAR = 1,
+};
+
 typedef struct {
     const char* csv_path;
+    int dialect;
+    int interpolation;
+    /* CSV column (name) -> FMU variable (value). When empty every column is
+       applied under its header name. */
+    const cads_assignment* columns;
+    size_t column_count;
+    /* Columns that are neither applied nor converted. Names missing from the
+       file are allowed. */
+    const char* const* ignore_columns;
+    size_t ignore_column_count;
+    /* Field name -> type (float8, float4, int8, int4, int2, bool, timestamp,
+       timestamptz) of every column of a PGCOPY dump, in column order. */
+    const cads_assignment* fields;
+    size_t field_count;
 } cads_input_series;
 
+/* Live input frame encodings. */
+enum {
+    /* One CSV line per sample, time in the first column. The first line is
+       the header unless a field list is given. */
+    CADS_LIVE_FORMAT_CSV = 0,
+    /* Fixed records of little-endian float64s, one per field, time first.
+       Requires a field list. */
+    CADS_LIVE_FORMAT_BINARY = 1,
+};
+
+/* What a live run does when consecutive samples are further apart than
+   max_gap. */
+enum {
+    /* Step through the gap at the configured step size. */
+    CADS_LIVE_GAP_STEP = 0,
+    /* Cover the gap with a single doStep. */
+    CADS_LIVE_GAP_JUMP = 1,
+    /* Fail the run. */
+    CADS_LIVE_GAP_FAIL = 2,
+};
+
+/* Samples read from a FIFO, file or Unix socket while the run advances. Each
+   sample steps the FMU up to its time, is applied, and one JSON line of
+   outputs is written to output_path. */
+typedef struct {
+    const char* input_path;
+    const char* output_path;
+    int format;
+    /* Field (name) -> FMU variable (value); as for input series. */
+    const cads_assignment* columns;
+    size_t column_count;
+    /* Field names in frame order, time first. */
+    const char* const* fields;
+    size_t field_count;
+    /* Samples buffered ahead of the FMU before reads stop (0 = 1024). */
+    size_t queue_depth;
+    bool has_max_gap;
+    double max_gap;
+    int gap_policy;
+} cads_live_input;
+
 typedef struct {
     const char* fmu_path;
     bool has_start_time;
@@ -26,20 +150,134 @@ typedef struct {
     double step_size;
     const cads_assignment* start_values;
     size_t start_value_count;
+    /* Series merged by time while the run advances. Held rows are applied in
+       time order across series, ties in list order. */
     const cads_input_series* input_series;
+    size_t input_series_count;
+    /* Live input instead of input series; NULL for batch runs. */
+    const cads_live_input* live;
     const char* const* outputs;
     size_t output_count;
+    /* Times at which the outputs are also read. The step schedule is split at
+       each of them and the result carries "outputs_at": {"time": [...],
+       "values": {name: [...]}} for the times the run reached. */
+    const double* outputs_at;
+    size_t outputs_at_count;
     const char* const* trace_outputs;
     size_t trace_output_count;
     const char* const* trace_inputs;
     size_t trace_input_count;
     bool has_trace_interval;
     double trace_interval;
+    /* When false, non-reentrant FMUs wait for their admission slot instead of
+       returning CADS_RUN_NEEDS_ISOLATION. */
+    bool allow_isolation;
+    int priority;
+    /* Wall-clock budget in seconds. When it runs out the step loop stops at the
+       next communication point and the result carries "partial": true and the
+       simulated "reached_time". */
+    bool has_wall_budget;
+    double wall_budget;
+    /* For runs without trace, input series or live input: FMUs that can handle
+       variable communication step sizes advance by max_step (the whole horizon
+       when unset) per do_step instead of step_size. Other FMUs keep step_size. */
+    bool coalesce_steps;
+    bool has_max_step;
+    double max_step;
+    /* Start values applied after start_values. Their names and strings are
+       ranges of string_table, which is not NUL-terminated, so a parameter set
+       needs one table instead of a string per name and value. */
+    const cads_start_value* typed_start_values;
+    size_t typed_start_value_count;
+    const char* string_table;
+    size_t string_table_size;
 } cads_fmu_config;
 
+/* cads_run_fmu is safe to call from multiple threads concurrently. */
 int cads_run_fmu(const cads_fmu_config* cfg, char** json_out, char** err_out);
+
+/* Runs count configs on a work-stealing pool of `workers` threads (0 = one per
+   core). Each worker advances up to `interleave` runs (0 or 1 = one at a time)
+   round robin, one communication step each; with interleave > 1, configs of
+   non-reentrant FMUs must set allow_isolation. On CADS_RUN_OK, json_out holds a
+   JSON array with one {"status": "ok"|"error"|"isolate", "result"|"error": ...}
+   entry per config, in input order. Entries with status "isolate" should be
+   retried in an isolated worker process. */
+int cads_run_batch(
+    const cads_fmu_config* cfgs, size_t count, size_t workers, size_t interleave, char** json_out, char** err_out);
+
+/* pythonfmu zygote. A process started with CADS_FMI_WORKER=zygote is served by
+   the bridge before the Go runtime starts: it loads the libpython that the
+   pythonfmu FMU named by CADS_PYTHON_ZYGOTE_FMU links against, initializes the
+   interpreter, imports CADS_PYTHON_ZYGOTE_IMPORTS (modules that fail to import
+   are skipped; those must not start threads, as numpy does with OpenBLAS
+   unless OPENBLAS_NUM_THREADS=1) and writes "ok" or "error: ..." to
+   descriptor 4. It then forks a child, still single-threaded, for each
+   connection accepted on the Unix socket at descriptor 3 and exits when its
+   stdin closes. A child continues
+   into Go with the connection as descriptor 3 and CADS_FMI_WORKER=zygote-run.
+   cads_zygote_suits sets *suits to 1 when the FMU at fmu_path is a pythonfmu
+   FMU built against the zygote's libpython and to 0 otherwise. */
+int cads_zygote_suits(const char* fmu_path, int* suits, char** err_out);
+
+/* Sets *digest_out to the hex SHA-256 of the file at fmu_path, the key under
+   which concurrent runs share one unpack of an archive. Free it with
+   cads_free_string. */
+int cads_fmu_digest(const char* fmu_path, char** digest_out, char** err_out);
+
+/* Built-in operators over one signal. Windows are trailing, (t - window, t]. */
+enum {
+    /* value * factor + offset. */
+    CADS_OP_SCALE = 0,
+    /* 1 where value >= level, else 0. */
+    CADS_OP_THRESHOLD = 1,
+    /* Mean of the samples with a value in the window; NaN when none has. */
+    CADS_OP_ROLLING_MEAN = 2,
+    CADS_OP_ROLLING_QUANTILE = 3,
+    /* Samples at start, start + interval, ... up to the last time, held or
+       linearly interpolated; at most 10 million points. */
+    CADS_OP_RESAMPLE = 4,
+    /* One quantile of the whole signal. */
+    CADS_OP_QUANTILE = 5,
+};
+
+typedef struct {
+    int op;
+    /* The signal, either count samples sorted by time or the single applied
+       column of input_series. */
+    const double* times;
+    const double* values;
+    size_t count;
+    const cads_input_series* input_series;
+    /* With input_series only, and then both or neither: read the rows a run
+       from start_time to stop_time observes, through the series' sparse index
+       when the file is large. */
+    bool has_start_time;
+    double start_time;
+    bool has_stop_time;
+    double stop_time;
+    double window;
+    double interval;
+    /* CADS_INPUT_INTERPOLATION_*; input_series signals use their own. */
+    int interpolation;
+    /* Quantile level in [0, 1], linearly interpolated between samples. */
+    double quantile;
+    double factor;
+    double offset;
+    double level;
+} cads_operator_config;
+
+/* Runs one operator. json_out holds {"value": <last or reduced value>} plus,
+   for signal results, "trace": {"time": [...], "signals": {"value": [...]}}. */
+int cads_run_operator(const cads_operator_config* cfg, char** json_out, char** err_out);
+
 void cads_free_string(char* ptr);
 
+/* Announce (hold) and withdraw (release) pending interactive work, for example
+   while a scheduler has an interactive request queued. Calls nest. */
+void cads_priority_hold(void);
+void cads_priority_release(void);
+
 #ifdef __cplusplus
 }
 #endif
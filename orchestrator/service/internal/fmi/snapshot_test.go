@@ -0,0 +1,34 @@
+//go:build cgo
+
+package fmi
+
+import (
+	"reflect"
+	"testing"
+)
+
+func TestOutputsAtSnapshotsFollowTheStepGrid(t *testing.T) {
+	// CITest.fmu cannot vary its communication step, so requests between grid
+	// points are read at the next point, and 2.2 and 2.5 share the one at 3.
+	result, err := Run(Config{
+		FMUPath:   ciTestFMU,
+		Outputs:   []string{"time"},
+		OutputsAt: []float64{-1, 0, 2.2, 2.5, 10, 29.5, 40},
+	})
+	if err != nil {
+		t.Fatalf("run: %v", err)
+	}
+	snapshots, ok := result["outputs_at"].(map[string]any)
+	if !ok {
+		t.Fatalf("result = %v, want outputs_at", result)
+	}
+	want := []any{0.0, 3.0, 10.0, 30.0}
+	if got := snapshots["time"]; !reflect.DeepEqual(got, want) {
+		t.Fatalf("outputs_at times = %v, want %v", got, want)
+	}
+	// The FMU's own time agrees with every reported snapshot time.
+	values := snapshots["values"].(map[string]any)
+	if got := values["time"]; !reflect.DeepEqual(got, want) {
+		t.Fatalf("outputs_at time values = %v, want %v", got, want)
+	}
+}
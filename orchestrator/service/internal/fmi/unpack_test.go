@@ -0,0 +1,93 @@
+//go:build cgo
+
+package fmi
+
+import (
+	"os"
+	"path/filepath"
+	"reflect"
+	"strconv"
+	"strings"
+	"testing"
+)
+
+// ciTestFMU is a Simulink FMI 3.0 FMU whose only variable is time. It steps on
+// a fixed 1 s grid from 0 to 30 s.
+var ciTestFMU = filepath.Join("..", "..", "..", "fmu", "models", "CITest.fmu")
+
+// copyFMU copies ciTestFMU to dir/name.
+func copyFMU(t *testing.T, dir, name string) string {
+	t.Helper()
+	data, err := os.ReadFile(ciTestFMU)
+	if err != nil {
+		t.Fatalf("read CITest.fmu: %v", err)
+	}
+	path := filepath.Join(dir, name)
+	if err := os.WriteFile(path, data, 0o644); err != nil {
+		t.Fatalf("write %s: %v", path, err)
+	}
+	return path
+}
+
+func TestRunSharesUnpackOfIdenticalArchives(t *testing.T) {
+	models := t.TempDir()
+	scratch := t.TempDir()
+	t.Setenv("TMPDIR", scratch)
+
+	var results []map[string]any
+	for _, name := range []string{"a.fmu", "b.fmu", "a.fmu"} {
+		result, err := Run(Config{FMUPath: copyFMU(t, models, name)})
+		if err != nil {
+			t.Fatalf("run %s: %v", name, err)
+		}
+		results = append(results, result)
+	}
+	if !reflect.DeepEqual(results[0], results[1]) || !reflect.DeepEqual(results[0], results[2]) {
+		t.Fatalf("results = %v, want copies of one archive to run alike", results)
+	}
+
+	// Every unpack goes away with its last run.
+	entries, err := os.ReadDir(scratch)
+	if err != nil {
+		t.Fatalf("read %s: %v", scratch, err)
+	}
+	for _, entry := range entries {
+		if strings.HasPrefix(entry.Name(), "cads-fmi-") {
+			t.Fatalf("unpack %s outlived its runs", entry.Name())
+		}
+	}
+
+	// A different archive under a path that was run before is unpacked anew
+	// rather than handed the earlier binaries.
+	broken := filepath.Join(models, "a.fmu")
+	if err := os.WriteFile(broken, []byte("not an fmu"), 0o644); err != nil {
+		t.Fatalf("write %s: %v", broken, err)
+	}
+	if _, err := Run(Config{FMUPath: broken}); err == nil {
+		t.Fatal("run of a replaced archive: error = nil, want it unpacked again and rejected")
+	}
+}
+
+func TestArchiveDigestMatchesSHA256Vectors(t *testing.T) {
+	// FIPS 180-4 examples; the last two span two blocks and many.
+	dir := t.TempDir()
+	for i, tc := range []struct {
+		message string
+		want    string
+	}{
+		{"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+		{"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+		{"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+		{"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu", "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1"},
+		{strings.Repeat("a", 1000000), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"},
+	} {
+		path := filepath.Join(dir, strconv.Itoa(i)+".fmu")
+		if err := os.WriteFile(path, []byte(tc.message), 0o644); err != nil {
+			t.Fatalf("write %s: %v", path, err)
+		}
+		got, err := archiveDigest(path)
+		if err != nil || got != tc.want {
+			t.Fatalf("digest of %d-byte message = %q, %v; want %s", len(tc.message), got, err, tc.want)
+		}
+	}
+}
@@ -0,0 +1,27 @@
+package fmi
+
+// ValueKind is the type of a StartValue; the values match CADS_VALUE_*.
+type ValueKind int
+
+const (
+	ValueReal ValueKind = iota
+	ValueInteger
+	ValueBoolean
+	ValueString
+)
+
+// StartValue is a typed start value. It reaches the bridge as a tagged union
+// rather than text, so float64 and int64 values arrive exactly. Integer
+// variables round reals; string values only fit string variables.
+type StartValue struct {
+	Kind    ValueKind `json:"kind"`
+	Real    float64   `json:"real,omitempty"`
+	Integer int64     `json:"integer,omitempty"`
+	Bool    bool      `json:"bool,omitempty"`
+	Text    string    `json:"text,omitempty"`
+}
+
+func RealValue(v float64) StartValue  { return StartValue{Kind: ValueReal, Real: v} }
+func IntegerValue(v int64) StartValue { return StartValue{Kind: ValueInteger, Integer: v} }
+func BoolValue(v bool) StartValue     { return StartValue{Kind: ValueBoolean, Bool: v} }
+func StringValue(v string) StartValue { return StartValue{Kind: ValueString, Text: v} }
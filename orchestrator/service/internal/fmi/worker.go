@@ -0,0 +1,138 @@
+package fmi
+
+import (
+	"bytes"
+	"encoding/json"
+	"errors"
+	"fmt"
+	"io"
+	"os"
+	"os/exec"
+)
+
+// errNeedsIsolation reports that the bridge refused to run a non-reentrant FMU
+// in-process because another run currently holds its admission slot.
+var errNeedsIsolation = errors.New("fmi: FMU requires an isolated worker process")
+
+// workerEnv marks a process that was re-executed to run a single FMU in isolation.
+const workerEnv = "CADS_FMI_WORKER"
+
+// workerResultFD is the descriptor the worker writes its response to, so FMU
+// output printed to stdout (for example by pythonfmu slaves) cannot corrupt it.
+const workerResultFD = 3
+
+type workerResponse struct {
+	Result map[string]any `json:"result,omitempty"`
+	Error  string         `json:"error,omitempty"`
+	// Unsuitable is set by a Python zygote for FMUs it cannot fork a run of.
+	Unsuitable bool `json:"unsuitable,omitempty"`
+}
+
+// ServeIsolatedWorker runs the FMU requested on stdin and exits when the current
+// process was started as an isolated worker. Binaries that call Run must invoke it
+// at the top of main, before any flag parsing.
+func ServeIsolatedWorker() {
+	switch os.Getenv(workerEnv) {
+	case "1":
+	case zygoteWorker:
+		// The bridge serves the zygote before Go starts; getting here means
+		// this binary was built without it.
+		fmt.Fprintln(os.Stderr, "fmi zygote: the FMIL bridge is not linked in")
+		os.Exit(1)
+	case zygoteRunWorker:
+		conn := os.NewFile(zygoteConnFD, "cads-fmi-zygote-conn")
+		if conn == nil {
+			fmt.Fprintln(os.Stderr, "fmi zygote: connection descriptor is missing")
+			os.Exit(1)
+		}
+		err := serveZygoteRun(conn, zygoteSuits, func(cfg Config) (map[string]any, error) {
+			return run(cfg, false)
+		})
+		if err != nil {
+			fmt.Fprintf(os.Stderr, "fmi zygote: %v\n", err)
+			os.Exit(1)
+		}
+		os.Exit(0)
+	default:
+		return
+	}
+	out := os.NewFile(workerResultFD, "cads-fmi-result")
+	if out == nil {
+		fmt.Fprintln(os.Stderr, "fmi worker: result descriptor is missing")
+		os.Exit(1)
+	}
+	err := serveWorker(os.Stdin, out, func(cfg Config) (map[string]any, error) {
+		return run(cfg, false)
+	})
+	if err != nil {
+		fmt.Fprintf(os.Stderr, "fmi worker: %v\n", err)
+		os.Exit(1)
+	}
+	os.Exit(0)
+}
+
+func serveWorker(in io.Reader, out io.Writer, execute func(Config) (map[string]any, error)) error {
+	var cfg Config
+	if err := json.NewDecoder(in).Decode(&cfg); err != nil {
+		return fmt.Errorf("decode worker request: %w", err)
+	}
+	var resp workerResponse
+	result, err := execute(cfg)
+	if err != nil {
+		resp.Error = err.Error()
+	} else {
+		resp.Result = result
+	}
+	return json.NewEncoder(out).Encode(resp)
+}
+
+// runIsolated runs cfg in a child of the Python zygote when it can, and
+// otherwise re-executes the current binary as a worker process and runs cfg there.
+// Batch runs are not dispatched while interactive work holds the priority gate.
+func runIsolated(cfg Config) (map[string]any, error) {
+	if cfg.Priority == PriorityBatch {
+		interactiveHolds.wait()
+	}
+	if result, handled, err := pythonZygote.run(cfg); handled {
+		return result, err
+	}
+	exe, err := os.Executable()
+	if err != nil {
+		return nil, fmt.Errorf("fmi: locate worker executable: %w", err)
+	}
+	payload, err := json.Marshal(cfg)
+	if err != nil {
+		return nil, fmt.Errorf("fmi: encode worker request: %w", err)
+	}
+	reader, writer, err := os.Pipe()
+	if err != nil {
+		return nil, fmt.Errorf("fmi: create worker pipe: %w", err)
+	}
+	defer reader.Close()
+
+	cmd := exec.Command(exe)
+	cmd.Env = append(os.Environ(), workerEnv+"=1")
+	cmd.Stdin = bytes.NewReader(payload)
+	cmd.Stdout = os.Stderr
+	cmd.Stderr = os.Stderr
+	cmd.ExtraFiles = []*os.File{writer}
+	if err := cmd.Start(); err != nil {
+		writer.Close()
+		return nil, fmt.Errorf("fmi: start worker: %w", err)
+	}
+	writer.Close()
+
+	var resp workerResponse
+	decodeErr := json.NewDecoder(reader).Decode(&resp)
+	waitErr := cmd.Wait()
+	if decodeErr != nil {
+		if waitErr != nil {
+			return nil, fmt.Errorf("fmi: isolated worker failed: %w", waitErr)
+		}
+		return nil, fmt.Errorf("fmi: decode worker response: %w", decodeErr)
+	}
+	if resp.Error != "" {
+		return nil, fmt.Errorf("%s", resp.Error)
+	}
+	return resp.Result, nil
+}
@@ -0,0 +1,202 @@
+package fmi
+
+import (
+	"archive/zip"
+	"bytes"
+	"encoding/json"
+	"errors"
+	"net"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+)
+
+func TestServeWorkerRoundTripsConfigAndResult(t *testing.T) {
+	stop := 72.0
+	request, err := json.Marshal(Config{
+		FMUPath:     "/models/Demo.fmu",
+		StopTime:    &stop,
+		StartValues: map[string]StartValue{"scenario_id": IntegerValue(3)},
+		Outputs:     []string{"score"},
+	})
+	if err != nil {
+		t.Fatalf("marshal config: %v", err)
+	}
+
+	var got Config
+	var out bytes.Buffer
+	err = serveWorker(bytes.NewReader(request), &out, func(cfg Config) (map[string]any, error) {
+		got = cfg
+		return map[string]any{"score": 0.5}, nil
+	})
+	if err != nil {
+		t.Fatalf("serveWorker() error = %v", err)
+	}
+	if got.FMUPath != "/models/Demo.fmu" || got.StopTime == nil || *got.StopTime != stop || got.StartValues["scenario_id"] != IntegerValue(3) {
+		t.Fatalf("serveWorker() decoded %#v, want original config", got)
+	}
+
+	var resp workerResponse
+	if err := json.Unmarshal(out.Bytes(), &resp); err != nil {
+		t.Fatalf("decode response: %v", err)
+	}
+	if resp.Error != "" || resp.Result["score"] != 0.5 {
+		t.Fatalf("serveWorker() response = %#v, want score result", resp)
+	}
+}
+
+func TestServeWorkerReportsRunErrors(t *testing.T) {
+	var out bytes.Buffer
+	err := serveWorker(strings.NewReader(`{"FMUPath":"/models/Demo.fmu"}`), &out, func(Config) (map[string]any, error) {
+		return nil, errors.New("fmi2_do_step failed")
+	})
+	if err != nil {
+		t.Fatalf("serveWorker() error = %v", err)
+	}
+	if !strings.Contains(out.String(), "fmi2_do_step failed") {
+		t.Fatalf("serveWorker() response = %q, want run error", out.String())
+	}
+}
+
+func TestDecodeBatchResultsMapsStatuses(t *testing.T) {
+	results := make([]BatchResult, 3)
+	payload := `[{"status":"ok","result":{"score":1}},{"status":"isolate","error":"busy"},{"status":"error","error":"fmi2_do_step failed"}]`
+	if err := decodeBatchResults([]byte(payload), results); err != nil {
+		t.Fatalf("decodeBatchResults() error = %v", err)
+	}
+	if results[0].Err != nil || results[0].Result["score"] != 1.0 {
+		t.Fatalf("results[0] = %#v, want score result", results[0])
+	}
+	if !errors.Is(results[1].Err, errNeedsIsolation) {
+		t.Fatalf("results[1].Err = %v, want errNeedsIsolation", results[1].Err)
+	}
+	if results[2].Err == nil || !strings.Contains(results[2].Err.Error(), "fmi2_do_step failed") {
+		t.Fatalf("results[2].Err = %v, want run error", results[2].Err)
+	}
+}
+
+func TestDecodeBatchResultsRejectsLengthMismatch(t *testing.T) {
+	results := make([]BatchResult, 2)
+	if err := decodeBatchResults([]byte(`[{"status":"ok","result":{}}]`), results); err == nil {
+		t.Fatal("decodeBatchResults() error = nil, want length mismatch")
+	}
+}
+
+func TestServeZygoteRunAnswersForTheForkedChild(t *testing.T) {
+	socket := filepath.Join(t.TempDir(), "zygote.sock")
+	listener, err := net.Listen("unix", socket)
+	if err != nil {
+		t.Fatalf("listen: %v", err)
+	}
+	defer listener.Close()
+
+	// Each connection stands in for one forked child, which runs Demo.fmu and
+	// declines other FMUs.
+	suits := func(fmuPath string) (bool, error) {
+		return fmuPath == "/models/Demo.fmu", nil
+	}
+	execute := func(cfg Config) (map[string]any, error) {
+		return map[string]any{"score": 0.5}, nil
+	}
+	go func() {
+		for {
+			conn, err := listener.Accept()
+			if err != nil {
+				return
+			}
+			serveZygoteRun(conn, suits, execute)
+			conn.Close()
+		}
+	}()
+
+	resp, err := requestZygote(socket, Config{FMUPath: "/models/Demo.fmu"})
+	if err != nil || resp.Error != "" || resp.Result["score"] != 0.5 {
+		t.Fatalf("requestZygote() = %#v, %v, want score result", resp, err)
+	}
+	resp, err = requestZygote(socket, Config{FMUPath: "/models/Native.fmu"})
+	if err != nil || !resp.Unsuitable {
+		t.Fatalf("requestZygote() = %#v, %v, want unsuitable", resp, err)
+	}
+}
+
+// writeFMU writes a zip archive of files to dir/name.
+func writeFMU(t *testing.T, dir, name string, files map[string]string) string {
+	t.Helper()
+	var archive bytes.Buffer
+	zw := zip.NewWriter(&archive)
+	for fileName, body := range files {
+		w, err := zw.Create(fileName)
+		if err != nil {
+			t.Fatalf("zip %s: %v", fileName, err)
+		}
+		w.Write([]byte(body))
+	}
+	if err := zw.Close(); err != nil {
+		t.Fatalf("zip: %v", err)
+	}
+	path := filepath.Join(dir, name)
+	if err := os.WriteFile(path, archive.Bytes(), 0o644); err != nil {
+		t.Fatalf("write %s: %v", path, err)
+	}
+	return path
+}
+
+func TestZygoteOnlyTakesPythonFMUs(t *testing.T) {
+	dir := t.TempDir()
+	description := func(tool string) string {
+		return `<?xml version="1.0" encoding="UTF-8"?>
+<fmiModelDescription fmiVersion="2.0" modelName="Demo" generationTool="` + tool + `"><ModelVariables/></fmiModelDescription>`
+	}
+	native := writeFMU(t, dir, "Native.fmu", map[string]string{"modelDescription.xml": description("Simulink (R2024a)")})
+	for path, want := range map[string]bool{
+		native: false,
+		writeFMU(t, dir, "Tool.fmu", map[string]string{"modelDescription.xml": description("PythonFMU 0.6.5")}): true,
+		writeFMU(t, dir, "Slave.fmu", map[string]string{
+			"modelDescription.xml":      description(""),
+			"resources/slavemodule.txt": "model.py",
+		}): true,
+		filepath.Join(dir, "missing.fmu"): false,
+	} {
+		if got := isPythonFMU(path); got != want {
+			t.Fatalf("isPythonFMU(%s) = %v, want %v", filepath.Base(path), got, want)
+		}
+	}
+
+	// Other FMUs go to a fresh worker without starting a zygote for them.
+	t.Setenv(zygoteEnv, "")
+	var z zygote
+	if _, handled, err := z.run(Config{FMUPath: native}); handled || err != nil || z.socket != "" || z.rejected != nil {
+		t.Fatalf("run(Native.fmu) handled = %v, err = %v, socket = %q; want it left to a fresh worker", handled, err, z.socket)
+	}
+
+	// A rewritten archive is checked again.
+	writeFMU(t, dir, "Native.fmu", map[string]string{
+		"modelDescription.xml":      description("Simulink (R2024a)"),
+		"resources/slavemodule.txt": "model.py",
+	})
+	if !isPythonFMU(native) {
+		t.Fatal("isPythonFMU(rewritten Native.fmu) = false, want the new archive checked")
+	}
+}
+
+func TestInteractiveHoldDelaysIsolatedBatchRuns(t *testing.T) {
+	var holds holdCounter
+	holds.wait()
+
+	holds.hold()
+	holds.hold()
+	released := make(chan struct{})
+	go func() {
+		holds.wait()
+		close(released)
+	}()
+	holds.release()
+	select {
+	case <-released:
+		t.Fatal("wait() returned while a hold is still active")
+	default:
+	}
+	holds.release()
+	<-released
+}
@@ -0,0 +1,328 @@
+package fmi
+
+import (
+	"archive/zip"
+	"bufio"
+	"encoding/json"
+	"encoding/xml"
+	"fmt"
+	"io"
+	"net"
+	"os"
+	"os/exec"
+	"path/filepath"
+	"strings"
+	"sync"
+	"time"
+)
+
+const (
+	// zygoteWorker is the workerEnv value of a Python zygote process.
+	zygoteWorker = "zygote"
+	// zygoteEnv set to "0" disables the zygote; isolated runs then always
+	// start a fresh worker process.
+	zygoteEnv = "CADS_PYTHON_ZYGOTE"
+	// zygoteImportsEnv lists the modules the zygote imports up front,
+	// comma-separated.
+	zygoteImportsEnv = "CADS_PYTHON_ZYGOTE_IMPORTS"
+	// zygoteFMUEnv names the pythonfmu FMU whose libpython the zygote loads.
+	zygoteFMUEnv = "CADS_PYTHON_ZYGOTE_FMU"
+
+	// defaultZygoteImports leaves out numpy: OpenBLAS starts its threads on
+	// import, and the zygote must still be single-threaded when it forks.
+	defaultZygoteImports = "pythonfmu"
+
+	// zygoteRunWorker is the workerEnv value of a child forked by the zygote.
+	zygoteRunWorker = "zygote-run"
+	// zygoteConnFD is the descriptor holding a forked child's connection.
+	zygoteConnFD = 3
+)
+
+// zygote is a long-lived worker process holding an initialized CPython
+// interpreter. Isolated runs of pythonfmu FMUs are forked from it, so they
+// start with the interpreter up and the common modules imported instead of
+// paying for both in a fresh process. The bridge serves the zygote before the
+// Go runtime starts, so it forks from a single thread; each child then starts
+// Go and serves one request. It is started on the first isolated run of a
+// pythonfmu FMU and exits when this process does.
+type zygote struct {
+	mu     sync.Mutex
+	socket string
+	cmd    *exec.Cmd
+	// keepAlive is the zygote's stdin; the zygote exits when it closes.
+	keepAlive io.WriteCloser
+	// rejected holds pythonfmu FMUs that could not prepare a zygote (no
+	// libpython, say), so they are not tried again.
+	rejected map[string]bool
+}
+
+var pythonZygote zygote
+
+// run executes cfg in a zygote child. handled is false when the zygote is
+// disabled, cfg's FMU is not a pythonfmu FMU, the zygote cannot be started for
+// it or reports it as unsuitable; the caller then runs cfg in a fresh worker
+// process.
+func (z *zygote) run(cfg Config) (result map[string]any, handled bool, err error) {
+	if os.Getenv(zygoteEnv) == "0" || !isPythonFMU(cfg.FMUPath) {
+		return nil, false, nil
+	}
+	socket, ok := z.ensure(cfg.FMUPath)
+	if !ok {
+		return nil, false, nil
+	}
+	resp, err := requestZygote(socket, cfg)
+	if err != nil {
+		// A zygote that cannot be reached is replaced on the next run.
+		z.drop(socket)
+		return nil, false, nil
+	}
+	if resp.Unsuitable {
+		return nil, false, nil
+	}
+	if resp.Error != "" {
+		return nil, true, fmt.Errorf("%s", resp.Error)
+	}
+	return resp.Result, true, nil
+}
+
+func (z *zygote) ensure(fmuPath string) (string, bool) {
+	z.mu.Lock()
+	defer z.mu.Unlock()
+	if z.socket != "" {
+		return z.socket, true
+	}
+	if z.rejected[fmuPath] {
+		return "", false
+	}
+	if err := z.start(fmuPath); err != nil {
+		if z.rejected == nil {
+			z.rejected = make(map[string]bool)
+		}
+		z.rejected[fmuPath] = true
+		fmt.Fprintf(os.Stderr, "fmi: python zygote unavailable for %s: %v\n", fmuPath, err)
+		return "", false
+	}
+	return z.socket, true
+}
+
+func (z *zygote) start(fmuPath string) error {
+	exe, err := os.Executable()
+	if err != nil {
+		return fmt.Errorf("locate worker executable: %w", err)
+	}
+	dir, err := os.MkdirTemp("", "cads-zygote-")
+	if err != nil {
+		return err
+	}
+	socket := filepath.Join(dir, "zygote.sock")
+	listener, err := net.ListenUnix("unix", &net.UnixAddr{Name: socket, Net: "unix"})
+	if err != nil {
+		os.RemoveAll(dir)
+		return err
+	}
+	// The zygote owns the socket from here on; closing our copy must not
+	// remove it.
+	listener.SetUnlinkOnClose(false)
+	listenerFile, err := listener.File()
+	listener.Close()
+	if err != nil {
+		os.RemoveAll(dir)
+		return err
+	}
+	defer listenerFile.Close()
+	readyReader, readyWriter, err := os.Pipe()
+	if err != nil {
+		os.RemoveAll(dir)
+		return err
+	}
+	defer readyReader.Close()
+
+	imports := os.Getenv(zygoteImportsEnv)
+	if imports == "" {
+		imports = defaultZygoteImports
+	}
+	cmd := exec.Command(exe)
+	cmd.Env = append(os.Environ(), workerEnv+"="+zygoteWorker, zygoteFMUEnv+"="+fmuPath, zygoteImportsEnv+"="+imports)
+	cmd.Stdout = os.Stderr
+	cmd.Stderr = os.Stderr
+	cmd.ExtraFiles = []*os.File{listenerFile, readyWriter}
+	keepAlive, err := cmd.StdinPipe()
+	if err != nil {
+		readyWriter.Close()
+		os.RemoveAll(dir)
+		return err
+	}
+	if err := cmd.Start(); err != nil {
+		readyWriter.Close()
+		os.RemoveAll(dir)
+		return fmt.Errorf("start zygote: %w", err)
+	}
+	readyWriter.Close()
+
+	status, _ := bufio.NewReader(readyReader).ReadString('\n')
+	status = strings.TrimSpace(status)
+	if status != "ok" {
+		keepAlive.Close()
+		cmd.Wait()
+		os.RemoveAll(dir)
+		if status == "" {
+			status = "zygote exited before it was ready"
+		}
+		return fmt.Errorf("%s", strings.TrimPrefix(status, "error: "))
+	}
+	z.socket, z.cmd, z.keepAlive = socket, cmd, keepAlive
+	return nil
+}
+
+// drop forgets a zygote that stopped answering and stops it.
+func (z *zygote) drop(socket string) {
+	z.mu.Lock()
+	defer z.mu.Unlock()
+	if z.socket != socket {
+		return
+	}
+	z.keepAlive.Close()
+	go z.cmd.Wait()
+	os.RemoveAll(filepath.Dir(socket))
+	z.socket, z.cmd, z.keepAlive = "", nil, nil
+}
+
+// requestZygote sends cfg to the zygote at socket and returns the response
+// written by the forked child (or by the zygote itself for unsuitable FMUs).
+func requestZygote(socket string, cfg Config) (workerResponse, error) {
+	var resp workerResponse
+	conn, err := net.Dial("unix", socket)
+	if err != nil {
+		return resp, err
+	}
+	defer conn.Close()
+	if err := json.NewEncoder(conn).Encode(cfg); err != nil {
+		return resp, err
+	}
+	if unix, ok := conn.(*net.UnixConn); ok {
+		unix.CloseWrite()
+	}
+	if err := json.NewDecoder(conn).Decode(&resp); err != nil {
+		// The request reached the zygote, so the run may have started: report
+		// it rather than running the FMU a second time.
+		return workerResponse{Error: fmt.Sprintf("fmi: zygote run exited without a result: %v", err)}, nil
+	}
+	return resp, nil
+}
+
+// serveZygoteRun serves the one request on a connection handed to a child of
+// the zygote. FMUs that cannot use the zygote's interpreter are reported
+// unsuitable rather than run.
+func serveZygoteRun(conn io.ReadWriter, suits func(string) (bool, error), execute func(Config) (map[string]any, error)) error {
+	var cfg Config
+	if err := json.NewDecoder(conn).Decode(&cfg); err != nil {
+		return fmt.Errorf("decode zygote request: %w", err)
+	}
+	var resp workerResponse
+	ok, err := suits(cfg.FMUPath)
+	switch {
+	case err != nil:
+		resp.Error = err.Error()
+	case !ok:
+		resp.Unsuitable = true
+	default:
+		result, err := execute(cfg)
+		if err != nil {
+			resp.Error = err.Error()
+		} else {
+			resp.Result = result
+		}
+	}
+	return json.NewEncoder(conn).Encode(resp)
+}
+
+// maxPythonChecks bounds the archives whose isPythonFMU answer is remembered.
+const maxPythonChecks = 1024
+
+type pythonCheck struct {
+	size    int64
+	modTime time.Time
+	python  bool
+}
+
+var pythonChecks struct {
+	sync.Mutex
+	byPath map[string]pythonCheck
+}
+
+// isPythonFMU reports whether the FMU at path is a pythonfmu FMU, by the signs
+// the bridge uses: a generation tool naming pythonfmu or a
+// resources/slavemodule.txt. Other FMUs, and files that are not readable
+// archives, never reach the zygote. Answers are kept per path until the file
+// changes.
+func isPythonFMU(path string) bool {
+	info, err := os.Stat(path)
+	if err != nil {
+		return false
+	}
+	pythonChecks.Lock()
+	known, ok := pythonChecks.byPath[path]
+	pythonChecks.Unlock()
+	if ok && known.size == info.Size() && known.modTime.Equal(info.ModTime()) {
+		return known.python
+	}
+
+	python := archiveIsPythonFMU(path)
+	pythonChecks.Lock()
+	defer pythonChecks.Unlock()
+	if pythonChecks.byPath == nil {
+		pythonChecks.byPath = make(map[string]pythonCheck)
+	}
+	if _, ok := pythonChecks.byPath[path]; !ok && len(pythonChecks.byPath) >= maxPythonChecks {
+		for stale := range pythonChecks.byPath {
+			delete(pythonChecks.byPath, stale)
+			break
+		}
+	}
+	pythonChecks.byPath[path] = pythonCheck{size: info.Size(), modTime: info.ModTime(), python: python}
+	return python
+}
+
+func archiveIsPythonFMU(path string) bool {
+	archive, err := zip.OpenReader(path)
+	if err != nil {
+		return false
+	}
+	defer archive.Close()
+	for _, file := range archive.File {
+		switch file.Name {
+		case "resources/slavemodule.txt":
+			return true
+		case "modelDescription.xml":
+			if generationToolIsPythonFMU(file) {
+				return true
+			}
+		}
+	}
+	return false
+}
+
+// generationToolIsPythonFMU reads the generationTool attribute of the model
+// description's root element.
+func generationToolIsPythonFMU(file *zip.File) bool {
+	body, err := file.Open()
+	if err != nil {
+		return false
+	}
+	defer body.Close()
+	decoder := xml.NewDecoder(body)
+	for {
+		token, err := decoder.Token()
+		if err != nil {
+			return false
+		}
+		if root, ok := token.(xml.StartElement); ok {
+			for _, attr := range root.Attr {
+				if attr.Name.Local == "generationTool" {
+					return strings.Contains(strings.ToLower(attr.Value), "pythonfmu")
+				}
+			}
+			return false
+		}
+	}
+}
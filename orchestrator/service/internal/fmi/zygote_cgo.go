@@ -0,0 +1,31 @@
+//go:build cgo
+
+package fmi
+
+/*
+#include <stdlib.h>
+#include "runner_bridge.h"
+*/
+import "C"
+
+import (
+	"fmt"
+	"unsafe"
+)
+
+// zygoteSuits reports whether the FMU at fmuPath can run on the interpreter of
+// the zygote this process was forked from.
+func zygoteSuits(fmuPath string) (bool, error) {
+	cPath := C.CString(fmuPath)
+	defer C.free(unsafe.Pointer(cPath))
+	var suits C.int
+	var errOut *C.char
+	if C.cads_zygote_suits(cPath, &suits, &errOut) != C.CADS_RUN_OK {
+		if errOut != nil {
+			defer C.cads_free_string(errOut)
+			return false, fmt.Errorf("fmi zygote: %s", C.GoString(errOut))
+		}
+		return false, fmt.Errorf("fmi zygote: suitability check failed without error message")
+	}
+	return suits != 0, nil
+}
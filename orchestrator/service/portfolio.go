@@ -0,0 +1,148 @@
+package service
+
+import (
+	"context"
+	"fmt"
+	"io/fs"
+	"path"
+	"path/filepath"
+	"runtime"
+	"sort"
+	"strings"
+	"sync"
+
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/workflow"
+)
+
+// PortfolioResult is the consolidated outcome of RunPortfolio, keyed by
+// workflow path relative to the repository root.
+type PortfolioResult struct {
+	Workflows map[string]PortfolioRun `json:"workflows"`
+	Failed    int                     `json:"failed"`
+	// StepCacheHits counts steps answered by an identical earlier step; it
+	// stays zero unless the runner was created with workflow.WithStepCache.
+	StepCacheHits int64 `json:"step_cache_hits"`
+}
+
+// PortfolioRun holds either the results of one workflow or why it failed.
+type PortfolioRun struct {
+	Results map[string]map[string]any `json:"results,omitempty"`
+	Error   string                    `json:"error,omitempty"`
+}
+
+// RunPortfolio runs every workflow matched by patterns in this process. The
+// workflows are batch work: the scheduler admits as many at once as it has
+// batch slots, so their steps share the CPUs and the bridge's unpacked FMUs.
+// A failing workflow is recorded and does not stop the others.
+func (r *Runner) RunPortfolio(ctx context.Context, patterns []string, opts workflow.RunOptions) (*PortfolioResult, error) {
+	paths, err := ExpandWorkflowGlobs(r.WorkDir, patterns)
+	if err != nil {
+		return nil, err
+	}
+	if len(paths) == 0 {
+		return nil, fmt.Errorf("no workflows match %s", strings.Join(patterns, ", "))
+	}
+
+	opts.Priority = fmi.PriorityBatch
+	opts.SweepWorkers = portfolioSweepWorkers(runtime.NumCPU(), r.scheduler.batchSlots, len(paths))
+	runs := make([]PortfolioRun, len(paths))
+	var wg sync.WaitGroup
+	for i, workflowPath := range paths {
+		wg.Add(1)
+		go func(i int, workflowPath string) {
+			defer wg.Done()
+			results, err := r.RunWithOptions(ctx, workflowPath, opts)
+			if err != nil {
+				runs[i].Error = err.Error()
+				return
+			}
+			runs[i].Results = results
+		}(i, workflowPath)
+	}
+	wg.Wait()
+
+	portfolio := &PortfolioResult{
+		Workflows:     make(map[string]PortfolioRun, len(paths)),
+		StepCacheHits: r.exec.StepCacheHits(),
+	}
+	for i, workflowPath := range paths {
+		portfolio.Workflows[workflowPath] = runs[i]
+		if runs[i].Error != "" {
+			portfolio.Failed++
+		}
+	}
+	return portfolio, nil
+}
+
+// portfolioSweepWorkers splits the CPUs between the workflows that can hold a
+// batch slot at once, so their sweeps do not each start a thread per core.
+func portfolioSweepWorkers(cpus, batchSlots, workflows int) int {
+	return max(1, cpus/max(1, min(batchSlots, workflows)))
+}
+
+// ExpandWorkflowGlobs returns the sorted, de-duplicated files under root that
+// match any of patterns, relative to root. Patterns use filepath.Match syntax
+// plus "**/", which matches any number of directories, e.g.
+// "workflows/demonstrators/**/*.yaml".
+func ExpandWorkflowGlobs(root string, patterns []string) ([]string, error) {
+	seen := make(map[string]bool)
+	var paths []string
+	for _, pattern := range patterns {
+		pattern = strings.TrimSpace(pattern)
+		if pattern == "" {
+			continue
+		}
+		matches, err := globFiles(root, filepath.ToSlash(pattern))
+		if err != nil {
+			return nil, fmt.Errorf("expand %q: %w", pattern, err)
+		}
+		for _, match := range matches {
+			rel, err := filepath.Rel(root, match)
+			if err != nil {
+				return nil, fmt.Errorf("expand %q: %w", pattern, err)
+			}
+			rel = filepath.ToSlash(rel)
+			if !seen[rel] {
+				seen[rel] = true
+				paths = append(paths, rel)
+			}
+		}
+	}
+	sort.Strings(paths)
+	return paths, nil
+}
+
+func globFiles(root, pattern string) ([]string, error) {
+	if !path.IsAbs(pattern) {
+		pattern = path.Join(filepath.ToSlash(root), pattern)
+	}
+	base, rest, recursive := strings.Cut(pattern, "**/")
+	if !recursive {
+		return filepath.Glob(filepath.FromSlash(pattern))
+	}
+	if strings.Contains(rest, "**") {
+		return nil, fmt.Errorf("only one ** is supported")
+	}
+	tailSegments := strings.Count(rest, "/") + 1
+	var matches []string
+	err := filepath.WalkDir(filepath.FromSlash(base), func(file string, d fs.DirEntry, err error) error {
+		if err != nil || d.IsDir() {
+			return err
+		}
+		rel, err := filepath.Rel(filepath.FromSlash(base), file)
+		if err != nil {
+			return err
+		}
+		segments := strings.Split(filepath.ToSlash(rel), "/")
+		if len(segments) < tailSegments {
+			return nil
+		}
+		ok, err := path.Match(rest, strings.Join(segments[len(segments)-tailSegments:], "/"))
+		if ok {
+			matches = append(matches, file)
+		}
+		return err
+	})
+	return matches, err
+}
@@ -0,0 +1,99 @@
+package service
+
+import (
+	"context"
+	"os"
+	"path/filepath"
+	"reflect"
+	"strings"
+	"testing"
+
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/workflow"
+)
+
+func writePortfolioFile(t *testing.T, root, rel, content string) {
+	t.Helper()
+	path := filepath.Join(root, filepath.FromSlash(rel))
+	if err := os.MkdirAll(filepath.Dir(path), 0o755); err != nil {
+		t.Fatalf("create %s: %v", rel, err)
+	}
+	if err := os.WriteFile(path, []byte(content), 0o644); err != nil {
+		t.Fatalf("write %s: %v", rel, err)
+	}
+}
+
+func TestExpandWorkflowGlobs(t *testing.T) {
+	root := t.TempDir()
+	for _, rel := range []string{
+		"workflows/demonstrators/a/control/x.yaml",
+		"workflows/demonstrators/b/y.yaml",
+		"workflows/demonstrators/b/notes.md",
+		"workflows/common/kpi/z.yaml",
+	} {
+		writePortfolioFile(t, root, rel, "steps: []\n")
+	}
+
+	got, err := ExpandWorkflowGlobs(root, []string{
+		"workflows/demonstrators/**/*.yaml",
+		" workflows/common/*/z.yaml",
+		"workflows/demonstrators/b/y.yaml",
+	})
+	if err != nil {
+		t.Fatalf("ExpandWorkflowGlobs() error = %v", err)
+	}
+	want := []string{
+		"workflows/common/kpi/z.yaml",
+		"workflows/demonstrators/a/control/x.yaml",
+		"workflows/demonstrators/b/y.yaml",
+	}
+	if !reflect.DeepEqual(got, want) {
+		t.Fatalf("ExpandWorkflowGlobs() = %v, want %v", got, want)
+	}
+
+	got, err = ExpandWorkflowGlobs(root, []string{"workflows/**/control/*.yaml"})
+	if err != nil || !reflect.DeepEqual(got, want[1:2]) {
+		t.Fatalf("ExpandWorkflowGlobs(nested tail) = %v, %v; want %v", got, err, want[1:2])
+	}
+}
+
+func TestRunPortfolioRecordsFailuresPerWorkflow(t *testing.T) {
+	root := t.TempDir()
+	if err := os.Mkdir(filepath.Join(root, "fmu"), 0o755); err != nil {
+		t.Fatalf("create fmu dir: %v", err)
+	}
+	writePortfolioFile(t, root, "workflows/p/missing.yaml", "steps:\n  - name: s\n    fmu: fmu/models/Missing.fmu\n")
+	writePortfolioFile(t, root, "workflows/p/empty.yaml", "steps: []\n")
+
+	runner, err := NewRunner(root, workflow.WithStepCache())
+	if err != nil {
+		t.Fatalf("NewRunner() error = %v", err)
+	}
+	portfolio, err := runner.RunPortfolio(context.Background(), []string{"workflows/p/*.yaml"}, workflow.RunOptions{})
+	if err != nil {
+		t.Fatalf("RunPortfolio() error = %v", err)
+	}
+	if portfolio.Failed != 2 || len(portfolio.Workflows) != 2 {
+		t.Fatalf("RunPortfolio() = %+v, want both workflows failed", portfolio)
+	}
+	if msg := portfolio.Workflows["workflows/p/missing.yaml"].Error; !strings.Contains(msg, "missing FMU") {
+		t.Fatalf("missing.yaml error = %q, want missing FMU", msg)
+	}
+
+	if _, err := runner.RunPortfolio(context.Background(), []string{"workflows/none/*.yaml"}, workflow.RunOptions{}); err == nil {
+		t.Fatal("RunPortfolio() error = nil, want no match rejection")
+	}
+}
+
+func TestPortfolioSweepWorkersShareTheCPUs(t *testing.T) {
+	for _, tc := range []struct{ cpus, slots, workflows, want int }{
+		{8, 8, 20, 1},
+		{8, 8, 2, 4},
+		{8, 8, 1, 8},
+		{8, 2, 20, 4},
+		{2, 2, 3, 1},
+	} {
+		if got := portfolioSweepWorkers(tc.cpus, tc.slots, tc.workflows); got != tc.want {
+			t.Fatalf("portfolioSweepWorkers(%d, %d, %d) = %d, want %d", tc.cpus, tc.slots, tc.workflows, got, tc.want)
+		}
+	}
+}
@@ -99,6 +99,8 @@ type ArgoRemoteClient struct {
 	problems []string
 	exec     execRunner
 	now      func() time.Time
+	// results reads result artifacts; nil when S3_BUCKET is not configured.
+	results resultStore
 }
 
 func NewArgoRemoteClient(workDir string, input ArgoOptionInputs, lookup EnvLookup) *ArgoRemoteClient {
@@ -111,7 +113,7 @@ func NewArgoRemoteClient(workDir string, input ArgoOptionInputs, lookup EnvLooku
 		problems = append(problems, "argo CLI not found on PATH")
 	}
 
-	return &ArgoRemoteClient{
+	client := &ArgoRemoteClient{
 		workDir:  workDir,
 		argoCmd:  argoCmd,
 		config:   cfg,
@@ -119,6 +121,10 @@ func NewArgoRemoteClient(workDir string, input ArgoOptionInputs, lookup EnvLooku
 		exec:     defaultExecRunner,
 		now:      time.Now,
 	}
+	if store, err := newS3ResultStore(context.Background(), lookup); err == nil {
+		client.results = store
+	}
+	return client
 }
 
 func ResolveArgoConfig(input ArgoOptionInputs, lookup EnvLookup) (ArgoConfig, []string) {
@@ -274,6 +280,26 @@ func (c *ArgoRemoteClient) GetRunResults(ctx context.Context, name string) (*Run
 		return nil, fmt.Errorf("%w: workflow phase is %s", ErrRunResultsUnavailable, run.Phase)
 	}
 
+	// Runs upload their results as an artifact; runs submitted before that,
+	// or whose upload failed, only have them in their logs. An artifact that
+	// exists but cannot be read is an error rather than a reason to parse
+	// logs, which no longer hold the results.
+	if c.results != nil {
+		key := resultArtifactKey(run.Name)
+		results, err := fetchResultArtifact(ctx, c.results, key, resultChunkSize)
+		if err == nil {
+			return &RunResults{
+				RunName:       run.Name,
+				WorkflowPath:  run.WorkflowPath,
+				StepResults:   results,
+				CollectedFrom: c.results.Location(key),
+			}, nil
+		}
+		if !errors.Is(err, errResultArtifactMissing) {
+			return nil, err
+		}
+	}
+
 	output, err := c.runArgo(ctx,
 		c.withArgoConnectionArgs("logs", name, "--tail", "2000")...,
 	)
@@ -833,7 +859,7 @@ func generateRemoteWorkflowManifest(name string, namespace string, serviceAccoun
 	template.Container.Image = image
 	template.Container.ImagePullPolicy = "Always"
 	template.Container.Command = []string{"/app/bin/cads-workflow-runner"}
-	template.Container.Args = []string{"--json-output", "--workflow", workflowPath}
+	template.Container.Args = []string{"--json-output", "--workflow", workflowPath, "--result-key", resultArtifactKey(name)}
 	template.Container.Env = buildRemoteWorkflowEnvVars(defaultS3CredentialsSecret)
 	manifest.Spec.Templates = append(manifest.Spec.Templates, template)
 
@@ -248,7 +248,7 @@ func TestArgoRemoteClientSubmitWorkflowBuildsConfiguredManifest(t *testing.T) {
 			t.Fatalf("manifest = %+v, want configured namespace and service account", manifest)
 		}
 		container := manifest.Spec.Templates[0].Container
-		if container.Image != "ghcr.io/example/cads:test" || len(container.Args) != 3 || container.Args[0] != "--json-output" || container.Args[2] != "workflows/tests/python_chain.yaml" {
+		if container.Image != "ghcr.io/example/cads:test" || len(container.Args) != 5 || container.Args[0] != "--json-output" || container.Args[2] != "workflows/tests/python_chain.yaml" {
 			t.Fatalf("container = %+v, want configured image and workflow path", container)
 		}
 		envByName := make(map[string]argoEnvVar, len(container.Env))
@@ -267,6 +267,9 @@ func TestArgoRemoteClientSubmitWorkflowBuildsConfiguredManifest(t *testing.T) {
 		if envByName["S3_ENDPOINT"].ValueFrom == nil || envByName["S3_ENDPOINT"].ValueFrom.SecretKeyRef == nil || envByName["S3_ENDPOINT"].ValueFrom.SecretKeyRef.Key != "endpoint" {
 			t.Fatalf("S3_ENDPOINT env = %+v, want endpoint secret ref", envByName["S3_ENDPOINT"])
 		}
+		if container.Args[3] != "--result-key" || container.Args[4] != resultArtifactKey(manifest.Metadata.Name) {
+			t.Fatalf("container.Args = %v, want the result artifact key", container.Args)
+		}
 		if !strings.HasPrefix(manifest.Metadata.Name, "cads-python-chain-20260416170000") {
 			t.Fatalf("manifest name = %q, want timestamped workflow name", manifest.Metadata.Name)
 		}
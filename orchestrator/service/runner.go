@@ -1,18 +1,22 @@
 package service
 
 import (
+	"context"
 	"errors"
 	"fmt"
 	"os"
 	"path/filepath"
+	"runtime"
 
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
 	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/workflow"
 )
 
 // Runner executes workflows directly via the Go FMIL bindings.
 type Runner struct {
-	WorkDir string
-	exec    *workflow.Executor
+	WorkDir   string
+	exec      *workflow.Executor
+	scheduler *RunScheduler
 }
 
 func NewRunner(workDir string, opts ...workflow.Option) (*Runner, error) {
@@ -24,12 +28,23 @@ func NewRunner(workDir string, opts ...workflow.Option) (*Runner, error) {
 	if err != nil {
 		return nil, err
 	}
-	return &Runner{WorkDir: resolved, exec: exec}, nil
+	return &Runner{WorkDir: resolved, exec: exec, scheduler: NewRunScheduler(runtime.NumCPU())}, nil
 }
 
-// Run executes the workflow and returns its results.
+// Run executes the workflow as interactive work and returns its results.
 func (r *Runner) Run(workflowPath string) (map[string]map[string]any, error) {
-	return r.exec.Run(workflowPath)
+	return r.RunWithOptions(context.Background(), workflowPath, workflow.RunOptions{Priority: fmi.PriorityInteractive})
+}
+
+// RunWithOptions waits for the scheduler to admit the workflow in the
+// requested priority class, then executes it.
+func (r *Runner) RunWithOptions(ctx context.Context, workflowPath string, opts workflow.RunOptions) (map[string]map[string]any, error) {
+	release, err := r.scheduler.Acquire(ctx, opts.Priority)
+	if err != nil {
+		return nil, err
+	}
+	defer release()
+	return r.exec.RunWithOptions(workflowPath, opts)
 }
 
 // ResolveWorkDir figures out the repository root when not provided.
@@ -0,0 +1,99 @@
+package service
+
+import (
+	"context"
+	"sync"
+
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
+)
+
+// RunScheduler admits local workflow runs by priority class. Interactive runs
+// start immediately and hold the bridge's priority gate for their whole
+// duration, so in-flight batch runs park at their next communication step.
+// Batch runs share a fixed number of slots and are admitted in FIFO order only
+// while no interactive run is active.
+type RunScheduler struct {
+	mu          sync.Mutex
+	batchSlots  int
+	batchActive int
+	interactive int
+	waiting     []chan struct{}
+	// queued, when set, is called after a batch run joins the queue.
+	queued func()
+}
+
+// NewRunScheduler creates a scheduler that runs at most batchSlots batch runs at once.
+func NewRunScheduler(batchSlots int) *RunScheduler {
+	if batchSlots < 1 {
+		batchSlots = 1
+	}
+	return &RunScheduler{batchSlots: batchSlots}
+}
+
+// Acquire blocks until a run of the given class may start and returns the
+// function that must be called when it finishes.
+func (s *RunScheduler) Acquire(ctx context.Context, priority fmi.Priority) (func(), error) {
+	if priority == fmi.PriorityInteractive {
+		s.mu.Lock()
+		s.interactive++
+		s.mu.Unlock()
+		fmi.HoldPriority()
+		return s.releaseInteractive, nil
+	}
+
+	s.mu.Lock()
+	if s.interactive == 0 && len(s.waiting) == 0 && s.batchActive < s.batchSlots {
+		s.batchActive++
+		s.mu.Unlock()
+		return s.releaseBatch, nil
+	}
+	ready := make(chan struct{})
+	s.waiting = append(s.waiting, ready)
+	queued := s.queued
+	s.mu.Unlock()
+	if queued != nil {
+		queued()
+	}
+
+	select {
+	case <-ready:
+		return s.releaseBatch, nil
+	case <-ctx.Done():
+		s.mu.Lock()
+		defer s.mu.Unlock()
+		for i, waiter := range s.waiting {
+			if waiter == ready {
+				s.waiting = append(s.waiting[:i], s.waiting[i+1:]...)
+				return nil, ctx.Err()
+			}
+		}
+		// The slot was granted concurrently with cancellation; hand it on.
+		s.batchActive--
+		s.dispatchLocked()
+		return nil, ctx.Err()
+	}
+}
+
+func (s *RunScheduler) releaseInteractive() {
+	fmi.ReleasePriority()
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	s.interactive--
+	s.dispatchLocked()
+}
+
+func (s *RunScheduler) releaseBatch() {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	s.batchActive--
+	s.dispatchLocked()
+}
+
+func (s *RunScheduler) dispatchLocked() {
+	for s.interactive == 0 && len(s.waiting) > 0 && s.batchActive < s.batchSlots {
+		ready := s.waiting[0]
+		s.waiting = s.waiting[1:]
+		s.batchActive++
+		close(ready)
+	}
+}
@@ -0,0 +1,92 @@
+package service
+
+import (
+	"context"
+	"testing"
+
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
+)
+
+// newTestScheduler returns a scheduler that reports every queued batch run on
+// the returned channel, so tests can wait for a run to queue instead of sleeping.
+func newTestScheduler(batchSlots int) (*RunScheduler, <-chan struct{}) {
+	queued := make(chan struct{}, 16)
+	s := NewRunScheduler(batchSlots)
+	s.queued = func() { queued <- struct{}{} }
+	return s, queued
+}
+
+func acquireAsync(s *RunScheduler, priority fmi.Priority) <-chan func() {
+	granted := make(chan func(), 1)
+	go func() {
+		release, err := s.Acquire(context.Background(), priority)
+		if err == nil {
+			granted <- release
+		}
+	}()
+	return granted
+}
+
+// expectQueued waits until a batch run has joined the queue and checks that
+// waiting runs are queued rather than admitted.
+func expectQueued(t *testing.T, s *RunScheduler, queued <-chan struct{}, waiting int) {
+	t.Helper()
+	<-queued
+	expectWaiting(t, s, waiting)
+}
+
+func expectWaiting(t *testing.T, s *RunScheduler, waiting int) {
+	t.Helper()
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	if len(s.waiting) != waiting {
+		t.Fatalf("queued batch runs = %d, want %d", len(s.waiting), waiting)
+	}
+}
+
+func TestRunSchedulerLimitsBatchSlots(t *testing.T) {
+	s, queued := newTestScheduler(1)
+	first := <-acquireAsync(s, fmi.PriorityBatch)
+	second := acquireAsync(s, fmi.PriorityBatch)
+	expectQueued(t, s, queued, 1)
+
+	first()
+	expectWaiting(t, s, 0)
+	(<-second)()
+}
+
+func TestRunSchedulerInteractiveBypassesQueuedBatch(t *testing.T) {
+	s, queued := newTestScheduler(1)
+	batch := <-acquireAsync(s, fmi.PriorityBatch)
+	waiting := acquireAsync(s, fmi.PriorityBatch)
+	expectQueued(t, s, queued, 1)
+
+	interactive := <-acquireAsync(s, fmi.PriorityInteractive)
+	batch()
+	expectWaiting(t, s, 1)
+
+	interactive()
+	expectWaiting(t, s, 0)
+	(<-waiting)()
+}
+
+func TestRunSchedulerCancelledBatchLeavesQueue(t *testing.T) {
+	s, queued := newTestScheduler(1)
+	batch := <-acquireAsync(s, fmi.PriorityBatch)
+
+	ctx, cancel := context.WithCancel(context.Background())
+	done := make(chan error, 1)
+	go func() {
+		_, err := s.Acquire(ctx, fmi.PriorityBatch)
+		done <- err
+	}()
+	expectQueued(t, s, queued, 1)
+	cancel()
+	if err := <-done; err == nil {
+		t.Fatal("Acquire() error = nil, want cancellation")
+	}
+	expectWaiting(t, s, 0)
+
+	batch()
+	(<-acquireAsync(s, fmi.PriorityBatch))()
+}
@@ -13,6 +13,7 @@ import (
 	"strings"
 	"time"
 
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
 	workflowpkg "github.com/norceresearch/cads-fmi-demo/orchestrator/service/workflow"
 )
 
@@ -22,7 +23,9 @@ type Server struct {
 }
 
 type runRequest struct {
-	Workflow string `json:"workflow"`
+	Workflow   string   `json:"workflow"`
+	Priority   string   `json:"priority,omitempty"`
+	WallBudget *float64 `json:"wall_budget,omitempty"`
 }
 
 type runResponse struct {
@@ -183,8 +186,14 @@ func (s *Server) handleLocalRun(w http.ResponseWriter, r *http.Request) {
 		writeJSONError(w, http.StatusBadRequest, "workflow is required")
 		return
 	}
+	priority, err := fmi.ParsePriority(req.Priority)
+	if err != nil {
+		writeJSONError(w, http.StatusBadRequest, err.Error())
+		return
+	}
 
-	results, err := s.Runner.Run(req.Workflow)
+	opts := workflowpkg.RunOptions{Priority: priority, WallBudget: req.WallBudget}
+	results, err := s.Runner.RunWithOptions(r.Context(), req.Workflow, opts)
 	if err != nil {
 		log.Printf("workflow %s failed: %v", req.Workflow, err)
 		writeHandlerError(w, err)
@@ -0,0 +1,485 @@
+package workflow
+
+import (
+	"container/list"
+	"encoding/json"
+	"fmt"
+	"math"
+	"strconv"
+	"strings"
+	"sync"
+	"unicode"
+)
+
+// startExpr is a start_from expression compiled to a postfix program over
+// float64 values. References to step results are collected into refs; code
+// loads them by index, so evaluation is a single pass over a fixed-size stack.
+//
+// Expressions combine step.variable references and numbers with + - * / %
+// and ^ (power, right-associative), unary minus, parentheses and the
+// functions in exprFuncs, e.g. "hydro.power_mw * 1000" or
+// "max(a.risk_index, b.risk_index)". Boolean values count as 0 and 1.
+type startExpr struct {
+	code  []exprInstr
+	refs  []exprRef
+	depth int
+}
+
+type exprRef struct {
+	step     string
+	variable string
+}
+
+type exprOp uint8
+
+const (
+	exprConst exprOp = iota
+	exprLoad
+	exprNeg
+	exprAdd
+	exprSub
+	exprMul
+	exprDiv
+	exprMod
+	exprPow
+	exprCall
+)
+
+type exprInstr struct {
+	op    exprOp
+	value float64
+	// index is the ref of exprLoad or the argument count of exprCall.
+	index int
+	fn    *exprFunc
+}
+
+type exprFunc struct {
+	minArgs int
+	// maxArgs < 0 allows any number of arguments from minArgs on.
+	maxArgs int
+	eval    func(args []float64) float64
+}
+
+var exprFuncs = map[string]*exprFunc{
+	"abs":   {1, 1, func(a []float64) float64 { return math.Abs(a[0]) }},
+	"sqrt":  {1, 1, func(a []float64) float64 { return math.Sqrt(a[0]) }},
+	"exp":   {1, 1, func(a []float64) float64 { return math.Exp(a[0]) }},
+	"log":   {1, 1, func(a []float64) float64 { return math.Log(a[0]) }},
+	"floor": {1, 1, func(a []float64) float64 { return math.Floor(a[0]) }},
+	"ceil":  {1, 1, func(a []float64) float64 { return math.Ceil(a[0]) }},
+	"round": {1, 1, func(a []float64) float64 { return math.Round(a[0]) }},
+	"pow":   {2, 2, func(a []float64) float64 { return math.Pow(a[0], a[1]) }},
+	"min": {1, -1, func(a []float64) float64 {
+		m := a[0]
+		for _, v := range a[1:] {
+			m = math.Min(m, v)
+		}
+		return m
+	}},
+	"max": {1, -1, func(a []float64) float64 {
+		m := a[0]
+		for _, v := range a[1:] {
+			m = math.Max(m, v)
+		}
+		return m
+	}},
+	"clamp": {3, 3, func(a []float64) float64 { return math.Min(math.Max(a[0], a[1]), a[2]) }},
+}
+
+// maxStartExprs bounds startExprs; sources beyond it evict the least recently
+// used program.
+const maxStartExprs = 1024
+
+// exprCache holds compiled expressions by source, least recently used last.
+type exprCache struct {
+	mu      sync.Mutex
+	limit   int
+	order   *list.List
+	entries map[string]*list.Element
+}
+
+type exprCacheEntry struct {
+	src  string
+	expr *startExpr
+}
+
+func newExprCache(limit int) *exprCache {
+	return &exprCache{limit: limit, order: list.New(), entries: make(map[string]*list.Element)}
+}
+
+func (c *exprCache) load(src string) (*startExpr, bool) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	element, ok := c.entries[src]
+	if !ok {
+		return nil, false
+	}
+	c.order.MoveToFront(element)
+	return element.Value.(*exprCacheEntry).expr, true
+}
+
+func (c *exprCache) store(src string, expr *startExpr) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if element, ok := c.entries[src]; ok {
+		c.order.MoveToFront(element)
+		return
+	}
+	c.entries[src] = c.order.PushFront(&exprCacheEntry{src: src, expr: expr})
+	for c.order.Len() > c.limit {
+		oldest := c.order.Back()
+		c.order.Remove(oldest)
+		delete(c.entries, oldest.Value.(*exprCacheEntry).src)
+	}
+}
+
+// startExprs caches compiled expressions by source; workflows are re-run with
+// the same start_from entries.
+var startExprs = newExprCache(maxStartExprs)
+
+func compiledStartExpr(src string) (*startExpr, error) {
+	if cached, ok := startExprs.load(src); ok {
+		return cached, nil
+	}
+	expr, err := compileStartExpr(src)
+	if err != nil {
+		return nil, err
+	}
+	startExprs.store(src, expr)
+	return expr, nil
+}
+
+func compileStartExpr(src string) (*startExpr, error) {
+	p := &exprParser{src: src, expr: &startExpr{}}
+	p.next()
+	if err := p.parseSum(); err != nil {
+		return nil, err
+	}
+	if p.err == nil && p.tok.kind != tokEOF {
+		p.fail("unexpected %s", p.tok)
+	}
+	if p.err != nil {
+		return nil, p.err
+	}
+	return p.expr, nil
+}
+
+// reference returns the only reference of an expression that is nothing but
+// one step.variable.
+func (e *startExpr) reference() (exprRef, bool) {
+	if len(e.code) == 1 && e.code[0].op == exprLoad {
+		return e.refs[0], true
+	}
+	return exprRef{}, false
+}
+
+func (e *startExpr) eval(results map[string]map[string]any) (float64, error) {
+	loaded := make([]float64, len(e.refs))
+	for i, ref := range e.refs {
+		stepResult, exists := results[ref.step]
+		if !exists {
+			return 0, fmt.Errorf("references unknown step %s", ref.step)
+		}
+		value, ok := stepResult[ref.variable]
+		if !ok {
+			return 0, fmt.Errorf("missing variable %s in step %s", ref.variable, ref.step)
+		}
+		number, err := scalarFloat(value)
+		if err != nil {
+			return 0, fmt.Errorf("%s.%s: %w", ref.step, ref.variable, err)
+		}
+		loaded[i] = number
+	}
+
+	stack := make([]float64, 0, e.depth)
+	for _, in := range e.code {
+		switch in.op {
+		case exprConst:
+			stack = append(stack, in.value)
+		case exprLoad:
+			stack = append(stack, loaded[in.index])
+		case exprNeg:
+			stack[len(stack)-1] = -stack[len(stack)-1]
+		case exprCall:
+			base := len(stack) - in.index
+			result := in.fn.eval(stack[base:])
+			stack = append(stack[:base], result)
+		default:
+			b := stack[len(stack)-1]
+			stack = stack[:len(stack)-1]
+			a := &stack[len(stack)-1]
+			switch in.op {
+			case exprAdd:
+				*a += b
+			case exprSub:
+				*a -= b
+			case exprMul:
+				*a *= b
+			case exprDiv:
+				*a /= b
+			case exprMod:
+				*a = math.Mod(*a, b)
+			case exprPow:
+				*a = math.Pow(*a, b)
+			}
+		}
+	}
+	result := stack[0]
+	if math.IsNaN(result) || math.IsInf(result, 0) {
+		return 0, fmt.Errorf("evaluates to %v", result)
+	}
+	return result, nil
+}
+
+// scalarFloat converts a numeric or boolean step result value.
+func scalarFloat(value any) (float64, error) {
+	switch v := value.(type) {
+	case bool:
+		if v {
+			return 1, nil
+		}
+		return 0, nil
+	case int:
+		return float64(v), nil
+	case int64:
+		return float64(v), nil
+	case int32:
+		return float64(v), nil
+	case uint:
+		return float64(v), nil
+	case uint64:
+		return float64(v), nil
+	case float64:
+		return v, nil
+	case float32:
+		return float64(v), nil
+	case json.Number:
+		return v.Float64()
+	case nil:
+		return 0, fmt.Errorf("value is null")
+	default:
+		return 0, fmt.Errorf("unsupported value type %T in expression", value)
+	}
+}
+
+type tokenKind int
+
+const (
+	tokEOF tokenKind = iota
+	tokNumber
+	tokName
+	tokOp
+)
+
+type exprToken struct {
+	kind tokenKind
+	text string
+}
+
+func (t exprToken) String() string {
+	if t.kind == tokEOF {
+		return "end of expression"
+	}
+	return strconv.Quote(t.text)
+}
+
+type exprParser struct {
+	src   string
+	pos   int
+	tok   exprToken
+	expr  *startExpr
+	stack int
+	err   error
+}
+
+func (p *exprParser) fail(format string, args ...any) {
+	if p.err == nil {
+		p.err = fmt.Errorf("expression %q: %s", p.src, fmt.Sprintf(format, args...))
+	}
+}
+
+func (p *exprParser) next() {
+	for p.pos < len(p.src) && unicode.IsSpace(rune(p.src[p.pos])) {
+		p.pos++
+	}
+	if p.pos >= len(p.src) {
+		p.tok = exprToken{kind: tokEOF}
+		return
+	}
+	start := p.pos
+	c := p.src[p.pos]
+	switch {
+	case c >= '0' && c <= '9' || c == '.' && p.pos+1 < len(p.src) && isDigit(p.src[p.pos+1]):
+		for p.pos < len(p.src) && (isDigit(p.src[p.pos]) || p.src[p.pos] == '.') {
+			p.pos++
+		}
+		if p.pos < len(p.src) && (p.src[p.pos] == 'e' || p.src[p.pos] == 'E') {
+			p.pos++
+			if p.pos < len(p.src) && (p.src[p.pos] == '+' || p.src[p.pos] == '-') {
+				p.pos++
+			}
+			for p.pos < len(p.src) && isDigit(p.src[p.pos]) {
+				p.pos++
+			}
+		}
+		p.tok = exprToken{kind: tokNumber, text: p.src[start:p.pos]}
+	case isNameByte(c):
+		// Names run through dots so "step.variable" and "step.a.b" are one token.
+		for p.pos < len(p.src) && (isNameByte(p.src[p.pos]) || isDigit(p.src[p.pos]) || p.src[p.pos] == '.') {
+			p.pos++
+		}
+		p.tok = exprToken{kind: tokName, text: p.src[start:p.pos]}
+	default:
+		p.pos++
+		p.tok = exprToken{kind: tokOp, text: p.src[start:p.pos]}
+	}
+}
+
+func isDigit(c byte) bool {
+	return c >= '0' && c <= '9'
+}
+
+func isNameByte(c byte) bool {
+	return c == '_' || c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z'
+}
+
+func (p *exprParser) emit(in exprInstr, stackChange int) {
+	p.expr.code = append(p.expr.code, in)
+	p.stack += stackChange
+	p.expr.depth = max(p.expr.depth, p.stack)
+}
+
+func (p *exprParser) isOp(ops string) bool {
+	return p.tok.kind == tokOp && strings.Contains(ops, p.tok.text)
+}
+
+func (p *exprParser) parseSum() error {
+	if err := p.parseProduct(); err != nil {
+		return err
+	}
+	for p.isOp("+-") {
+		op := map[string]exprOp{"+": exprAdd, "-": exprSub}[p.tok.text]
+		p.next()
+		if err := p.parseProduct(); err != nil {
+			return err
+		}
+		p.emit(exprInstr{op: op}, -1)
+	}
+	return p.err
+}
+
+func (p *exprParser) parseProduct() error {
+	if err := p.parseUnary(); err != nil {
+		return err
+	}
+	for p.isOp("*/%") {
+		op := map[string]exprOp{"*": exprMul, "/": exprDiv, "%": exprMod}[p.tok.text]
+		p.next()
+		if err := p.parseUnary(); err != nil {
+			return err
+		}
+		p.emit(exprInstr{op: op}, -1)
+	}
+	return p.err
+}
+
+func (p *exprParser) parseUnary() error {
+	if p.isOp("+-") {
+		negate := p.tok.text == "-"
+		p.next()
+		if err := p.parseUnary(); err != nil {
+			return err
+		}
+		if negate {
+			p.emit(exprInstr{op: exprNeg}, 0)
+		}
+		return p.err
+	}
+	return p.parsePower()
+}
+
+func (p *exprParser) parsePower() error {
+	if err := p.parsePrimary(); err != nil {
+		return err
+	}
+	if p.isOp("^") {
+		p.next()
+		if err := p.parseUnary(); err != nil {
+			return err
+		}
+		p.emit(exprInstr{op: exprPow}, -1)
+	}
+	return p.err
+}
+
+func (p *exprParser) parsePrimary() error {
+	tok := p.tok
+	switch {
+	case tok.kind == tokNumber:
+		value, err := strconv.ParseFloat(tok.text, 64)
+		if err != nil {
+			p.fail("invalid number %s", tok)
+			return p.err
+		}
+		p.next()
+		p.emit(exprInstr{op: exprConst, value: value}, 1)
+	case tok.kind == tokName:
+		p.next()
+		if p.isOp("(") {
+			return p.parseCall(tok.text)
+		}
+		step, variable, ok := strings.Cut(tok.text, ".")
+		if !ok || step == "" || variable == "" {
+			p.fail("%s must use format step.variable", tok)
+			return p.err
+		}
+		p.expr.refs = append(p.expr.refs, exprRef{step: step, variable: variable})
+		p.emit(exprInstr{op: exprLoad, index: len(p.expr.refs) - 1}, 1)
+	case p.isOp("("):
+		p.next()
+		if err := p.parseSum(); err != nil {
+			return err
+		}
+		if !p.isOp(")") {
+			p.fail("expected \")\", got %s", p.tok)
+			return p.err
+		}
+		p.next()
+	default:
+		p.fail("unexpected %s", tok)
+	}
+	return p.err
+}
+
+func (p *exprParser) parseCall(name string) error {
+	fn, ok := exprFuncs[name]
+	if !ok {
+		p.fail("unknown function %s", name)
+		return p.err
+	}
+	p.next()
+	argc := 0
+	if !p.isOp(")") {
+		for {
+			if err := p.parseSum(); err != nil {
+				return err
+			}
+			argc++
+			if !p.isOp(",") {
+				break
+			}
+			p.next()
+		}
+	}
+	if !p.isOp(")") {
+		p.fail("expected \")\" after arguments of %s, got %s", name, p.tok)
+		return p.err
+	}
+	p.next()
+	if argc < fn.minArgs || fn.maxArgs >= 0 && argc > fn.maxArgs {
+		p.fail("%s does not take %d arguments", name, argc)
+		return p.err
+	}
+	p.emit(exprInstr{op: exprCall, index: argc, fn: fn}, 1-argc)
+	return p.err
+}
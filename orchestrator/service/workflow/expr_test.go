@@ -0,0 +1,94 @@
+package workflow
+
+import (
+	"math"
+	"strings"
+	"testing"
+)
+
+func TestStartFromExpressions(t *testing.T) {
+	results := map[string]map[string]any{
+		"hydro": {"power_mw": 1.25, "online": true},
+		"a":     {"risk_index": 0.3},
+		"b":     {"risk_index": 0.7, "count": 4},
+	}
+	for _, tc := range []struct {
+		expr string
+		want float64
+	}{
+		{"hydro.power_mw * 1000", 1250},
+		{"max(a.risk_index, b.risk_index)", 0.7},
+		{"min(a.risk_index, b.risk_index, 0.5)", 0.3},
+		{"-(b.count - 1) * 2 + 10", 4},
+		{"2 ^ 3 ^ 2", 512},
+		{"-2 ^ 2", -4},
+		{"b.count % 3 + hydro.online", 2},
+		{"clamp(hydro.power_mw, 0, 1)", 1},
+		{"round(sqrt(b.count) * 1.5e1) / .5", 60},
+	} {
+		value, err := startFromValue(tc.expr, results)
+		if err != nil {
+			t.Fatalf("startFromValue(%q) error = %v", tc.expr, err)
+		}
+		if got := value.(float64); math.Abs(got-tc.want) > 1e-12 {
+			t.Fatalf("startFromValue(%q) = %v, want %v", tc.expr, got, tc.want)
+		}
+	}
+
+	value, err := startFromValue("hydro.online", results)
+	if err != nil || value != true {
+		t.Fatalf("startFromValue(plain reference) = %v, %v; want the value copied as is", value, err)
+	}
+
+	for _, tc := range []struct {
+		expr string
+		want string
+	}{
+		{"hydro", "must use format step.variable"},
+		{"hydro.missing", "missing variable missing in step hydro"},
+		{"ghost.x * 2", "references unknown step ghost"},
+		{"hydro.power_mw *", "unexpected end of expression"},
+		{"(hydro.power_mw", `expected ")"`},
+		{"median(a.risk_index)", "unknown function median"},
+		{"pow(a.risk_index)", "pow does not take 1 arguments"},
+		{"a.risk_index / 0", "evaluates to +Inf"},
+	} {
+		_, err := startFromValue(tc.expr, results)
+		if err == nil || !strings.Contains(err.Error(), tc.want) {
+			t.Fatalf("startFromValue(%q) error = %v, want %q", tc.expr, err, tc.want)
+		}
+	}
+}
+
+func TestCompiledStartExprIsCached(t *testing.T) {
+	first, err := compiledStartExpr("a.x + 1")
+	if err != nil {
+		t.Fatalf("compiledStartExpr() error = %v", err)
+	}
+	second, err := compiledStartExpr("a.x + 1")
+	if err != nil || first != second {
+		t.Fatalf("compiledStartExpr() returned %p then %p, want the cached program", first, second)
+	}
+	if first.depth != 2 || len(first.refs) != 1 {
+		t.Fatalf("compiledStartExpr() = %+v", first)
+	}
+}
+
+func TestExprCacheEvictsLeastRecentlyUsed(t *testing.T) {
+	cache := newExprCache(2)
+	programs := map[string]*startExpr{"a": {}, "b": {}, "c": {}}
+	cache.store("a", programs["a"])
+	cache.store("b", programs["b"])
+	if got, ok := cache.load("a"); !ok || got != programs["a"] {
+		t.Fatalf("load(a) = %p, %v, want the stored program", got, ok)
+	}
+	cache.store("c", programs["c"])
+	if _, ok := cache.load("b"); ok {
+		t.Fatal("load(b) found the least recently used program, want it evicted")
+	}
+	for _, src := range []string{"a", "c"} {
+		if got, ok := cache.load(src); !ok || got != programs[src] {
+			t.Fatalf("load(%s) = %p, %v, want the stored program", src, got, ok)
+		}
+	}
+}
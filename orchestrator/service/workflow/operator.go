@@ -0,0 +1,181 @@
+package workflow
+
+import (
+	"fmt"
+	"math"
+	"strings"
+
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
+)
+
+// runOperatorStep runs an op step in the bridge. Its result has the shape of an
+// FMU result: "value" plus, for signal results, a "trace" with one signal named
+// "value", so later steps can use it as a start_from value or an op source.
+func (e *Executor) runOperatorStep(step workflowStep, results map[string]map[string]any) (map[string]any, error) {
+	cfg, cleanup, err := e.buildOperatorConfig(step, results)
+	if err != nil {
+		return nil, err
+	}
+	if cleanup != nil {
+		defer cleanup()
+	}
+	return fmi.RunOperator(*cfg)
+}
+
+// operatorParams lists the parameters each operator needs. factor and offset
+// default to 1 and 0.
+var operatorParams = map[fmi.Operator][]string{
+	fmi.OperatorThreshold:       {"level"},
+	fmi.OperatorRollingMean:     {"window"},
+	fmi.OperatorRollingQuantile: {"window", "quantile"},
+	fmi.OperatorResample:        {"interval"},
+	fmi.OperatorQuantile:        {"quantile"},
+}
+
+func (e *Executor) buildOperatorConfig(step workflowStep, results map[string]map[string]any) (*fmi.OperatorConfig, func(), error) {
+	op, err := fmi.ParseOperator(step.Op)
+	if err != nil {
+		return nil, nil, err
+	}
+	if field := fmuOnlyField(step); field != "" {
+		return nil, nil, fmt.Errorf("op steps cannot set %s", field)
+	}
+
+	params := map[string]*float64{
+		"level":    step.Level,
+		"window":   step.Window,
+		"interval": step.Interval,
+		"quantile": step.Quantile,
+	}
+	for _, name := range operatorParams[op] {
+		if params[name] == nil {
+			return nil, nil, fmt.Errorf("op %s requires %s", step.Op, name)
+		}
+	}
+	cfg := &fmi.OperatorConfig{Op: op, Factor: 1}
+	for _, param := range []struct {
+		value  *float64
+		target *float64
+	}{
+		{step.Window, &cfg.Window},
+		{step.Interval, &cfg.Interval},
+		{step.Quantile, &cfg.Quantile},
+		{step.Factor, &cfg.Factor},
+		{step.Offset, &cfg.Offset},
+		{step.Level, &cfg.Level},
+	} {
+		if param.value != nil {
+			*param.target = *param.value
+		}
+	}
+
+	switch {
+	case step.Source != "" && step.InputSeries != nil:
+		return nil, nil, fmt.Errorf("op steps take either source or input_series")
+	case step.Source != "":
+		if step.StartTime != nil || step.StopTime != nil {
+			return nil, nil, fmt.Errorf("op steps take start_time and stop_time only with input_series")
+		}
+		cfg.Times, cfg.Values, err = traceSignal(step.Source, results)
+		if err != nil {
+			return nil, nil, err
+		}
+		return cfg, nil, nil
+	case step.InputSeries != nil:
+		if (step.StartTime == nil) != (step.StopTime == nil) {
+			return nil, nil, fmt.Errorf("op steps take both start_time and stop_time or neither")
+		}
+		resolved, err := e.resolveInputSeries(*step.InputSeries)
+		if err != nil {
+			return nil, nil, fmt.Errorf("input series invalid: %w", err)
+		}
+		cfg.InputSeries = &resolved.Configs[0]
+		cfg.StartTime, cfg.StopTime = step.StartTime, step.StopTime
+		return cfg, resolved.Cleanup, nil
+	default:
+		return nil, nil, fmt.Errorf("op steps require source or input_series")
+	}
+}
+
+// fmuOnlyField names the first field set on an op step that only FMU steps
+// use, or returns "".
+func fmuOnlyField(step workflowStep) string {
+	for _, field := range []struct {
+		name string
+		set  bool
+	}{
+		{"fmu", step.FMU != ""},
+		{"outputs", len(step.Outputs) > 0},
+		{"outputs_at", len(step.OutputsAt) > 0},
+		{"step_size", step.StepSize != nil},
+		{"wall_budget", step.WallBudget != nil},
+		{"start_values", len(step.StartValues) > 0},
+		{"start_from", len(step.StartFrom) > 0},
+		{"inputs", len(step.Inputs) > 0},
+		{"live", step.Live != nil},
+		{"trace", step.Trace != nil},
+		{"coalesce_steps", step.CoalesceSteps},
+		{"max_step", step.MaxStep != nil},
+		{"sweep_mode", step.SweepMode != ""},
+		{"sweep_interleave", step.SweepInterleave != 0},
+	} {
+		if field.set {
+			return field.name
+		}
+	}
+	return ""
+}
+
+// traceSignal returns the times and values of a "step.signal" reference to the
+// trace of an earlier step.
+func traceSignal(reference string, results map[string]map[string]any) ([]float64, []float64, error) {
+	stepName, signal, ok := strings.Cut(reference, ".")
+	if !ok || stepName == "" || signal == "" {
+		return nil, nil, fmt.Errorf("source must use format step.signal")
+	}
+	stepResult, exists := results[stepName]
+	if !exists {
+		return nil, nil, fmt.Errorf("source references unknown step %s", stepName)
+	}
+	trace, _ := stepResult["trace"].(map[string]any)
+	signals, _ := trace["signals"].(map[string]any)
+	rawValues, ok := signals[signal].([]any)
+	if !ok {
+		return nil, nil, fmt.Errorf("source step %s has no traced signal %s", stepName, signal)
+	}
+	rawTimes, _ := trace["time"].([]any)
+	if len(rawTimes) != len(rawValues) {
+		return nil, nil, fmt.Errorf("source %s has %d times but %d values", reference, len(rawTimes), len(rawValues))
+	}
+	times := make([]float64, len(rawTimes))
+	values := make([]float64, len(rawValues))
+	for i := range rawTimes {
+		t, okTime := rawTimes[i].(float64)
+		v, okValue := traceNumber(rawValues[i])
+		if !okTime || !okValue {
+			return nil, nil, fmt.Errorf("source %s sample %d is not numeric", reference, i)
+		}
+		times[i] = t
+		values[i] = v
+	}
+	return times, values, nil
+}
+
+// traceNumber accepts numeric and boolean trace samples. Null samples, which
+// traces carry for NaN (e.g. a rolling_mean window without values), become NaN
+// again for the operator to handle.
+func traceNumber(value any) (float64, bool) {
+	switch v := value.(type) {
+	case nil:
+		return math.NaN(), true
+	case float64:
+		return v, true
+	case bool:
+		if v {
+			return 1, true
+		}
+		return 0, true
+	default:
+		return 0, false
+	}
+}
@@ -68,7 +68,7 @@ func (e *Executor) buildS3InputSeries(spec s3InputSeriesSpec) (*resolvedInputSer
 	}
 
 	return &resolvedInputSeries{
-		Config: &fmi.InputSeriesConfig{CSVPath: tempPath},
+		Configs: []fmi.InputSeriesConfig{{CSVPath: tempPath}},
 		Cleanup: func() {
 			_ = os.Remove(tempPath)
 		},
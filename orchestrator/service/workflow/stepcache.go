@@ -0,0 +1,85 @@
+package workflow
+
+import (
+	"encoding/json"
+	"sync"
+	"sync/atomic"
+
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
+)
+
+// stepCache memoizes FMU step results by configuration for the executor's
+// lifetime. Concurrent workflows that reach an identical step wait for the
+// first run instead of repeating it. Failures are handed to the steps that
+// waited for them but not kept, so a later step runs again. Input files are
+// keyed by path, so a cache must not outlive one pass over unchanged inputs.
+type stepCache struct {
+	mu      sync.Mutex
+	entries map[string]*stepCacheEntry
+	hits    atomic.Int64
+}
+
+type stepCacheEntry struct {
+	done   chan struct{}
+	result map[string]any
+	err    error
+}
+
+// WithStepCache makes the executor run each distinct FMU step configuration
+// once and hand the same result to every step that repeats it. Results are
+// shared and must be treated as read-only.
+func WithStepCache() Option {
+	return func(e *Executor) {
+		e.steps = &stepCache{entries: make(map[string]*stepCacheEntry)}
+	}
+}
+
+// StepCacheHits reports how many steps were answered from the step cache.
+func (e *Executor) StepCacheHits() int64 {
+	if e.steps == nil {
+		return 0
+	}
+	return e.steps.hits.Load()
+}
+
+// runStep runs cfg through the step cache when one is installed. Live steps
+// depend on their stream and always run.
+func (e *Executor) runStep(cfg fmi.Config) (map[string]any, error) {
+	if e.steps == nil || cfg.Live != nil {
+		return e.runFMU(cfg)
+	}
+	key, err := stepCacheKey(cfg)
+	if err != nil {
+		return e.runFMU(cfg)
+	}
+
+	e.steps.mu.Lock()
+	entry, cached := e.steps.entries[key]
+	if !cached {
+		entry = &stepCacheEntry{done: make(chan struct{})}
+		e.steps.entries[key] = entry
+	}
+	e.steps.mu.Unlock()
+
+	if cached {
+		<-entry.done
+		e.steps.hits.Add(1)
+		return entry.result, entry.err
+	}
+	entry.result, entry.err = e.runFMU(cfg)
+	if entry.err != nil {
+		e.steps.mu.Lock()
+		delete(e.steps.entries, key)
+		e.steps.mu.Unlock()
+	}
+	close(entry.done)
+	return entry.result, entry.err
+}
+
+// stepCacheKey encodes everything in cfg that affects the result; Priority
+// only decides when the run may advance.
+func stepCacheKey(cfg fmi.Config) (string, error) {
+	cfg.Priority = fmi.PriorityInteractive
+	data, err := json.Marshal(cfg)
+	return string(data), err
+}
@@ -0,0 +1,68 @@
+package workflow
+
+import (
+	"errors"
+	"reflect"
+	"testing"
+
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
+)
+
+func TestStepCacheRunsIdenticalConfigsOnce(t *testing.T) {
+	exec, err := NewExecutor(t.TempDir(), WithStepCache())
+	if err != nil {
+		t.Fatalf("NewExecutor() error = %v", err)
+	}
+	runs := 0
+	exec.runFMU = func(cfg fmi.Config) (map[string]any, error) {
+		runs++
+		if cfg.StartValues["k"].Integer == 3 {
+			return nil, errors.New("solver diverged")
+		}
+		return map[string]any{"k": cfg.StartValues["k"].Integer}, nil
+	}
+
+	cfg := fmi.Config{FMUPath: "fmu/models/Demo.fmu", StartValues: map[string]fmi.StartValue{"k": fmi.IntegerValue(1)}}
+	first, _ := exec.runStep(cfg)
+	cfg.Priority = fmi.PriorityBatch
+	second, _ := exec.runStep(cfg)
+	if runs != 1 || exec.StepCacheHits() != 1 || !reflect.DeepEqual(first, second) {
+		t.Fatalf("runs = %d, hits = %d; want the second step answered from the cache", runs, exec.StepCacheHits())
+	}
+
+	cfg.StartValues = map[string]fmi.StartValue{"k": fmi.IntegerValue(2)}
+	exec.runStep(cfg)
+	cfg.Live = &fmi.LiveConfig{}
+	exec.runStep(cfg)
+	exec.runStep(cfg)
+	if runs != 4 || exec.StepCacheHits() != 1 {
+		t.Fatalf("runs = %d, hits = %d; want different and live configs to run", runs, exec.StepCacheHits())
+	}
+}
+
+func TestStepCacheRetriesFailedSteps(t *testing.T) {
+	exec, err := NewExecutor(t.TempDir(), WithStepCache())
+	if err != nil {
+		t.Fatalf("NewExecutor() error = %v", err)
+	}
+	runs := 0
+	exec.runFMU = func(fmi.Config) (map[string]any, error) {
+		runs++
+		if runs == 1 {
+			return nil, errors.New("license server unreachable")
+		}
+		return map[string]any{"ok": true}, nil
+	}
+
+	cfg := fmi.Config{FMUPath: "fmu/models/Demo.fmu"}
+	if _, err := exec.runStep(cfg); err == nil {
+		t.Fatal("first runStep() error = nil, want the failure")
+	}
+	result, err := exec.runStep(cfg)
+	if err != nil || runs != 2 || result["ok"] != true {
+		t.Fatalf("second runStep() = %v, %v after %d runs; want the step run again", result, err, runs)
+	}
+	if _, err := exec.runStep(cfg); err != nil || runs != 2 || exec.StepCacheHits() != 1 {
+		t.Fatalf("third runStep() error = %v after %d runs, %d hits; want the success cached", err, runs, exec.StepCacheHits())
+	}
+}
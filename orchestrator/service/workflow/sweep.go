@@ -0,0 +1,341 @@
+package workflow
+
+import (
+	"fmt"
+	"math"
+	"sort"
+	"strings"
+
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
+)
+
+// sweepPlan lists the members of a swept step. A step sweeps when start_values
+// entries are {sweep: [...]} or {range: [first, last(, step)]}, combined as a
+// cartesian product (the default) or zipped. It also fans out when its
+// start_from reads a swept step: it then runs once per upstream member, times
+// its own combinations, with start_from resolved against that member.
+type sweepPlan struct {
+	// parameters names the coordinates: the upstream step's first, then the
+	// step's own swept start values in name order.
+	parameters []string
+	members    []sweepMember
+}
+
+type sweepMember struct {
+	coordinates []any
+	// values holds the member's own swept start values.
+	values map[string]fmi.StartValue
+	// upstream is the member index of the swept steps read by start_from, or
+	// -1 when the step does not fan out.
+	upstream int
+}
+
+// sweepTable is the result of a swept step: one row per member, keyed by its
+// coordinates, with the outputs stored column-wise.
+type sweepTable struct {
+	Parameters  []string         `json:"parameters"`
+	Coordinates [][]any          `json:"coordinates"`
+	Outputs     map[string][]any `json:"outputs"`
+}
+
+func isSweepValue(value any) bool {
+	_, ok := value.(map[string]any)
+	return ok
+}
+
+// buildSweep returns nil when the step neither sweeps nor fans out. Plans of
+// more than limit members are rejected before they are expanded.
+func buildSweep(step workflowStep, results map[string]map[string]any, limit int) (*sweepPlan, error) {
+	names := make([]string, 0)
+	for name, value := range step.StartValues {
+		if isSweepValue(value) {
+			names = append(names, name)
+		}
+	}
+	sort.Strings(names)
+	axes := make([][]any, len(names))
+	for i, name := range names {
+		values, err := sweepAxis(step.StartValues[name].(map[string]any), limit)
+		if err != nil {
+			return nil, fmt.Errorf("start_values[%s]: %w", name, err)
+		}
+		axes[i] = values
+	}
+	upstream, err := sweptSources(step, results)
+	if err != nil {
+		return nil, err
+	}
+	if len(axes) == 0 && upstream == nil {
+		return nil, nil
+	}
+	if step.Live != nil {
+		return nil, fmt.Errorf("live steps cannot be swept")
+	}
+	if step.SweepInterleave < 0 {
+		return nil, fmt.Errorf("sweep_interleave must not be negative")
+	}
+
+	upstreamMembers := 1
+	if upstream != nil {
+		upstreamMembers = len(upstream.Coordinates)
+	}
+	tooMany := fmt.Errorf("sweep has more than %d members", limit)
+
+	var combos [][]any
+	switch strings.ToLower(strings.TrimSpace(step.SweepMode)) {
+	case "", "cartesian":
+		members := upstreamMembers
+		for _, axis := range axes {
+			if members > limit/len(axis) {
+				return nil, tooMany
+			}
+			members *= len(axis)
+		}
+		combos = [][]any{{}}
+		for _, axis := range axes {
+			next := make([][]any, 0, len(combos)*len(axis))
+			for _, combo := range combos {
+				for _, value := range axis {
+					next = append(next, append(append([]any(nil), combo...), value))
+				}
+			}
+			combos = next
+		}
+	case "zip":
+		for i, axis := range axes {
+			if len(axis) != len(axes[0]) {
+				return nil, fmt.Errorf("sweep_mode zip needs equal lengths, %s has %d values and %s %d",
+					names[0], len(axes[0]), names[i], len(axis))
+			}
+		}
+		length := 1
+		if len(axes) > 0 {
+			length = len(axes[0])
+		}
+		if upstreamMembers > limit/length {
+			return nil, tooMany
+		}
+		for row := 0; row < length; row++ {
+			combo := make([]any, len(axes))
+			for i, axis := range axes {
+				combo[i] = axis[row]
+			}
+			combos = append(combos, combo)
+		}
+	default:
+		return nil, fmt.Errorf("unknown sweep_mode %q (want cartesian or zip)", step.SweepMode)
+	}
+
+	plan := &sweepPlan{}
+	if upstream != nil {
+		plan.parameters = append(plan.parameters, upstream.Parameters...)
+	}
+	plan.parameters = append(plan.parameters, names...)
+	for u := 0; u < upstreamMembers; u++ {
+		for _, combo := range combos {
+			member := sweepMember{upstream: -1, values: make(map[string]fmi.StartValue, len(names))}
+			if upstream != nil {
+				member.upstream = u
+				member.coordinates = append(member.coordinates, upstream.Coordinates[u]...)
+			}
+			member.coordinates = append(member.coordinates, combo...)
+			for i, name := range names {
+				value, err := startValueOf(combo[i])
+				if err != nil {
+					return nil, fmt.Errorf("start_values[%s]: %w", name, err)
+				}
+				member.values[name] = value
+			}
+			plan.members = append(plan.members, member)
+		}
+	}
+	return plan, nil
+}
+
+// sweepAxis expands {sweep: [...]} or {range: [first, last(, step)]}. Ranges
+// include both ends and yield integers when all bounds are integers. Axes of
+// more than limit values are rejected.
+func sweepAxis(spec map[string]any, limit int) ([]any, error) {
+	if len(spec) != 1 {
+		return nil, fmt.Errorf("want exactly one of sweep or range")
+	}
+	if values, ok := spec["sweep"]; ok {
+		list, ok := values.([]any)
+		if !ok || len(list) == 0 {
+			return nil, fmt.Errorf("sweep must be a non-empty list")
+		}
+		if len(list) > limit {
+			return nil, fmt.Errorf("sweep has more than %d values", limit)
+		}
+		return list, nil
+	}
+	bounds, ok := spec["range"].([]any)
+	if !ok || len(bounds) < 2 || len(bounds) > 3 {
+		return nil, fmt.Errorf("range must be [first, last] or [first, last, step]")
+	}
+	numbers := []float64{0, 0, 1}
+	integral := true
+	for i, bound := range bounds {
+		number, err := scalarFloat(bound)
+		if _, isBool := bound.(bool); err != nil || isBool || math.IsNaN(number) || math.IsInf(number, 0) {
+			return nil, fmt.Errorf("range bounds must be numbers")
+		}
+		numbers[i] = number
+		integral = integral && number == math.Trunc(number)
+	}
+	first, last, stride := numbers[0], numbers[1], numbers[2]
+	if stride <= 0 || last < first {
+		return nil, fmt.Errorf("range needs first <= last and a positive step")
+	}
+	// Checked as a float first: a huge span over a tiny step overflows int.
+	span := math.Floor((last-first)/stride + 1e-9)
+	if !(span < float64(limit)) {
+		return nil, fmt.Errorf("range has more than %d values", limit)
+	}
+	count := int(span) + 1
+	values := make([]any, count)
+	for i := range values {
+		value := first + float64(i)*stride
+		if integral {
+			values[i] = int(value)
+		} else {
+			values[i] = value
+		}
+	}
+	return values, nil
+}
+
+// sweptSources returns the table of the swept steps the step's start_from
+// reads. All of them must have the same number of members; members are
+// matched by index and the first table (by step name) supplies coordinates.
+func sweptSources(step workflowStep, results map[string]map[string]any) (*sweepTable, error) {
+	steps := make(map[string]bool)
+	for _, reference := range step.StartFrom {
+		for _, name := range startFromSteps(reference) {
+			if _, swept := results[name]["sweep"].(*sweepTable); swept {
+				steps[name] = true
+			}
+		}
+	}
+	if len(steps) == 0 {
+		return nil, nil
+	}
+	names := make([]string, 0, len(steps))
+	for name := range steps {
+		names = append(names, name)
+	}
+	sort.Strings(names)
+	first := results[names[0]]["sweep"].(*sweepTable)
+	for _, name := range names[1:] {
+		table := results[name]["sweep"].(*sweepTable)
+		if len(table.Coordinates) != len(first.Coordinates) {
+			return nil, fmt.Errorf("start_from reads swept steps %s and %s with %d and %d members",
+				names[0], name, len(first.Coordinates), len(table.Coordinates))
+		}
+	}
+	return first, nil
+}
+
+// startFromSteps names the steps a start_from entry reads.
+func startFromSteps(reference string) []string {
+	if expr, err := compiledStartExpr(reference); err == nil {
+		names := make([]string, 0, len(expr.refs))
+		for _, ref := range expr.refs {
+			names = append(names, ref.step)
+		}
+		return names
+	}
+	if stepName, _, ok := strings.Cut(reference, "."); ok {
+		return []string{stepName}
+	}
+	return nil
+}
+
+// memberResults returns results with every swept step replaced by member's
+// row: its outputs plus its coordinates, so start_from can read either.
+func memberResults(results map[string]map[string]any, member int) map[string]map[string]any {
+	view := make(map[string]map[string]any, len(results))
+	for name, result := range results {
+		table, swept := result["sweep"].(*sweepTable)
+		if !swept {
+			view[name] = result
+			continue
+		}
+		row := make(map[string]any, len(table.Parameters)+len(table.Outputs))
+		for i, parameter := range table.Parameters {
+			row[parameter] = table.Coordinates[member][i]
+		}
+		for output, column := range table.Outputs {
+			row[output] = column[member]
+		}
+		view[name] = row
+	}
+	return view
+}
+
+// runSweep runs every member of plan on workers threads of the bridge's batch
+// pool (0 for one per core), starting from base, and collects their outputs
+// into a sweepTable.
+func (e *Executor) runSweep(step workflowStep, base fmi.Config, plan *sweepPlan, results map[string]map[string]any, workers int) (map[string]any, error) {
+	cfgs := make([]fmi.Config, len(plan.members))
+	for i, member := range plan.members {
+		view := results
+		if member.upstream >= 0 {
+			view = memberResults(results, member.upstream)
+		}
+		startVals, err := e.buildStartValues(step, view)
+		if err != nil {
+			return nil, fmt.Errorf("member %v start values invalid: %w", member.coordinates, err)
+		}
+		for name, value := range member.values {
+			startVals[name] = value
+		}
+		cfgs[i] = base
+		cfgs[i].StartValues = startVals
+	}
+	e.logf("[workflow] Step %s sweeps %d members over %v", step.Name, len(cfgs), plan.parameters)
+
+	batch := e.runBatch(cfgs, fmi.BatchOptions{Workers: workers, Interleave: step.SweepInterleave})
+	members := make([]map[string]any, len(batch))
+	for i, outcome := range batch {
+		if outcome.Err != nil {
+			return nil, fmt.Errorf("member %v: %w", plan.members[i].coordinates, outcome.Err)
+		}
+		members[i] = outcome.Result
+	}
+	return map[string]any{"sweep": collectSweep(plan, members, step.Outputs)}, nil
+}
+
+// collectSweep stores the scalar outputs of every member column-wise. Without
+// an outputs list, every scalar any member reported becomes a column.
+func collectSweep(plan *sweepPlan, members []map[string]any, outputs []string) *sweepTable {
+	table := &sweepTable{
+		Parameters:  plan.parameters,
+		Coordinates: make([][]any, len(plan.members)),
+		Outputs:     make(map[string][]any),
+	}
+	for i, member := range plan.members {
+		table.Coordinates[i] = member.coordinates
+	}
+	names := outputs
+	if len(names) == 0 {
+		seen := make(map[string]bool)
+		for _, result := range members {
+			for name, value := range result {
+				if _, err := scalarFloat(value); err == nil && !seen[name] {
+					seen[name] = true
+					names = append(names, name)
+				}
+			}
+		}
+		sort.Strings(names)
+	}
+	for _, name := range names {
+		column := make([]any, len(members))
+		for i, result := range members {
+			column[i] = result[name]
+		}
+		table.Outputs[name] = column
+	}
+	return table
+}
@@ -0,0 +1,178 @@
+package workflow
+
+import (
+	"reflect"
+	"strings"
+	"testing"
+
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
+)
+
+func TestBuildSweepExpandsStartValues(t *testing.T) {
+	step := workflowStep{
+		Name: "grid",
+		StartValues: map[string]any{
+			"scenario_id": map[string]any{"sweep": []any{1, 2}},
+			"gain":        map[string]any{"range": []any{0.5, 1.5, 0.5}},
+			"fixed":       3,
+		},
+	}
+	plan, err := buildSweep(step, nil, DefaultMaxSweepMembers)
+	if err != nil {
+		t.Fatalf("buildSweep() error = %v", err)
+	}
+	if want := []string{"gain", "scenario_id"}; !reflect.DeepEqual(plan.parameters, want) {
+		t.Fatalf("parameters = %v, want %v", plan.parameters, want)
+	}
+	if len(plan.members) != 6 {
+		t.Fatalf("len(members) = %d, want 6", len(plan.members))
+	}
+	if got := plan.members[1]; !reflect.DeepEqual(got.coordinates, []any{0.5, 2}) || got.values["scenario_id"] != fmi.IntegerValue(2) || got.upstream != -1 {
+		t.Fatalf("members[1] = %+v, want gain 0.5 and scenario_id 2", got)
+	}
+
+	step.SweepMode = "zip"
+	if _, err := buildSweep(step, nil, DefaultMaxSweepMembers); err == nil || !strings.Contains(err.Error(), "equal lengths") {
+		t.Fatalf("buildSweep(zip) error = %v, want equal lengths rejection", err)
+	}
+	step.StartValues["scenario_id"] = map[string]any{"range": []any{1, 3}}
+	plan, err = buildSweep(step, nil, DefaultMaxSweepMembers)
+	if err != nil {
+		t.Fatalf("buildSweep(zip) error = %v", err)
+	}
+	if got := plan.members[2].coordinates; !reflect.DeepEqual(got, []any{1.5, 3}) {
+		t.Fatalf("zip members[2] = %v, want [1.5 3]", got)
+	}
+
+	if plan, err := buildSweep(workflowStep{StartValues: map[string]any{"a": 1}}, nil, DefaultMaxSweepMembers); plan != nil || err != nil {
+		t.Fatalf("buildSweep(plain) = %v, %v; want no sweep", plan, err)
+	}
+	for _, spec := range []map[string]any{
+		{"sweep": []any{}},
+		{"range": []any{3, 1}},
+		{"range": []any{0, 1, 0}},
+		{"sweep": []any{1}, "range": []any{1, 2}},
+	} {
+		if _, err := buildSweep(workflowStep{StartValues: map[string]any{"a": spec}}, nil, DefaultMaxSweepMembers); err == nil {
+			t.Fatalf("buildSweep(%v) error = nil", spec)
+		}
+	}
+}
+
+func TestBuildSweepRejectsPlansOverTheMemberLimit(t *testing.T) {
+	for _, tc := range []struct {
+		step workflowStep
+		want string
+	}{
+		{workflowStep{StartValues: map[string]any{"a": map[string]any{"range": []any{0, 1e300, 1e-300}}}}, "range has more than 100 values"},
+		{workflowStep{StartValues: map[string]any{"a": map[string]any{"range": []any{0, 100}}}}, "range has more than 100 values"},
+		{workflowStep{StartValues: map[string]any{"a": map[string]any{"sweep": make([]any, 101)}}}, "sweep has more than 100 values"},
+		{workflowStep{StartValues: map[string]any{
+			"a": map[string]any{"range": []any{1, 10}},
+			"b": map[string]any{"range": []any{1, 11}},
+		}}, "sweep has more than 100 members"},
+	} {
+		if _, err := buildSweep(tc.step, nil, 100); err == nil || !strings.Contains(err.Error(), tc.want) {
+			t.Fatalf("buildSweep(%v) error = %v, want %q", tc.step.StartValues, err, tc.want)
+		}
+	}
+
+	step := workflowStep{StartValues: map[string]any{
+		"a": map[string]any{"range": []any{1, 10}},
+		"b": map[string]any{"range": []any{0, 0.9, 0.1}},
+	}}
+	if plan, err := buildSweep(step, nil, 100); err != nil || len(plan.members) != 100 {
+		t.Fatalf("buildSweep(10 x 10) = %v, %v; want 100 members", plan, err)
+	}
+}
+
+func TestBuildSweepFansOutOverSweptStartFrom(t *testing.T) {
+	upstream := &sweepPlan{
+		parameters: []string{"scenario_id"},
+		members:    []sweepMember{{coordinates: []any{1}}, {coordinates: []any{2}}},
+	}
+	results := map[string]map[string]any{
+		"grid": {"sweep": collectSweep(upstream, []map[string]any{
+			{"power_mw": 1.5, "label": "a"},
+			{"power_mw": 2.5, "label": "b"},
+		}, nil)},
+	}
+	table := results["grid"]["sweep"].(*sweepTable)
+	if want := map[string][]any{"power_mw": {1.5, 2.5}}; !reflect.DeepEqual(table.Outputs, want) {
+		t.Fatalf("collectSweep() outputs = %v, want %v", table.Outputs, want)
+	}
+
+	step := workflowStep{
+		Name:        "risk",
+		StartValues: map[string]any{"profile_id": map[string]any{"sweep": []any{7, 8, 9}}},
+		StartFrom:   map[string]string{"power_kw": "grid.power_mw * 1000"},
+	}
+	plan, err := buildSweep(step, results, DefaultMaxSweepMembers)
+	if err != nil {
+		t.Fatalf("buildSweep() error = %v", err)
+	}
+	if want := []string{"scenario_id", "profile_id"}; !reflect.DeepEqual(plan.parameters, want) {
+		t.Fatalf("parameters = %v, want %v", plan.parameters, want)
+	}
+	if len(plan.members) != 6 {
+		t.Fatalf("len(members) = %d, want 6", len(plan.members))
+	}
+	member := plan.members[4]
+	if !reflect.DeepEqual(member.coordinates, []any{2, 8}) || member.upstream != 1 {
+		t.Fatalf("members[4] = %+v, want scenario_id 2, profile_id 8", member)
+	}
+
+	view := memberResults(results, member.upstream)
+	values, err := (&Executor{}).buildStartValues(step, view)
+	if err != nil {
+		t.Fatalf("buildStartValues(member view) error = %v", err)
+	}
+	if want := map[string]fmi.StartValue{"power_kw": fmi.RealValue(2500)}; !reflect.DeepEqual(values, want) {
+		t.Fatalf("buildStartValues(member view) = %v, want %v", values, want)
+	}
+	if view["grid"]["scenario_id"] != 2 {
+		t.Fatalf("member view = %v, want the coordinates readable", view["grid"])
+	}
+}
+
+func TestRunSweepInterleavesMembersOnTheBatchPool(t *testing.T) {
+	exec, err := NewExecutor(t.TempDir())
+	if err != nil {
+		t.Fatalf("NewExecutor() error = %v", err)
+	}
+	var opts fmi.BatchOptions
+	exec.runBatch = func(cfgs []fmi.Config, o fmi.BatchOptions) []fmi.BatchResult {
+		opts = o
+		results := make([]fmi.BatchResult, len(cfgs))
+		for i, cfg := range cfgs {
+			results[i].Result = map[string]any{"score": float64(cfg.StartValues["seed"].Integer) / 2}
+		}
+		return results
+	}
+
+	step := workflowStep{
+		Name:            "replicas",
+		StartValues:     map[string]any{"seed": map[string]any{"range": []any{1, 12}}},
+		SweepInterleave: 4,
+	}
+	plan, err := buildSweep(step, nil, DefaultMaxSweepMembers)
+	if err != nil {
+		t.Fatalf("buildSweep() error = %v", err)
+	}
+	result, err := exec.runSweep(step, fmi.Config{FMUPath: "fmu/models/Replica.fmu"}, plan, nil, 3)
+	if err != nil {
+		t.Fatalf("runSweep() error = %v", err)
+	}
+	if opts.Interleave != 4 || opts.Workers != 3 {
+		t.Fatalf("BatchOptions = %+v, want Interleave 4 on 3 workers", opts)
+	}
+	table := result["sweep"].(*sweepTable)
+	if len(table.Coordinates) != 12 || table.Outputs["score"][11] != 6.0 {
+		t.Fatalf("sweep table = %+v, want 12 members in order", table)
+	}
+
+	step.SweepInterleave = -1
+	if _, err := buildSweep(step, nil, DefaultMaxSweepMembers); err == nil {
+		t.Fatal("buildSweep(sweep_interleave -1) error = nil")
+	}
+}
@@ -4,6 +4,7 @@ import (
 	"encoding/json"
 	"errors"
 	"fmt"
+	"math"
 	"os"
 	"path/filepath"
 	"sort"
@@ -23,6 +24,13 @@ type Executor struct {
 	root         string
 	logger       func(string, ...any)
 	s3Downloader s3DownloadFunc
+	steps        *stepCache
+	// runFMU runs a single step and runBatch the members of a sweep;
+	// fmi.Run and fmi.RunBatch unless a test replaces them.
+	runFMU   func(fmi.Config) (map[string]any, error)
+	runBatch func([]fmi.Config, fmi.BatchOptions) []fmi.BatchResult
+	// maxSweepMembers caps the members of one swept step.
+	maxSweepMembers int
 }
 
 // Option configures the executor.
@@ -42,6 +50,18 @@ func WithS3Downloader(downloader s3DownloadFunc) Option {
 	}
 }
 
+// DefaultMaxSweepMembers is the member limit of a swept step unless
+// WithMaxSweepMembers sets another.
+const DefaultMaxSweepMembers = 10000
+
+// WithMaxSweepMembers rejects swept steps with more than limit members. A
+// limit of zero or less keeps DefaultMaxSweepMembers.
+func WithMaxSweepMembers(limit int) Option {
+	return func(e *Executor) {
+		e.maxSweepMembers = limit
+	}
+}
+
 // NewExecutor creates a workflow executor rooted at repoRoot.
 func NewExecutor(repoRoot string, opts ...Option) (*Executor, error) {
 	if repoRoot == "" {
@@ -58,11 +78,38 @@ func NewExecutor(repoRoot string, opts ...Option) (*Executor, error) {
 	if e.s3Downloader == nil {
 		e.s3Downloader = defaultS3Downloader
 	}
+	if e.maxSweepMembers <= 0 {
+		e.maxSweepMembers = DefaultMaxSweepMembers
+	}
+	e.runFMU = fmi.Run
+	e.runBatch = fmi.RunBatch
 	return e, nil
 }
 
+// RunOptions tune how a workflow's FMU steps are executed.
+type RunOptions struct {
+	// Priority is the scheduling class of every step; batch steps pause at
+	// communication-step boundaries while interactive work is active.
+	Priority fmi.Priority
+	// WallBudget is the default wall-clock budget in seconds for steps that do
+	// not set wall_budget themselves. Steps that run out return partial results.
+	WallBudget *float64
+	// SweepWorkers is the number of bridge threads a sweep runs on; 0 selects
+	// one per core. Callers running several workflows at once lower it so
+	// their sweeps together do not oversubscribe the CPUs.
+	SweepWorkers int
+}
+
 // Run executes a workflow file (relative to repo root unless absolute).
 func (e *Executor) Run(workflowPath string) (map[string]map[string]any, error) {
+	return e.RunWithOptions(workflowPath, RunOptions{Priority: fmi.PriorityInteractive})
+}
+
+// RunWithOptions executes a workflow file with the given execution options.
+func (e *Executor) RunWithOptions(workflowPath string, opts RunOptions) (map[string]map[string]any, error) {
+	if opts.WallBudget != nil && *opts.WallBudget <= 0 {
+		return nil, fmt.Errorf("wall budget must be positive")
+	}
 	absPath, err := e.resolveRepoPath(workflowPath, "workflow")
 	if err != nil {
 		return nil, fmt.Errorf("invalid workflow path: %w", err)
@@ -98,6 +145,16 @@ func (e *Executor) Run(workflowPath string) (map[string]map[string]any, error) {
 		if _, exists := results[step.Name]; exists {
 			return nil, fmt.Errorf("workflow step %s defined multiple times", step.Name)
 		}
+		if step.Op != "" {
+			result, err := e.runOperatorStep(step, results)
+			if err != nil {
+				return nil, fmt.Errorf("step %s failed: %w", step.Name, err)
+			}
+			if err := e.storeResult(step, result, results); err != nil {
+				return nil, err
+			}
+			continue
+		}
 		if step.FMU == "" {
 			return nil, fmt.Errorf("step %s is missing its fmu path", step.Name)
 		}
@@ -109,16 +166,33 @@ func (e *Executor) Run(workflowPath string) (map[string]map[string]any, error) {
 		if _, err := os.Stat(fmuPath); err != nil {
 			return nil, fmt.Errorf("step %s references missing FMU %s: %w", step.Name, fmuPath, err)
 		}
+		if err := checkCoalesceSteps(step); err != nil {
+			return nil, fmt.Errorf("step %s %w", step.Name, err)
+		}
 
-		startVals, err := e.buildStartValues(step, results)
+		sweep, err := buildSweep(step, results, e.maxSweepMembers)
 		if err != nil {
-			return nil, fmt.Errorf("step %s start values invalid: %w", step.Name, err)
+			return nil, fmt.Errorf("step %s sweep invalid: %w", step.Name, err)
+		}
+		var startVals map[string]fmi.StartValue
+		if sweep == nil {
+			startVals, err = e.buildStartValues(step, results)
+			if err != nil {
+				return nil, fmt.Errorf("step %s start values invalid: %w", step.Name, err)
+			}
 		}
 
 		inputSeries, err := e.buildInputSeries(step)
 		if err != nil {
 			return nil, fmt.Errorf("step %s input series invalid: %w", step.Name, err)
 		}
+		live, err := e.buildLiveConfig(step)
+		if err != nil {
+			if inputSeries != nil && inputSeries.Cleanup != nil {
+				inputSeries.Cleanup()
+			}
+			return nil, fmt.Errorf("step %s live input invalid: %w", step.Name, err)
+		}
 		trace, err := e.buildTraceConfig(step)
 		if err != nil {
 			return nil, fmt.Errorf("step %s trace config invalid: %w", step.Name, err)
@@ -128,10 +202,14 @@ func (e *Executor) Run(workflowPath string) (map[string]map[string]any, error) {
 			FMUPath:     fmuPath,
 			StartValues: startVals,
 			Outputs:     step.Outputs,
+			OutputsAt:   step.OutputsAt,
 			Trace:       trace,
+			Priority:    opts.Priority,
+			WallBudget:  opts.WallBudget,
+			Live:        live,
 		}
 		if inputSeries != nil {
-			cfg.InputSeries = inputSeries.Config
+			cfg.InputSeries = inputSeries.Configs
 		}
 		if step.StartTime != nil {
 			cfg.StartTime = step.StartTime
@@ -142,8 +220,23 @@ func (e *Executor) Run(workflowPath string) (map[string]map[string]any, error) {
 		if step.StepSize != nil {
 			cfg.StepSize = step.StepSize
 		}
+		if step.WallBudget != nil {
+			if *step.WallBudget <= 0 {
+				return nil, fmt.Errorf("step %s wall_budget must be positive", step.Name)
+			}
+			cfg.WallBudget = step.WallBudget
+		}
+		if step.CoalesceSteps {
+			cfg.CoalesceSteps = true
+			cfg.MaxStep = step.MaxStep
+		}
 
-		result, err := fmi.Run(cfg)
+		var result map[string]any
+		if sweep != nil {
+			result, err = e.runSweep(step, cfg, sweep, results, opts.SweepWorkers)
+		} else {
+			result, err = e.runStep(cfg)
+		}
 		if inputSeries != nil && inputSeries.Cleanup != nil {
 			inputSeries.Cleanup()
 		}
@@ -151,22 +244,31 @@ func (e *Executor) Run(workflowPath string) (map[string]map[string]any, error) {
 			return nil, fmt.Errorf("step %s failed: %w", step.Name, err)
 		}
 
-		results[step.Name] = result
-		if step.ResultPath != "" {
-			resultPath, err := e.resolveRepoPath(step.ResultPath, "result")
-			if err != nil {
-				return nil, fmt.Errorf("step %s invalid result path: %w", step.Name, err)
-			}
-			if err := writeResultFile(resultPath, result); err != nil {
-				return nil, fmt.Errorf("write result for step %s: %w", step.Name, err)
-			}
+		if err := e.storeResult(step, result, results); err != nil {
+			return nil, err
 		}
-		e.logf("[workflow] Step %s completed. Outputs: %v", step.Name, result)
 	}
 
 	return results, nil
 }
 
+// storeResult records a finished step's result for later steps and writes it
+// to the step's result file, if any.
+func (e *Executor) storeResult(step workflowStep, result map[string]any, results map[string]map[string]any) error {
+	results[step.Name] = result
+	if step.ResultPath != "" {
+		resultPath, err := e.resolveRepoPath(step.ResultPath, "result")
+		if err != nil {
+			return fmt.Errorf("step %s invalid result path: %w", step.Name, err)
+		}
+		if err := writeResultFile(resultPath, result); err != nil {
+			return fmt.Errorf("write result for step %s: %w", step.Name, err)
+		}
+	}
+	e.logf("[workflow] Step %s completed. Outputs: %v", step.Name, result)
+	return nil
+}
+
 func (e *Executor) logf(format string, args ...any) {
 	if e.logger != nil {
 		e.logger(format, args...)
@@ -203,19 +305,63 @@ type workflowStep struct {
 	Name        string            `yaml:"name"`
 	FMU         string            `yaml:"fmu"`
 	Outputs     []string          `yaml:"outputs"`
+	OutputsAt   []float64         `yaml:"outputs_at"`
 	StartTime   *float64          `yaml:"start_time"`
 	StopTime    *float64          `yaml:"stop_time"`
 	StepSize    *float64          `yaml:"step_size"`
+	WallBudget  *float64          `yaml:"wall_budget"`
 	ResultPath  string            `yaml:"result"`
 	StartValues map[string]any    `yaml:"start_values"`
 	StartFrom   map[string]string `yaml:"start_from"`
 	InputSeries *inputSeriesSpec  `yaml:"input_series"`
+	Inputs      []inputSeriesSpec `yaml:"inputs"`
+	Live        *liveSpec         `yaml:"live"`
 	Trace       *traceSpec        `yaml:"trace"`
+	// CoalesceSteps asks final-value-only steps to advance by MaxStep (or
+	// the whole horizon) per do_step.
+	CoalesceSteps bool     `yaml:"coalesce_steps"`
+	MaxStep       *float64 `yaml:"max_step"`
+	// SweepMode combines swept start_values: "cartesian" (default) or "zip".
+	SweepMode string `yaml:"sweep_mode"`
+	// SweepInterleave is how many members each batch worker keeps in flight;
+	// values above 1 suit sweeps of many short runs.
+	SweepInterleave int `yaml:"sweep_interleave"`
+	operatorSpec    `yaml:",inline"`
+}
+
+// operatorSpec holds the fields of op steps, which run a built-in operator
+// instead of an FMU over a trace signal of an earlier step (source:
+// step.signal) or over an input_series that applies one column.
+type operatorSpec struct {
+	Op       string   `yaml:"op"`
+	Source   string   `yaml:"source"`
+	Window   *float64 `yaml:"window"`
+	Interval *float64 `yaml:"interval"`
+	Quantile *float64 `yaml:"quantile"`
+	Factor   *float64 `yaml:"factor"`
+	Offset   *float64 `yaml:"offset"`
+	Level    *float64 `yaml:"level"`
 }
 
 type inputSeriesSpec struct {
-	CSV string             `yaml:"csv"`
-	S3  *s3InputSeriesSpec `yaml:"s3"`
+	CSV           string             `yaml:"csv"`
+	S3            *s3InputSeriesSpec `yaml:"s3"`
+	Dialect       string             `yaml:"dialect"`
+	Columns       map[string]string  `yaml:"columns"`
+	Ignore        []string           `yaml:"ignore"`
+	Interpolation string             `yaml:"interpolation"`
+	Fields        []string           `yaml:"fields"`
+}
+
+type liveSpec struct {
+	Input   string            `yaml:"input"`
+	Output  string            `yaml:"output"`
+	Format  string            `yaml:"format"`
+	Columns map[string]string `yaml:"columns"`
+	Fields  []string          `yaml:"fields"`
+	Queue   int               `yaml:"queue"`
+	MaxGap  *float64          `yaml:"max_gap"`
+	OnGap   string            `yaml:"on_gap"`
 }
 
 type s3InputSeriesSpec struct {
@@ -295,8 +441,8 @@ func normalizeSyntheticCaseValue(value any) (any, error) {
 	}
 }
 
-func (e *Executor) buildStartValues(step workflowStep, results map[string]map[string]any) (map[string]string, error) {
-	values := make(map[string]string)
+func (e *Executor) buildStartValues(step workflowStep, results map[string]map[string]any) (map[string]fmi.StartValue, error) {
+	values := make(map[string]fmi.StartValue)
 	if len(step.StartValues) > 0 {
 		keys := make([]string, 0, len(step.StartValues))
 		for key := range step.StartValues {
@@ -304,67 +450,247 @@ func (e *Executor) buildStartValues(step workflowStep, results map[string]map[st
 		}
 		sort.Strings(keys)
 		for _, key := range keys {
-			encoded, err := encodeScalar(step.StartValues[key])
+			if isSweepValue(step.StartValues[key]) {
+				continue
+			}
+			value, err := startValueOf(step.StartValues[key])
 			if err != nil {
 				return nil, fmt.Errorf("start_values[%s]: %w", key, err)
 			}
-			values[key] = encoded
+			values[key] = value
 		}
 	}
 
 	for target, reference := range step.StartFrom {
-		stepName, variable, ok := strings.Cut(reference, ".")
-		if !ok || stepName == "" || variable == "" {
-			return nil, fmt.Errorf("start_from[%s] must use format step.variable", target)
-		}
-		stepResult, exists := results[stepName]
-		if !exists {
-			return nil, fmt.Errorf("start_from[%s] references unknown step %s", target, stepName)
-		}
-		value, ok := stepResult[variable]
-		if !ok {
-			return nil, fmt.Errorf("start_from[%s] missing variable %s in step %s", target, variable, stepName)
+		value, err := startFromValue(reference, results)
+		if err != nil {
+			return nil, fmt.Errorf("start_from[%s] %w", target, err)
 		}
-		encoded, err := encodeScalar(value)
+		typed, err := startValueOf(value)
 		if err != nil {
 			return nil, fmt.Errorf("start_from[%s]: %w", target, err)
 		}
-		values[target] = encoded
+		values[target] = typed
 	}
 
 	return values, nil
 }
 
+// startFromValue resolves a start_from entry. A plain step.variable is copied
+// as is; anything else is compiled as an expression (see startExpr) and
+// evaluated against the results so far.
+func startFromValue(reference string, results map[string]map[string]any) (any, error) {
+	if stepName, variable, ok := strings.Cut(reference, "."); ok {
+		if value, ok := results[stepName][variable]; ok {
+			return value, nil
+		}
+	}
+	expr, err := compiledStartExpr(reference)
+	if err != nil {
+		return nil, err
+	}
+	if ref, ok := expr.reference(); ok {
+		if _, exists := results[ref.step]; !exists {
+			return nil, fmt.Errorf("references unknown step %s", ref.step)
+		}
+		return nil, fmt.Errorf("missing variable %s in step %s", ref.variable, ref.step)
+	}
+	return expr.eval(results)
+}
+
 type resolvedInputSeries struct {
-	Config  *fmi.InputSeriesConfig
+	Configs []fmi.InputSeriesConfig
 	Cleanup func()
 }
 
+// buildInputSeries resolves the step's input_series followed by its inputs
+// list. The bridge merges them by time while the step runs.
 func (e *Executor) buildInputSeries(step workflowStep) (*resolvedInputSeries, error) {
-	if step.InputSeries == nil {
+	specs := make([]inputSeriesSpec, 0, len(step.Inputs)+1)
+	labels := make([]string, 0, cap(specs))
+	if step.InputSeries != nil {
+		specs = append(specs, *step.InputSeries)
+		labels = append(labels, "input_series")
+	}
+	for i, spec := range step.Inputs {
+		specs = append(specs, spec)
+		labels = append(labels, fmt.Sprintf("inputs[%d]", i))
+	}
+	if len(specs) == 0 {
 		return nil, nil
 	}
 
-	hasCSV := strings.TrimSpace(step.InputSeries.CSV) != ""
-	hasS3 := step.InputSeries.S3 != nil
+	combined := &resolvedInputSeries{}
+	var cleanups []func()
+	combined.Cleanup = func() {
+		for _, cleanup := range cleanups {
+			cleanup()
+		}
+	}
+	for i, spec := range specs {
+		resolved, err := e.resolveInputSeries(spec)
+		if err != nil {
+			combined.Cleanup()
+			if len(specs) > 1 {
+				return nil, fmt.Errorf("%s: %w", labels[i], err)
+			}
+			return nil, err
+		}
+		combined.Configs = append(combined.Configs, resolved.Configs...)
+		if resolved.Cleanup != nil {
+			cleanups = append(cleanups, resolved.Cleanup)
+		}
+	}
+	return combined, nil
+}
+
+func (e *Executor) resolveInputSeries(spec inputSeriesSpec) (*resolvedInputSeries, error) {
+	dialect, err := fmi.ParseInputDialect(spec.Dialect)
+	if err != nil {
+		return nil, err
+	}
+	interpolation, err := fmi.ParseInputInterpolation(spec.Interpolation)
+	if err != nil {
+		return nil, err
+	}
+	for column, variable := range spec.Columns {
+		if strings.TrimSpace(column) == "" || strings.TrimSpace(variable) == "" {
+			return nil, fmt.Errorf("columns entries must map a CSV column to an FMU variable")
+		}
+	}
+	if dialect == fmi.InputDialectAE && len(spec.Columns) == 0 {
+		return nil, fmt.Errorf("dialect ae requires a columns map")
+	}
+	if (dialect == fmi.InputDialectPgCopy) != (len(spec.Fields) > 0) {
+		return nil, fmt.Errorf("fields are required with, and only allowed for, dialect pgcopy")
+	}
+	fields := make([]fmi.InputField, 0, len(spec.Fields))
+	for _, value := range spec.Fields {
+		field, err := fmi.ParseInputField(value)
+		if err != nil {
+			return nil, err
+		}
+		fields = append(fields, field)
+	}
+	for _, column := range spec.Ignore {
+		if _, mapped := spec.Columns[column]; mapped {
+			return nil, fmt.Errorf("column %q is both mapped and ignored", column)
+		}
+	}
 
+	hasCSV := strings.TrimSpace(spec.CSV) != ""
+	hasS3 := spec.S3 != nil
+
+	var resolved *resolvedInputSeries
 	switch {
 	case hasCSV && hasS3:
 		return nil, fmt.Errorf("input_series must define exactly one source")
 	case hasCSV:
-		csvPath, err := e.resolveRepoPath(step.InputSeries.CSV, "input series")
+		csvPath, err := e.resolveRepoPath(spec.CSV, "input series")
 		if err != nil {
 			return nil, err
 		}
 		if _, err := os.Stat(csvPath); err != nil {
 			return nil, fmt.Errorf("missing CSV %s: %w", csvPath, err)
 		}
-		return &resolvedInputSeries{Config: &fmi.InputSeriesConfig{CSVPath: csvPath}}, nil
+		resolved = &resolvedInputSeries{Configs: []fmi.InputSeriesConfig{{CSVPath: csvPath}}}
 	case hasS3:
-		return e.buildS3InputSeries(*step.InputSeries.S3)
+		resolved, err = e.buildS3InputSeries(*spec.S3)
+		if err != nil {
+			return nil, err
+		}
 	default:
 		return nil, fmt.Errorf("input_series.csv or input_series.s3 is required")
 	}
+	resolved.Configs[0].Dialect = dialect
+	resolved.Configs[0].Columns = spec.Columns
+	resolved.Configs[0].Ignore = spec.Ignore
+	resolved.Configs[0].Interpolation = interpolation
+	if len(fields) > 0 {
+		resolved.Configs[0].Fields = fields
+	}
+	return resolved, nil
+}
+
+// buildLiveConfig resolves the step's live spec. Absolute endpoint paths are
+// used as given, since FIFOs and sockets usually live outside the repository;
+// relative ones resolve against the repository root.
+func (e *Executor) buildLiveConfig(step workflowStep) (*fmi.LiveConfig, error) {
+	spec := step.Live
+	if spec == nil {
+		return nil, nil
+	}
+	if step.InputSeries != nil || len(step.Inputs) > 0 {
+		return nil, fmt.Errorf("live cannot be combined with input_series or inputs")
+	}
+	format, err := fmi.ParseLiveFormat(spec.Format)
+	if err != nil {
+		return nil, err
+	}
+	onGap, err := fmi.ParseLiveGapPolicy(spec.OnGap)
+	if err != nil {
+		return nil, err
+	}
+	if format == fmi.LiveFormatBinary && len(spec.Fields) < 2 {
+		return nil, fmt.Errorf("format binary requires fields, time first")
+	}
+	for column, variable := range spec.Columns {
+		if strings.TrimSpace(column) == "" || strings.TrimSpace(variable) == "" {
+			return nil, fmt.Errorf("columns entries must map a field to an FMU variable")
+		}
+	}
+	if spec.Queue < 0 {
+		return nil, fmt.Errorf("queue must not be negative")
+	}
+	if spec.MaxGap != nil && *spec.MaxGap <= 0 {
+		return nil, fmt.Errorf("max_gap must be positive")
+	}
+
+	endpoint := func(path, kind string) (string, error) {
+		if filepath.IsAbs(path) {
+			return filepath.Clean(path), nil
+		}
+		return e.resolveRepoPath(path, kind)
+	}
+	if strings.TrimSpace(spec.Input) == "" {
+		return nil, fmt.Errorf("live.input is required")
+	}
+	input, err := endpoint(spec.Input, "live input")
+	if err != nil {
+		return nil, err
+	}
+	live := &fmi.LiveConfig{
+		InputPath:  input,
+		Format:     format,
+		Columns:    spec.Columns,
+		Fields:     spec.Fields,
+		QueueDepth: spec.Queue,
+		MaxGap:     spec.MaxGap,
+		OnGap:      onGap,
+	}
+	if strings.TrimSpace(spec.Output) != "" {
+		if live.OutputPath, err = endpoint(spec.Output, "live output"); err != nil {
+			return nil, err
+		}
+	}
+	return live, nil
+}
+
+// checkCoalesceSteps rejects coalesce_steps on steps that need intermediate
+// communication points.
+func checkCoalesceSteps(step workflowStep) error {
+	if step.MaxStep != nil {
+		if !step.CoalesceSteps {
+			return fmt.Errorf("max_step requires coalesce_steps")
+		}
+		if *step.MaxStep <= 0 {
+			return fmt.Errorf("max_step must be positive")
+		}
+	}
+	if step.CoalesceSteps && (step.Trace != nil || step.InputSeries != nil || len(step.Inputs) > 0 || step.Live != nil) {
+		return fmt.Errorf("coalesce_steps cannot be combined with trace, input series or live input")
+	}
+	return nil
 }
 
 func (e *Executor) buildTraceConfig(step workflowStep) (*fmi.TraceConfig, error) {
@@ -387,42 +713,46 @@ func (e *Executor) buildTraceConfig(step workflowStep) (*fmi.TraceConfig, error)
 	return trace, nil
 }
 
-func encodeScalar(value any) (string, error) {
+// startValueOf converts a YAML or step result scalar to a typed start value.
+func startValueOf(value any) (fmi.StartValue, error) {
 	switch v := value.(type) {
 	case nil:
-		return "", errors.New("value is null")
+		return fmi.StartValue{}, errors.New("value is null")
 	case bool:
-		if v {
-			return "1", nil
-		}
-		return "0", nil
+		return fmi.BoolValue(v), nil
 	case int:
-		return fmt.Sprintf("%d", v), nil
+		return fmi.IntegerValue(int64(v)), nil
 	case int64:
-		return fmt.Sprintf("%d", v), nil
+		return fmi.IntegerValue(v), nil
 	case int32:
-		return fmt.Sprintf("%d", v), nil
+		return fmi.IntegerValue(int64(v)), nil
 	case uint:
-		return fmt.Sprintf("%d", v), nil
+		return fmi.IntegerValue(int64(v)), nil
 	case uint64:
-		return fmt.Sprintf("%d", v), nil
+		if v > math.MaxInt64 {
+			return fmi.StartValue{}, fmt.Errorf("value %d is out of range", v)
+		}
+		return fmi.IntegerValue(int64(v)), nil
 	case float64:
-		return formatFloat(v), nil
+		return fmi.RealValue(v), nil
 	case float32:
-		return formatFloat(float64(v)), nil
+		return fmi.RealValue(float64(v)), nil
 	case json.Number:
-		return v.String(), nil
+		if i, err := v.Int64(); err == nil {
+			return fmi.IntegerValue(i), nil
+		}
+		f, err := v.Float64()
+		if err != nil {
+			return fmi.StartValue{}, fmt.Errorf("invalid number %s", v)
+		}
+		return fmi.RealValue(f), nil
 	case string:
-		return "", errors.New("string values are not supported by the FMIL runner")
+		return fmi.StringValue(v), nil
 	default:
-		return "", fmt.Errorf("unsupported value type %T", value)
+		return fmi.StartValue{}, fmt.Errorf("unsupported value type %T", value)
 	}
 }
 
-func formatFloat(v float64) string {
-	return fmt.Sprintf("%.9g", v)
-}
-
 func writeResultFile(path string, result map[string]any) error {
 	if err := os.MkdirAll(filepath.Dir(path), 0o755); err != nil {
 		return err
@@ -1,11 +1,16 @@
 package workflow
 
 import (
+	"encoding/json"
 	"errors"
+	"math"
 	"os"
 	"path/filepath"
+	"reflect"
 	"strings"
 	"testing"
+
+	"github.com/norceresearch/cads-fmi-demo/orchestrator/service/internal/fmi"
 )
 
 func TestResolveRepoPathAllowsPathsWithinRoot(t *testing.T) {
@@ -72,13 +77,22 @@ func TestResolveRepoPathRejectsAbsolutePathOutsideRoot(t *testing.T) {
 	}
 }
 
-func TestEncodeScalarRejectsStrings(t *testing.T) {
-	_, err := encodeScalar("demo")
-	if err == nil {
-		t.Fatal("encodeScalar() error = nil, want rejection for string values")
-	}
-	if !strings.Contains(err.Error(), "string values are not supported") {
-		t.Fatalf("encodeScalar() error = %v, want unsupported string message", err)
+func TestStartValueOfKeepsPrecision(t *testing.T) {
+	for _, tc := range []struct {
+		value any
+		want  fmi.StartValue
+	}{
+		{1.0000000001, fmi.RealValue(1.0000000001)},
+		{int64(1) << 60, fmi.IntegerValue(1 << 60)},
+		{json.Number("9007199254740993"), fmi.IntegerValue(9007199254740993)},
+		{json.Number("2.5e-3"), fmi.RealValue(0.0025)},
+		{true, fmi.BoolValue(true)},
+		{"north", fmi.StringValue("north")},
+	} {
+		got, err := startValueOf(tc.value)
+		if err != nil || got != tc.want {
+			t.Fatalf("startValueOf(%v) = %+v, %v; want %+v", tc.value, got, err, tc.want)
+		}
 	}
 }
 
@@ -102,11 +116,177 @@ func TestBuildInputSeriesResolvesCSVWithinRoot(t *testing.T) {
 	if err != nil {
 		t.Fatalf("buildInputSeries() error = %v", err)
 	}
-	if cfg == nil || cfg.Config == nil || cfg.Config.CSVPath != csvPath {
+	if cfg == nil || len(cfg.Configs) != 1 || cfg.Configs[0].CSVPath != csvPath {
 		t.Fatalf("buildInputSeries() = %#v, want CSVPath %q", cfg, csvPath)
 	}
 }
 
+func TestBuildInputSeriesAEDialect(t *testing.T) {
+	root := t.TempDir()
+	exec, err := NewExecutor(root)
+	if err != nil {
+		t.Fatalf("NewExecutor() error = %v", err)
+	}
+	csvPath := filepath.Join(root, "events.csv")
+	if err := os.WriteFile(csvPath, []byte("Sensor type:,AcousticEmission\n\nArrival time,Amplitude\n 0:00:00:01:5,39.4\n"), 0o644); err != nil {
+		t.Fatalf("write csv: %v", err)
+	}
+
+	_, err = exec.buildInputSeries(workflowStep{
+		InputSeries: &inputSeriesSpec{CSV: "events.csv", Dialect: "ae"},
+	})
+	if err == nil || !strings.Contains(err.Error(), "requires a columns map") {
+		t.Fatalf("buildInputSeries() error = %v, want missing columns error", err)
+	}
+
+	cfg, err := exec.buildInputSeries(workflowStep{
+		InputSeries: &inputSeriesSpec{
+			CSV:     "events.csv",
+			Dialect: "AE",
+			Columns: map[string]string{"Amplitude": "amplitude"},
+		},
+	})
+	if err != nil {
+		t.Fatalf("buildInputSeries() error = %v", err)
+	}
+	if cfg.Configs[0].Dialect != fmi.InputDialectAE || cfg.Configs[0].Columns["Amplitude"] != "amplitude" {
+		t.Fatalf("buildInputSeries() = %#v, want AE dialect with Amplitude column", cfg.Configs)
+	}
+}
+
+func TestBuildInputSeriesMergesInputsList(t *testing.T) {
+	root := t.TempDir()
+	exec, err := NewExecutor(root)
+	if err != nil {
+		t.Fatalf("NewExecutor() error = %v", err)
+	}
+	for _, name := range []string{"ch2.csv", "ch6.csv"} {
+		if err := os.WriteFile(filepath.Join(root, name), []byte("time,amp\n0,1\n"), 0o644); err != nil {
+			t.Fatalf("write csv: %v", err)
+		}
+	}
+
+	cfg, err := exec.buildInputSeries(workflowStep{
+		InputSeries: &inputSeriesSpec{CSV: "ch2.csv", Columns: map[string]string{"amp": "amp_ch2"}},
+		Inputs: []inputSeriesSpec{
+			{CSV: "ch6.csv", Columns: map[string]string{"amp": "amp_ch6"}, Interpolation: "linear"},
+		},
+	})
+	if err != nil {
+		t.Fatalf("buildInputSeries() error = %v", err)
+	}
+	if len(cfg.Configs) != 2 || cfg.Configs[0].CSVPath != filepath.Join(root, "ch2.csv") ||
+		cfg.Configs[1].Interpolation != fmi.InputInterpolationLinear {
+		t.Fatalf("buildInputSeries() = %#v, want ch2 then linear ch6", cfg.Configs)
+	}
+
+	_, err = exec.buildInputSeries(workflowStep{
+		InputSeries: &inputSeriesSpec{CSV: "ch2.csv"},
+		Inputs:      []inputSeriesSpec{{CSV: "ch6.csv", Interpolation: "cubic"}},
+	})
+	if err == nil || !strings.Contains(err.Error(), "inputs[0]") {
+		t.Fatalf("buildInputSeries() error = %v, want inputs[0] interpolation error", err)
+	}
+}
+
+func TestBuildInputSeriesPgCopyFields(t *testing.T) {
+	root := t.TempDir()
+	exec, err := NewExecutor(root)
+	if err != nil {
+		t.Fatalf("NewExecutor() error = %v", err)
+	}
+	if err := os.WriteFile(filepath.Join(root, "measurements.pgcopy"), []byte("PGCOPY\n\xff\r\n\x00"), 0o644); err != nil {
+		t.Fatalf("write dump: %v", err)
+	}
+
+	_, err = exec.buildInputSeries(workflowStep{
+		InputSeries: &inputSeriesSpec{CSV: "measurements.pgcopy", Dialect: "pgcopy"},
+	})
+	if err == nil || !strings.Contains(err.Error(), "fields are required") {
+		t.Fatalf("buildInputSeries() error = %v, want missing fields error", err)
+	}
+
+	cfg, err := exec.buildInputSeries(workflowStep{
+		InputSeries: &inputSeriesSpec{
+			CSV:     "measurements.pgcopy",
+			Dialect: "pgcopy",
+			Fields:  []string{"time:timestamptz", "value:float8"},
+			Columns: map[string]string{"value": "u"},
+		},
+	})
+	if err != nil {
+		t.Fatalf("buildInputSeries() error = %v", err)
+	}
+	want := []fmi.InputField{{Name: "time", Type: "timestamptz"}, {Name: "value", Type: "float8"}}
+	if cfg.Configs[0].Dialect != fmi.InputDialectPgCopy || !reflect.DeepEqual(cfg.Configs[0].Fields, want) {
+		t.Fatalf("buildInputSeries() = %#v, want pgcopy fields %v", cfg.Configs[0], want)
+	}
+}
+
+func TestBuildLiveConfig(t *testing.T) {
+	root := t.TempDir()
+	exec, err := NewExecutor(root)
+	if err != nil {
+		t.Fatalf("NewExecutor() error = %v", err)
+	}
+
+	gap := 2.0
+	live, err := exec.buildLiveConfig(workflowStep{
+		Live: &liveSpec{
+			Input:  "/run/cads/sensor.sock",
+			Output: "out/live.jsonl",
+			Format: "binary",
+			Fields: []string{"time", "amplitude"},
+			MaxGap: &gap,
+			OnGap:  "jump",
+		},
+	})
+	if err != nil {
+		t.Fatalf("buildLiveConfig() error = %v", err)
+	}
+	if live.InputPath != "/run/cads/sensor.sock" || live.OutputPath != filepath.Join(root, "out", "live.jsonl") {
+		t.Fatalf("buildLiveConfig() paths = %q, %q", live.InputPath, live.OutputPath)
+	}
+	if live.Format != fmi.LiveFormatBinary || live.OnGap != fmi.LiveGapJump || *live.MaxGap != gap {
+		t.Fatalf("buildLiveConfig() = %#v", live)
+	}
+
+	_, err = exec.buildLiveConfig(workflowStep{Live: &liveSpec{Input: "sensor.fifo", Format: "binary"}})
+	if err == nil || !strings.Contains(err.Error(), "requires fields") {
+		t.Fatalf("buildLiveConfig() error = %v, want missing fields error", err)
+	}
+
+	_, err = exec.buildLiveConfig(workflowStep{
+		Live:        &liveSpec{Input: "sensor.fifo"},
+		InputSeries: &inputSeriesSpec{CSV: "samples.csv"},
+	})
+	if err == nil || !strings.Contains(err.Error(), "cannot be combined") {
+		t.Fatalf("buildLiveConfig() error = %v, want combination error", err)
+	}
+}
+
+func TestBuildInputSeriesRejectsMappedIgnoredColumn(t *testing.T) {
+	root := t.TempDir()
+	exec, err := NewExecutor(root)
+	if err != nil {
+		t.Fatalf("NewExecutor() error = %v", err)
+	}
+	if err := os.WriteFile(filepath.Join(root, "samples.csv"), []byte("time,a,b\n0,1,2\n"), 0o644); err != nil {
+		t.Fatalf("write csv: %v", err)
+	}
+
+	_, err = exec.buildInputSeries(workflowStep{
+		InputSeries: &inputSeriesSpec{
+			CSV:     "samples.csv",
+			Columns: map[string]string{"a": "u"},
+			Ignore:  []string{"a"},
+		},
+	})
+	if err == nil || !strings.Contains(err.Error(), "both mapped and ignored") {
+		t.Fatalf("buildInputSeries() error = %v, want mapped and ignored error", err)
+	}
+}
+
 func TestLoadSyntheticCaseFromRepoFile(t *testing.T) {
 	root := t.TempDir()
 	exec, err := NewExecutor(root)
@@ -160,7 +340,7 @@ func TestBuildInputSeriesDownloadsS3Object(t *testing.T) {
 	if err != nil {
 		t.Fatalf("buildInputSeries() error = %v", err)
 	}
-	if cfg == nil || cfg.Config == nil {
+	if cfg == nil || len(cfg.Configs) != 1 {
 		t.Fatalf("buildInputSeries() = %#v, want resolved config", cfg)
 	}
 	if requested.Bucket != "sensor-data" || requested.Key != "acoustic/latest.csv" {
@@ -169,7 +349,7 @@ func TestBuildInputSeriesDownloadsS3Object(t *testing.T) {
 	if requested.Endpoint != "https://s3.kaizen.internal" || requested.Region != "eu-west-1" || !requested.ForcePathStyle {
 		t.Fatalf("requested = %#v, want endpoint/region/path-style defaults", requested)
 	}
-	data, err := os.ReadFile(cfg.Config.CSVPath)
+	data, err := os.ReadFile(cfg.Configs[0].CSVPath)
 	if err != nil {
 		t.Fatalf("read downloaded CSV: %v", err)
 	}
@@ -177,8 +357,8 @@ func TestBuildInputSeriesDownloadsS3Object(t *testing.T) {
 		t.Fatalf("downloaded CSV = %q, want content written by downloader", string(data))
 	}
 	cfg.Cleanup()
-	if _, err := os.Stat(cfg.Config.CSVPath); !errors.Is(err, os.ErrNotExist) {
-		t.Fatalf("cleanup should remove %s, stat error = %v", cfg.Config.CSVPath, err)
+	if _, err := os.Stat(cfg.Configs[0].CSVPath); !errors.Is(err, os.ErrNotExist) {
+		t.Fatalf("cleanup should remove %s, stat error = %v", cfg.Configs[0].CSVPath, err)
 	}
 }
 
@@ -254,3 +434,182 @@ func TestBuildTraceConfigRequiresSignalsAndPositiveInterval(t *testing.T) {
 		t.Fatalf("buildTraceConfig() error = %v, want positive interval rejection", err)
 	}
 }
+
+func TestRunPassesStringStartValuesToTheBridge(t *testing.T) {
+	root := t.TempDir()
+	if err := os.WriteFile(filepath.Join(root, "Demo.fmu"), []byte("fmu"), 0o644); err != nil {
+		t.Fatalf("write FMU: %v", err)
+	}
+	doc := "steps:\n  - name: demo\n    fmu: Demo.fmu\n    start_values:\n      label: north\n      gain: 2\n"
+	if err := os.WriteFile(filepath.Join(root, "wf.yaml"), []byte(doc), 0o644); err != nil {
+		t.Fatalf("write workflow: %v", err)
+	}
+	exec, err := NewExecutor(root)
+	if err != nil {
+		t.Fatalf("NewExecutor() error = %v", err)
+	}
+	var got map[string]fmi.StartValue
+	exec.runFMU = func(cfg fmi.Config) (map[string]any, error) {
+		got = cfg.StartValues
+		return map[string]any{}, nil
+	}
+
+	if _, err := exec.Run("wf.yaml"); err != nil {
+		t.Fatalf("Run() error = %v", err)
+	}
+	want := map[string]fmi.StartValue{"label": fmi.StringValue("north"), "gain": fmi.IntegerValue(2)}
+	if !reflect.DeepEqual(got, want) {
+		t.Fatalf("start values = %+v, want %+v", got, want)
+	}
+}
+
+func TestRunRejectsNonPositiveWallBudget(t *testing.T) {
+	root := t.TempDir()
+	if err := os.WriteFile(filepath.Join(root, "Demo.fmu"), []byte("fmu"), 0o644); err != nil {
+		t.Fatalf("write FMU: %v", err)
+	}
+	doc := "steps:\n  - name: demo\n    fmu: Demo.fmu\n    wall_budget: 0\n"
+	if err := os.WriteFile(filepath.Join(root, "wf.yaml"), []byte(doc), 0o644); err != nil {
+		t.Fatalf("write workflow: %v", err)
+	}
+	exec, err := NewExecutor(root)
+	if err != nil {
+		t.Fatalf("NewExecutor() error = %v", err)
+	}
+
+	_, err = exec.Run("wf.yaml")
+	if err == nil || !strings.Contains(err.Error(), "wall_budget must be positive") {
+		t.Fatalf("Run() error = %v, want wall_budget validation error", err)
+	}
+
+	negative := -1.0
+	_, err = exec.RunWithOptions("wf.yaml", RunOptions{WallBudget: &negative})
+	if err == nil || !strings.Contains(err.Error(), "wall budget must be positive") {
+		t.Fatalf("RunWithOptions() error = %v, want wall budget validation error", err)
+	}
+}
+
+func TestCheckCoalesceSteps(t *testing.T) {
+	maxStep := 3600.0
+	if err := checkCoalesceSteps(workflowStep{CoalesceSteps: true, MaxStep: &maxStep}); err != nil {
+		t.Fatalf("checkCoalesceSteps() error = %v", err)
+	}
+
+	err := checkCoalesceSteps(workflowStep{MaxStep: &maxStep})
+	if err == nil || !strings.Contains(err.Error(), "max_step requires coalesce_steps") {
+		t.Fatalf("checkCoalesceSteps() error = %v, want coalesce_steps requirement", err)
+	}
+
+	zero := 0.0
+	err = checkCoalesceSteps(workflowStep{CoalesceSteps: true, MaxStep: &zero})
+	if err == nil || !strings.Contains(err.Error(), "max_step must be positive") {
+		t.Fatalf("checkCoalesceSteps() error = %v, want positive max_step", err)
+	}
+
+	err = checkCoalesceSteps(workflowStep{
+		CoalesceSteps: true,
+		Trace:         &traceSpec{Outputs: []string{"y"}},
+	})
+	if err == nil || !strings.Contains(err.Error(), "cannot be combined") {
+		t.Fatalf("checkCoalesceSteps() error = %v, want trace rejection", err)
+	}
+
+	err = checkCoalesceSteps(workflowStep{
+		CoalesceSteps: true,
+		Inputs:        []inputSeriesSpec{{CSV: "in.csv"}},
+	})
+	if err == nil || !strings.Contains(err.Error(), "cannot be combined") {
+		t.Fatalf("checkCoalesceSteps() error = %v, want input series rejection", err)
+	}
+}
+
+func TestBuildOperatorConfig(t *testing.T) {
+	exec, err := NewExecutor(t.TempDir())
+	if err != nil {
+		t.Fatalf("NewExecutor() error = %v", err)
+	}
+	results := map[string]map[string]any{
+		"producer": {
+			"trace": map[string]any{
+				"time": []any{0.0, 1.0, 2.0},
+				"signals": map[string]any{
+					"y":     []any{1.5, 2.5, 3.5},
+					"alarm": []any{false, true, true},
+					"mean":  []any{nil, 2.0, 2.5},
+				},
+			},
+		},
+	}
+
+	window := 60.0
+	cfg, _, err := exec.buildOperatorConfig(workflowStep{
+		operatorSpec: operatorSpec{Op: "rolling_mean", Source: "producer.y", Window: &window},
+	}, results)
+	if err != nil {
+		t.Fatalf("buildOperatorConfig() error = %v", err)
+	}
+	if cfg.Op != fmi.OperatorRollingMean || cfg.Window != 60 || cfg.Factor != 1 {
+		t.Fatalf("buildOperatorConfig() = %+v", cfg)
+	}
+	if len(cfg.Times) != 3 || cfg.Times[2] != 2 || cfg.Values[0] != 1.5 {
+		t.Fatalf("buildOperatorConfig() signal = %v %v", cfg.Times, cfg.Values)
+	}
+
+	cfg, _, err = exec.buildOperatorConfig(workflowStep{
+		operatorSpec: operatorSpec{Op: "scale", Source: "producer.alarm"},
+	}, results)
+	if err != nil || cfg.Values[1] != 1 {
+		t.Fatalf("buildOperatorConfig() boolean source = %+v, %v", cfg, err)
+	}
+
+	cfg, _, err = exec.buildOperatorConfig(workflowStep{
+		operatorSpec: operatorSpec{Op: "rolling_mean", Source: "producer.mean", Window: &window},
+	}, results)
+	if err != nil || !math.IsNaN(cfg.Values[0]) || cfg.Values[2] != 2.5 {
+		t.Fatalf("buildOperatorConfig() source with null samples = %+v, %v", cfg, err)
+	}
+
+	for _, tc := range []struct {
+		spec operatorSpec
+		want string
+	}{
+		{operatorSpec{Op: "median", Source: "producer.y"}, "unknown operator"},
+		{operatorSpec{Op: "rolling_quantile", Source: "producer.y", Window: &window}, "requires quantile"},
+		{operatorSpec{Op: "scale", Source: "producer.z"}, "no traced signal z"},
+		{operatorSpec{Op: "scale", Source: "missing.y"}, "unknown step missing"},
+		{operatorSpec{Op: "scale"}, "require source or input_series"},
+	} {
+		_, _, err := exec.buildOperatorConfig(workflowStep{operatorSpec: tc.spec}, results)
+		if err == nil || !strings.Contains(err.Error(), tc.want) {
+			t.Fatalf("buildOperatorConfig(%+v) error = %v, want %q", tc.spec, err, tc.want)
+		}
+	}
+
+	start := 10.0
+	_, _, err = exec.buildOperatorConfig(workflowStep{
+		StartTime:    &start,
+		operatorSpec: operatorSpec{Op: "scale", Source: "producer.y"},
+	}, results)
+	if err == nil || !strings.Contains(err.Error(), "only with input_series") {
+		t.Fatalf("buildOperatorConfig() error = %v, want start_time rejected for a source", err)
+	}
+
+	source := operatorSpec{Op: "scale", Source: "producer.y"}
+	for _, tc := range []struct {
+		step workflowStep
+		want string
+	}{
+		{workflowStep{Outputs: []string{"y"}, operatorSpec: source}, "cannot set outputs"},
+		{workflowStep{OutputsAt: []float64{1}, operatorSpec: source}, "cannot set outputs_at"},
+		{workflowStep{StartValues: map[string]any{"k": 1.0}, operatorSpec: source}, "cannot set start_values"},
+		{workflowStep{StartFrom: map[string]string{"k": "producer.y"}, operatorSpec: source}, "cannot set start_from"},
+		{workflowStep{CoalesceSteps: true, operatorSpec: source}, "cannot set coalesce_steps"},
+		{workflowStep{SweepMode: "zip", operatorSpec: source}, "cannot set sweep_mode"},
+		{workflowStep{Trace: &traceSpec{}, operatorSpec: source}, "cannot set trace"},
+	} {
+		_, _, err := exec.buildOperatorConfig(tc.step, results)
+		if err == nil || !strings.Contains(err.Error(), tc.want) {
+			t.Fatalf("buildOperatorConfig(%+v) error = %v, want %q", tc.step, err, tc.want)
+		}
+	}
+}
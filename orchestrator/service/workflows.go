@@ -58,12 +58,18 @@ type workflowCatalogFile struct {
 }
 
 type workflowCatalogStep struct {
-	Name        string                      `yaml:"name"`
-	FMU         string                      `yaml:"fmu"`
-	Outputs     []string                    `yaml:"outputs"`
-	StartFrom   map[string]string           `yaml:"start_from"`
-	StartValues map[string]any              `yaml:"start_values"`
-	InputSeries *workflowCatalogInputSeries `yaml:"input_series"`
+	Name        string                       `yaml:"name"`
+	FMU         string                       `yaml:"fmu"`
+	Outputs     []string                     `yaml:"outputs"`
+	StartFrom   map[string]string            `yaml:"start_from"`
+	StartValues map[string]any               `yaml:"start_values"`
+	InputSeries *workflowCatalogInputSeries  `yaml:"input_series"`
+	Inputs      []workflowCatalogInputSeries `yaml:"inputs"`
+	Live        *struct {
+		Input string `yaml:"input"`
+	} `yaml:"live"`
+	// Source is the trace signal an op step reads.
+	Source string `yaml:"source"`
 }
 
 type workflowCatalogInputSeries struct {
@@ -147,7 +153,7 @@ func workflowModelSummaries(steps []workflowCatalogStep) []WorkflowModel {
 			FMU:         strings.TrimSpace(step.FMU),
 			Outputs:     append([]string(nil), step.Outputs...),
 			Parameters:  sortedMapKeys(step.StartValues),
-			InputSeries: workflowInputSeriesLabel(step.InputSeries),
+			InputSeries: workflowInputSeriesLabels(step),
 		}
 
 		inputNames := make([]string, 0, len(step.StartFrom))
@@ -156,16 +162,10 @@ func workflowModelSummaries(steps []workflowCatalogStep) []WorkflowModel {
 		}
 		sort.Strings(inputNames)
 		for _, name := range inputNames {
-			source := strings.TrimSpace(step.StartFrom[name])
-			input := WorkflowModelInput{
-				Name:   name,
-				Source: source,
-			}
-			if sourceStep, sourceOutput, ok := strings.Cut(source, "."); ok {
-				input.SourceStep = sourceStep
-				input.SourceOutput = sourceOutput
-			}
-			model.Inputs = append(model.Inputs, input)
+			model.Inputs = append(model.Inputs, workflowModelInput(name, step.StartFrom[name]))
+		}
+		if source := strings.TrimSpace(step.Source); source != "" {
+			model.Inputs = append(model.Inputs, workflowModelInput("source", source))
 		}
 
 		models = append(models, model)
@@ -173,6 +173,23 @@ func workflowModelSummaries(steps []workflowCatalogStep) []WorkflowModel {
 	return models
 }
 
+func workflowModelInput(name, source string) WorkflowModelInput {
+	source = strings.TrimSpace(source)
+	input := WorkflowModelInput{
+		Name:   name,
+		Source: source,
+	}
+	// start_from expressions keep only the source text.
+	if strings.ContainsAny(source, " +*/%^(),") {
+		return input
+	}
+	if sourceStep, sourceOutput, ok := strings.Cut(source, "."); ok {
+		input.SourceStep = sourceStep
+		input.SourceOutput = sourceOutput
+	}
+	return input
+}
+
 func workflowModelLabel(step workflowCatalogStep) string {
 	base := strings.TrimSpace(step.FMU)
 	if base != "" {
@@ -190,6 +207,24 @@ func workflowModelLabel(step workflowCatalogStep) string {
 	return label
 }
 
+// workflowInputSeriesLabels joins the labels of a step's input_series and
+// inputs entries, or names its live input.
+func workflowInputSeriesLabels(step workflowCatalogStep) string {
+	labels := make([]string, 0, len(step.Inputs)+1)
+	if label := workflowInputSeriesLabel(step.InputSeries); label != "" {
+		labels = append(labels, label)
+	}
+	for i := range step.Inputs {
+		if label := workflowInputSeriesLabel(&step.Inputs[i]); label != "" {
+			labels = append(labels, label)
+		}
+	}
+	if step.Live != nil && strings.TrimSpace(step.Live.Input) != "" {
+		labels = append(labels, "live:"+strings.TrimSpace(step.Live.Input))
+	}
+	return strings.Join(labels, ", ")
+}
+
 func workflowInputSeriesLabel(series *workflowCatalogInputSeries) string {
 	if series == nil {
 		return ""
@@ -1,7 +1,9 @@
 #!/usr/bin/env python3
 """
 Pulls the most recent measurement rows from a TimescaleDB/PostgreSQL instance
-and renders them as a CSV that the Producer FMU already understands.
+and renders them as a CSV that the Producer FMU already understands, or with
+--format binary stores the raw `COPY ... (FORMAT binary)` stream, which the
+runner reads as a `dialect: pgcopy` input series without a text round trip.
 """
 
 from __future__ import annotations
@@ -47,6 +49,13 @@ def parse_args() -> argparse.Namespace:
         default=_env_default("TIMESCALE_VALUE_COLUMN", "value"),
         help="Value column name (default: %(default)s or $TIMESCALE_VALUE_COLUMN).",
     )
+    parser.add_argument(
+        "--format",
+        choices=("csv", "binary"),
+        default=_env_default("TIMESCALE_FORMAT", "csv"),
+        help="csv, or binary for a PostgreSQL binary COPY dump "
+        "(default: %(default)s or $TIMESCALE_FORMAT).",
+    )
     parser.add_argument(
         "--limit",
         type=int,
@@ -112,6 +121,26 @@ def main() -> int:
     value_identifier = sql.Identifier(args.value_column)
 
     print("[timescale] Connecting to database…", file=sys.stderr)
+    if args.format == "binary":
+        try:
+            with psycopg.connect(conninfo, autocommit=True) as conn:
+                size = copy_binary(
+                    conn,
+                    table_sql,
+                    time_identifier,
+                    value_identifier,
+                    args.limit,
+                    args.output,
+                )
+        except Exception as exc:  # pragma: no cover - logged by caller
+            print(f"[timescale] COPY failed: {exc}", file=sys.stderr)
+            return 1
+        print(
+            f"[timescale] Wrote {size} bytes of binary COPY data to {args.output}",
+            file=sys.stderr,
+        )
+        return 0
+
     try:
         with psycopg.connect(conninfo, autocommit=True) as conn:
             rows = fetch_rows(
@@ -198,6 +227,37 @@ def fetch_rows(
     return rows
 
 
+def copy_binary(
+    conn: psycopg.Connection,
+    table_sql: sql.Composed,
+    time_column: sql.Identifier,
+    value_column: sql.Identifier,
+    limit: int,
+    path: str,
+) -> int:
+    """Streams the latest rows, oldest first, as binary COPY into path."""
+    stmt = sql.SQL(
+        "COPY (SELECT {time_col}, {value_col} FROM ("
+        "SELECT {time_col}, {value_col} FROM {table} "
+        "ORDER BY {time_col} DESC LIMIT {limit}"
+        ") AS latest ORDER BY {time_col}) TO STDOUT (FORMAT binary)"
+    ).format(
+        time_col=time_column,
+        value_col=value_column,
+        table=table_sql,
+        limit=sql.Literal(limit),
+    )
+    target = Path(path)
+    target.parent.mkdir(parents=True, exist_ok=True)
+    size = 0
+    with conn.cursor() as cur, target.open("wb") as handle:
+        with cur.copy(stmt) as copy:
+            for chunk in copy:
+                handle.write(chunk)
+                size += len(chunk)
+    return size
+
+
 def write_csv(path: str, rows: Iterable[Tuple[object, object]]) -> None:
     target = Path(path)
     target.parent.mkdir(parents=True, exist_ok=True)